@@ -86,6 +86,18 @@ endif
 # 'y' to set the Alignment Check Enable bit in SCTLR/SCTLR_EL1, 'n' to clear it
 CFG_SCTLR_ALIGNMENT_CHECK ?= n
 
+# Compute the Adler-32 checksum of zlib streams with NEON when inflating
+# compressed early TAs, secure partitions and TAs. Enabled by default on
+# ARM64 and on ARM32 when the core may use VFP/NEON (CFG_WITH_VFP=y).
+ifeq ($(CFG_ARM64_core),y)
+CFG_ZLIB_ARM_NEON ?= y
+else
+CFG_ZLIB_ARM_NEON ?= $(if $(filter y,$(CFG_WITH_VFP)),y,n)
+endif
+ifeq ($(CFG_ZLIB_ARM_NEON),y)
+$(call force,CFG_WITH_VFP,y,required by CFG_ZLIB_ARM_NEON)
+endif
+
 ifeq ($(CFG_CORE_LARGE_PHYS_ADDR),y)
 $(call force,CFG_WITH_LPAE,y)
 endif
@@ -110,6 +122,9 @@ CFG_CORE_UNMAP_CORE_AT_EL0 ?= y
 
 # Initialize PMCR.DP to 1 to prohibit cycle counting in secure state, and
 # save/restore PMCR during world switch.
+ifeq ($(CFG_FAST_SMC_STATS),y)
+$(call force,CFG_SM_NO_CYCLE_COUNTING,n,required by CFG_FAST_SMC_STATS)
+endif
 CFG_SM_NO_CYCLE_COUNTING ?= y
 
 
@@ -204,6 +219,19 @@ core-platform-aflags += $(core_arm32-platform-aflags)
 core-platform-aflags += $(arm32-platform-aflags)
 endif
 
+# Flags for the core sources using NEON intrinsics. Such code must only
+# run between thread_kernel_enable_vfp() and thread_kernel_disable_vfp(),
+# so it's kept in separate files, for instance:
+# cflags-foo_neon_core.c-y += $(core-neon-cflags)
+# cflags-remove-foo_neon_core.c-y += $(core-neon-cflags-remove)
+ifeq ($(CFG_ARM64_core),y)
+core-neon-cflags :=
+core-neon-cflags-remove := $(arm64-platform-cflags-no-hard-float)
+else
+core-neon-cflags := -mfpu=neon -mfloat-abi=softfp
+core-neon-cflags-remove := $(arm32-platform-cflags-no-hard-float)
+endif
+
 # Provide default supported-ta-targets if not set by the platform config
 ifeq (,$(supported-ta-targets))
 supported-ta-targets = ta_arm32
@@ -168,6 +168,42 @@ static void update_payload_2block(struct internal_aes_gcm_state *state,
 	}
 }
 
+#ifdef CFG_HWSUPP_PMULT_64
+static size_t update_payload_4block(struct internal_aes_gcm_state *state,
+				    const struct internal_aes_gcm_key *ek,
+				    uint64_t dg[2], TEE_OperationMode mode,
+				    const void *src, size_t num_blocks,
+				    void *dst)
+{
+	size_t nb = ROUNDDOWN(num_blocks, 4);
+
+	if (!nb)
+		return 0;
+
+	if (mode == TEE_MODE_ENCRYPT) {
+		/*
+		 * The key stream of the first block is already in
+		 * state->buf_cryp, but pmull_gcm_encrypt_4x() encrypts
+		 * its counters itself. Rewind the counter to that block
+		 * and recreate the key stream of the block following the
+		 * processed blocks afterwards.
+		 */
+		internal_aes_gcm_dec_ctr(state);
+		pmull_gcm_encrypt_4x(nb, dg, dst, src, &state->ghash_key,
+				     state->ctr, ek->data, ek->rounds);
+		ce_aes_ecb_encrypt(state->buf_cryp,
+				   (const uint8_t *)state->ctr,
+				   (const uint8_t *)ek->data, ek->rounds, 1, 1);
+		internal_aes_gcm_inc_ctr(state);
+	} else {
+		pmull_gcm_decrypt_4x(nb, dg, dst, src, &state->ghash_key,
+				     state->ctr, ek->data, ek->rounds);
+	}
+
+	return nb;
+}
+#endif /*CFG_HWSUPP_PMULT_64*/
+
 /* Overriding the __weak function */
 void
 internal_aes_gcm_update_payload_blocks(struct internal_aes_gcm_state *state,
@@ -175,13 +211,22 @@ internal_aes_gcm_update_payload_blocks(struct internal_aes_gcm_state *state,
 				       TEE_OperationMode mode, const void *src,
 				       size_t num_blocks, void *dst)
 {
-	size_t nb = ROUNDDOWN(num_blocks, 2);
 	uint32_t vfp_state = 0;
 	uint64_t dg[2] = { 0 };
+	size_t nb = 0;
 
 	get_be_block(dg, state->hash_state);
 	vfp_state = thread_kernel_enable_vfp();
 
+#ifdef CFG_HWSUPP_PMULT_64
+	/* The bulk of the blocks is done with the stitched 4-way kernel */
+	nb = update_payload_4block(state, ek, dg, mode, src, num_blocks, dst);
+	src = (const uint8_t *)src + nb * TEE_AES_BLOCK_SIZE;
+	dst = (uint8_t *)dst + nb * TEE_AES_BLOCK_SIZE;
+	num_blocks -= nb;
+#endif
+	nb = ROUNDDOWN(num_blocks, 2);
+
 	/*
 	 * pmull_gcm_encrypt() and pmull_gcm_decrypt() can only handle
 	 * blocks in multiples of two.
@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2022, Microchip
+ */
+
+/*
+ * AES-GCM for cores with NEON but without Crypto Extensions. The payload
+ * is processed in bulk with the bitsliced AES-CTR from aes_neon_bs.c and
+ * GHASH is done with the vmull.p8 based pmull_ghash_update_p8().
+ */
+
+#include <assert.h>
+#include <crypto/crypto_accel.h>
+#include <crypto/crypto.h>
+#include <crypto/ghash-ce-core.h>
+#include <crypto/internal_aes-gcm.h>
+#include <io.h>
+#include <kernel/thread.h>
+#include <string.h>
+#include <types_ext.h>
+
+static void get_be_block(void *dst, const void *src)
+{
+	uint64_t *d = dst;
+
+	d[1] = get_be64(src);
+	d[0] = get_be64((const uint8_t *)src + 8);
+}
+
+static void put_be_block(void *dst, const void *src)
+{
+	const uint64_t *s = src;
+
+	put_be64(dst, s[1]);
+	put_be64((uint8_t *)dst + 8, s[0]);
+}
+
+static void ghash_reflect(uint64_t h[2], const uint64_t k[2])
+{
+	uint64_t b = get_be64(k);
+	uint64_t a = get_be64(k + 1);
+
+	h[0] = (a << 1) | (b >> 63);
+	h[1] = (b << 1) | (a >> 63);
+	if (b >> 63)
+		h[1] ^= 0xc200000000000000UL;
+}
+
+void internal_aes_gcm_set_key(struct internal_aes_gcm_state *state,
+			      const struct internal_aes_gcm_key *enc_key)
+{
+	uint64_t k[2] = { 0 };
+
+	crypto_aes_enc_block(enc_key->data, sizeof(enc_key->data),
+			     enc_key->rounds, state->ctr, k);
+
+	/* Only h is used by pmull_ghash_update_p8() */
+	ghash_reflect(state->ghash_key.h, k);
+}
+
+void internal_aes_gcm_ghash_update(struct internal_aes_gcm_state *state,
+				   const void *head, const void *data,
+				   size_t num_blocks)
+{
+	uint32_t vfp_state = 0;
+	uint64_t dg[2] = { 0 };
+
+	get_be_block(dg, state->hash_state);
+
+	vfp_state = thread_kernel_enable_vfp();
+
+	pmull_ghash_update_p8(num_blocks, dg, data, &state->ghash_key, head);
+
+	thread_kernel_disable_vfp(vfp_state);
+
+	put_be_block(state->hash_state, dg);
+}
+
+/* Overriding the __weak function */
+void
+internal_aes_gcm_update_payload_blocks(struct internal_aes_gcm_state *state,
+				       const struct internal_aes_gcm_key *ek,
+				       TEE_OperationMode mode, const void *src,
+				       size_t num_blocks, void *dst)
+{
+	static const uint8_t zero[TEE_AES_BLOCK_SIZE] = { 0 };
+	const uint8_t *s = src;
+	uint8_t *d = dst;
+	size_t n = 0;
+
+	assert(!state->buf_pos && num_blocks);
+
+	if (mode == TEE_MODE_DECRYPT) {
+		/* Hash the ciphertext before it's overwritten if in-place */
+		internal_aes_gcm_ghash_update(state, NULL, src, num_blocks);
+		crypto_accel_aes_ctr_be_enc(dst, src, ek->data, ek->rounds,
+					    num_blocks, state->ctr);
+		return;
+	}
+
+	/*
+	 * The first block is encrypted with the key stream already in
+	 * state->buf_cryp, see __gcm_update_payload(). The remaining
+	 * blocks are encrypted in bulk and finally the key stream of the
+	 * block following this payload is saved in state->buf_cryp.
+	 */
+	for (n = 0; n < TEE_AES_BLOCK_SIZE; n++)
+		d[n] = s[n] ^ state->buf_cryp[n];
+	if (num_blocks > 1)
+		crypto_accel_aes_ctr_be_enc(d + TEE_AES_BLOCK_SIZE,
+					    s + TEE_AES_BLOCK_SIZE, ek->data,
+					    ek->rounds, num_blocks - 1,
+					    state->ctr);
+	crypto_accel_aes_ctr_be_enc(state->buf_cryp, zero, ek->data,
+				    ek->rounds, 1, state->ctr);
+
+	internal_aes_gcm_ghash_update(state, NULL, dst, num_blocks);
+}
@@ -0,0 +1,150 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2022, Microchip
+ */
+
+/*
+ * Glue code for the bitsliced NEON AES in aes_neon_bs_core.c. This file
+ * is compiled without access to the FP/SIMD registers, only the
+ * functions in aes_neon_bs_core.c use them.
+ */
+
+#include <assert.h>
+#include <crypto/crypto_accel.h>
+#include <kernel/thread.h>
+#include <string.h>
+#include <types_ext.h>
+#include <utee_defines.h>
+
+#include "aes_neon_bs.h"
+
+TEE_Result crypto_accel_aes_expand_keys(const void *key, size_t key_len,
+					void *enc_key, void *dec_key,
+					size_t expanded_key_len,
+					unsigned int *round_count)
+{
+	unsigned int num_rounds = 0;
+	uint32_t vfp_state = 0;
+	size_t sz = 0;
+
+	if (!key || !enc_key)
+		return TEE_ERROR_BAD_PARAMETERS;
+	if (key_len != 16 && key_len != 24 && key_len != 32)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	num_rounds = 10 + ((key_len / 8) - 2) * 2;
+	sz = (num_rounds + 1) * TEE_AES_BLOCK_SIZE;
+
+	if (expanded_key_len < sz)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	*round_count = num_rounds;
+	memset(enc_key, 0, expanded_key_len);
+
+	vfp_state = thread_kernel_enable_vfp();
+	aes_neon_bs_expand_enc_key(enc_key, key, key_len, num_rounds);
+	thread_kernel_disable_vfp(vfp_state);
+
+	/* The inverse cipher uses the encryption round keys in reverse */
+	if (dec_key) {
+		memset(dec_key, 0, expanded_key_len);
+		memcpy(dec_key, enc_key, sz);
+	}
+
+	return TEE_SUCCESS;
+}
+
+void crypto_accel_aes_ecb_enc(void *out, const void *in, const void *key,
+			      unsigned int round_count,
+			      unsigned int block_count)
+{
+	uint32_t vfp_state = 0;
+
+	assert(out && in && key);
+
+	vfp_state = thread_kernel_enable_vfp();
+	aes_neon_bs_ecb_enc(out, in, key, round_count, block_count);
+	thread_kernel_disable_vfp(vfp_state);
+}
+
+void crypto_accel_aes_ecb_dec(void *out, const void *in, const void *key,
+			      unsigned int round_count,
+			      unsigned int block_count)
+{
+	uint32_t vfp_state = 0;
+
+	assert(out && in && key);
+
+	vfp_state = thread_kernel_enable_vfp();
+	aes_neon_bs_ecb_dec(out, in, key, round_count, block_count);
+	thread_kernel_disable_vfp(vfp_state);
+}
+
+void crypto_accel_aes_cbc_enc(void *out, const void *in, const void *key,
+			      unsigned int round_count,
+			      unsigned int block_count, void *iv)
+{
+	uint32_t vfp_state = 0;
+
+	assert(out && in && key && iv);
+
+	vfp_state = thread_kernel_enable_vfp();
+	aes_neon_bs_cbc_enc(out, in, key, round_count, block_count, iv);
+	thread_kernel_disable_vfp(vfp_state);
+}
+
+void crypto_accel_aes_cbc_dec(void *out, const void *in, const void *key,
+			      unsigned int round_count,
+			      unsigned int block_count, void *iv)
+{
+	uint32_t vfp_state = 0;
+
+	assert(out && in && key && iv);
+
+	vfp_state = thread_kernel_enable_vfp();
+	aes_neon_bs_cbc_dec(out, in, key, round_count, block_count, iv);
+	thread_kernel_disable_vfp(vfp_state);
+}
+
+void crypto_accel_aes_ctr_be_enc(void *out, const void *in, const void *key,
+				 unsigned int round_count,
+				 unsigned int block_count, void *iv)
+{
+	uint32_t vfp_state = 0;
+
+	assert(out && in && key && iv);
+
+	vfp_state = thread_kernel_enable_vfp();
+	aes_neon_bs_ctr_be_enc(out, in, key, round_count, block_count, iv);
+	thread_kernel_disable_vfp(vfp_state);
+}
+
+void crypto_accel_aes_xts_enc(void *out, const void *in, const void *key1,
+			      unsigned int round_count,
+			      unsigned int block_count, const void *key2,
+			      void *tweak)
+{
+	uint32_t vfp_state = 0;
+
+	assert(out && in && key1 && key2 && tweak);
+
+	vfp_state = thread_kernel_enable_vfp();
+	aes_neon_bs_xts_crypt(out, in, key1, round_count, block_count, key2,
+			      tweak, true);
+	thread_kernel_disable_vfp(vfp_state);
+}
+
+void crypto_accel_aes_xts_dec(void *out, const void *in, const void *key1,
+			      unsigned int round_count,
+			      unsigned int block_count, const void *key2,
+			      void *tweak)
+{
+	uint32_t vfp_state = 0;
+
+	assert(out && in && key1 && key2 && tweak);
+
+	vfp_state = thread_kernel_enable_vfp();
+	aes_neon_bs_xts_crypt(out, in, key1, round_count, block_count, key2,
+			      tweak, false);
+	thread_kernel_disable_vfp(vfp_state);
+}
@@ -0,0 +1,37 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2022, Microchip
+ */
+
+#ifndef __AES_NEON_BS_H
+#define __AES_NEON_BS_H
+
+#include <stdbool.h>
+#include <types_ext.h>
+
+/*
+ * Bitsliced AES kernels, see aes_neon_bs_core.c. The round keys @rk are
+ * stored as consecutive blocks in AES byte order, the decryption uses the
+ * encryption round keys. All functions must be called with VFP enabled.
+ */
+void aes_neon_bs_expand_enc_key(uint8_t *rk, const uint8_t *key, size_t key_len,
+				unsigned int round_count);
+void aes_neon_bs_ecb_enc(uint8_t *out, const uint8_t *in, const uint8_t *rk,
+			 unsigned int round_count, size_t block_count);
+void aes_neon_bs_ecb_dec(uint8_t *out, const uint8_t *in, const uint8_t *rk,
+			 unsigned int round_count, size_t block_count);
+void aes_neon_bs_cbc_enc(uint8_t *out, const uint8_t *in, const uint8_t *rk,
+			 unsigned int round_count, size_t block_count,
+			 uint8_t *iv);
+void aes_neon_bs_cbc_dec(uint8_t *out, const uint8_t *in, const uint8_t *rk,
+			 unsigned int round_count, size_t block_count,
+			 uint8_t *iv);
+void aes_neon_bs_ctr_be_enc(uint8_t *out, const uint8_t *in, const uint8_t *rk,
+			    unsigned int round_count, size_t block_count,
+			    uint8_t *ctr);
+/* The tweak is passed in clear and returned encrypted with @rk2 */
+void aes_neon_bs_xts_crypt(uint8_t *out, const uint8_t *in, const uint8_t *rk1,
+			   unsigned int round_count, size_t block_count,
+			   const uint8_t *rk2, uint8_t *tweak, bool encrypt);
+
+#endif /*__AES_NEON_BS_H*/
@@ -0,0 +1,676 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2022, Microchip
+ */
+
+/*
+ * Bitsliced AES for ARM cores with NEON but without Crypto Extensions
+ *
+ * Eight blocks are processed in parallel. Each of the eight 128-bit NEON
+ * registers of the state holds one bit of every byte of the eight
+ * blocks: bit j of byte k in plane i is bit i of byte k of block j. The
+ * bytes of the blocks are kept in row major order so that rotating the
+ * rows of a column in MixColumns is a plain vext.
+ *
+ * SubBytes is the 113 gate circuit by Boyar and Peralta, there are no
+ * table lookups depending on secret data. InvSubBytes reuses the same
+ * circuit with the linear part of the inverse affine transform applied
+ * on both sides.
+ */
+
+#include <arm_neon.h>
+#include <string.h>
+#include <types_ext.h>
+#include <utee_defines.h>
+#include <util.h>
+
+#include "aes_neon_bs.h"
+
+#define AES_BS_BLOCKS	8
+
+struct aes_bs_state {
+	uint8x16_t q[8];
+};
+
+/* Column major (AES byte order) to row major and back */
+static const uint8_t transpose_idx[16] = {
+	0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15,
+};
+
+static const uint8_t shift_rows_idx[16] = {
+	0, 1, 2, 3, 5, 6, 7, 4, 10, 11, 8, 9, 15, 12, 13, 14,
+};
+
+static const uint8_t inv_shift_rows_idx[16] = {
+	0, 1, 2, 3, 7, 4, 5, 6, 10, 11, 8, 9, 13, 14, 15, 12,
+};
+
+static uint8x16_t tbl16(uint8x16_t x, uint8x16_t idx)
+{
+#ifdef __aarch64__
+	return vqtbl1q_u8(x, idx);
+#else
+	uint8x8x2_t t = { { vget_low_u8(x), vget_high_u8(x) } };
+
+	return vcombine_u8(vtbl2_u8(t, vget_low_u8(idx)),
+			   vtbl2_u8(t, vget_high_u8(idx)));
+#endif
+}
+
+#define SWAPMOVE(x, y, n, m) do { \
+		uint8x16_t __t = vandq_u8(veorq_u8(vshrq_n_u8((x), (n)), \
+						   (y)), (m)); \
+		(y) = veorq_u8((y), __t); \
+		(x) = veorq_u8((x), vshlq_n_u8(__t, (n))); \
+	} while (0)
+
+/* Transposes the 8x8 bit matrices at each byte position, an involution */
+static void ortho(struct aes_bs_state *s)
+{
+	uint8x16_t m = vdupq_n_u8(0x55);
+
+	SWAPMOVE(s->q[0], s->q[1], 1, m);
+	SWAPMOVE(s->q[2], s->q[3], 1, m);
+	SWAPMOVE(s->q[4], s->q[5], 1, m);
+	SWAPMOVE(s->q[6], s->q[7], 1, m);
+
+	m = vdupq_n_u8(0x33);
+	SWAPMOVE(s->q[0], s->q[2], 2, m);
+	SWAPMOVE(s->q[1], s->q[3], 2, m);
+	SWAPMOVE(s->q[4], s->q[6], 2, m);
+	SWAPMOVE(s->q[5], s->q[7], 2, m);
+
+	m = vdupq_n_u8(0x0f);
+	SWAPMOVE(s->q[0], s->q[4], 4, m);
+	SWAPMOVE(s->q[1], s->q[5], 4, m);
+	SWAPMOVE(s->q[2], s->q[6], 4, m);
+	SWAPMOVE(s->q[3], s->q[7], 4, m);
+}
+
+static void load_blocks(struct aes_bs_state *s, const uint8_t *in,
+			size_t num_blocks)
+{
+	uint8x16_t idx = vld1q_u8(transpose_idx);
+	size_t n = 0;
+
+	for (n = 0; n < AES_BS_BLOCKS; n++) {
+		if (n < num_blocks)
+			s->q[n] = tbl16(vld1q_u8(in + n * TEE_AES_BLOCK_SIZE),
+					idx);
+		else
+			s->q[n] = vdupq_n_u8(0);
+	}
+	ortho(s);
+}
+
+static void store_blocks(uint8_t *out, struct aes_bs_state *s,
+			 size_t num_blocks)
+{
+	uint8x16_t idx = vld1q_u8(transpose_idx);
+	size_t n = 0;
+
+	ortho(s);
+	for (n = 0; n < num_blocks; n++)
+		vst1q_u8(out + n * TEE_AES_BLOCK_SIZE, tbl16(s->q[n], idx));
+}
+
+/* Expands each bit of @x to a full byte, one plane per bit position */
+static void bytes_to_planes(uint8x16_t q[8], uint8x16_t x)
+{
+	unsigned int i = 0;
+
+	for (i = 0; i < 8; i++)
+		q[i] = vtstq_u8(x, vdupq_n_u8(BIT(i)));
+}
+
+static uint8x16_t planes_to_bytes(const uint8x16_t q[8])
+{
+	uint8x16_t x = vdupq_n_u8(0);
+	unsigned int i = 0;
+
+	for (i = 0; i < 8; i++)
+		x = vorrq_u8(x, vandq_u8(q[i], vdupq_n_u8(BIT(i))));
+
+	return x;
+}
+
+static void add_round_key(struct aes_bs_state *s, const uint8_t *rk)
+{
+	uint8x16_t k[8] = { };
+	unsigned int i = 0;
+
+	bytes_to_planes(k, tbl16(vld1q_u8(rk), vld1q_u8(transpose_idx)));
+	for (i = 0; i < 8; i++)
+		s->q[i] = veorq_u8(s->q[i], k[i]);
+}
+
+static void shift_rows(struct aes_bs_state *s, const uint8_t idx[16])
+{
+	uint8x16_t i = vld1q_u8(idx);
+	unsigned int n = 0;
+
+	for (n = 0; n < 8; n++)
+		s->q[n] = tbl16(s->q[n], i);
+}
+
+#define XOR(a, b)	veorq_u8((a), (b))
+#define AND(a, b)	vandq_u8((a), (b))
+#define XNOR(a, b)	vmvnq_u8(veorq_u8((a), (b)))
+
+/*
+ * Boyar-Peralta S-box circuit, U0 and S0 are the most significant bits
+ * of the input and output.
+ */
+static void sub_bytes(uint8x16_t q[8])
+{
+	uint8x16_t U0 = q[7], U1 = q[6], U2 = q[5], U3 = q[4];
+	uint8x16_t U4 = q[3], U5 = q[2], U6 = q[1], U7 = q[0];
+	uint8x16_t T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13;
+	uint8x16_t T14, T15, T16, T17, T18, T19, T20, T21, T22, T23, T24;
+	uint8x16_t T25, T26, T27;
+	uint8x16_t M1, M2, M3, M4, M5, M6, M7, M8, M9, M10, M11, M12, M13;
+	uint8x16_t M14, M15, M16, M17, M18, M19, M20, M21, M22, M23, M24;
+	uint8x16_t M25, M26, M27, M28, M29, M30, M31, M32, M33, M34, M35;
+	uint8x16_t M36, M37, M38, M39, M40, M41, M42, M43, M44, M45, M46;
+	uint8x16_t M47, M48, M49, M50, M51, M52, M53, M54, M55, M56, M57;
+	uint8x16_t M58, M59, M60, M61, M62, M63;
+	uint8x16_t L0, L1, L2, L3, L4, L5, L6, L7, L8, L9, L10, L11, L12;
+	uint8x16_t L13, L14, L15, L16, L17, L18, L19, L20, L21, L22, L23;
+	uint8x16_t L24, L25, L26, L27, L28, L29;
+
+	/* Top linear transformation */
+	T1 = XOR(U0, U3);
+	T2 = XOR(U0, U5);
+	T3 = XOR(U0, U6);
+	T4 = XOR(U3, U5);
+	T5 = XOR(U4, U6);
+	T6 = XOR(T1, T5);
+	T7 = XOR(U1, U2);
+	T8 = XOR(U7, T6);
+	T9 = XOR(U7, T7);
+	T10 = XOR(T6, T7);
+	T11 = XOR(U1, U5);
+	T12 = XOR(U2, U5);
+	T13 = XOR(T3, T4);
+	T14 = XOR(T6, T11);
+	T15 = XOR(T5, T11);
+	T16 = XOR(T5, T12);
+	T17 = XOR(T9, T16);
+	T18 = XOR(U3, U7);
+	T19 = XOR(T7, T18);
+	T20 = XOR(T1, T19);
+	T21 = XOR(U6, U7);
+	T22 = XOR(T7, T21);
+	T23 = XOR(T2, T22);
+	T24 = XOR(T2, T10);
+	T25 = XOR(T20, T17);
+	T26 = XOR(T3, T16);
+	T27 = XOR(T1, T12);
+
+	/* Non-linear part, inversion in GF(2^8) */
+	M1 = AND(T13, T6);
+	M2 = AND(T23, T8);
+	M3 = XOR(T14, M1);
+	M4 = AND(T19, U7);
+	M5 = XOR(M4, M1);
+	M6 = AND(T3, T16);
+	M7 = AND(T22, T9);
+	M8 = XOR(T26, M6);
+	M9 = AND(T20, T17);
+	M10 = XOR(M9, M6);
+	M11 = AND(T1, T15);
+	M12 = AND(T4, T27);
+	M13 = XOR(M12, M11);
+	M14 = AND(T2, T10);
+	M15 = XOR(M14, M11);
+	M16 = XOR(M3, M2);
+	M17 = XOR(M5, T24);
+	M18 = XOR(M8, M7);
+	M19 = XOR(M10, M15);
+	M20 = XOR(M16, M13);
+	M21 = XOR(M17, M15);
+	M22 = XOR(M18, M13);
+	M23 = XOR(M19, T25);
+	M24 = XOR(M22, M23);
+	M25 = AND(M22, M20);
+	M26 = XOR(M21, M25);
+	M27 = XOR(M20, M21);
+	M28 = XOR(M23, M25);
+	M29 = AND(M28, M27);
+	M30 = AND(M26, M24);
+	M31 = AND(M20, M23);
+	M32 = AND(M27, M31);
+	M33 = XOR(M27, M25);
+	M34 = AND(M21, M22);
+	M35 = AND(M24, M34);
+	M36 = XOR(M24, M25);
+	M37 = XOR(M21, M29);
+	M38 = XOR(M32, M33);
+	M39 = XOR(M23, M30);
+	M40 = XOR(M35, M36);
+	M41 = XOR(M38, M40);
+	M42 = XOR(M37, M39);
+	M43 = XOR(M37, M38);
+	M44 = XOR(M39, M40);
+	M45 = XOR(M42, M41);
+	M46 = AND(M44, T6);
+	M47 = AND(M40, T8);
+	M48 = AND(M39, U7);
+	M49 = AND(M43, T16);
+	M50 = AND(M38, T9);
+	M51 = AND(M37, T17);
+	M52 = AND(M42, T15);
+	M53 = AND(M45, T27);
+	M54 = AND(M41, T10);
+	M55 = AND(M44, T13);
+	M56 = AND(M40, T23);
+	M57 = AND(M39, T19);
+	M58 = AND(M43, T3);
+	M59 = AND(M38, T22);
+	M60 = AND(M37, T20);
+	M61 = AND(M42, T1);
+	M62 = AND(M45, T4);
+	M63 = AND(M41, T2);
+
+	/* Bottom linear transformation */
+	L0 = XOR(M61, M62);
+	L1 = XOR(M50, M56);
+	L2 = XOR(M46, M48);
+	L3 = XOR(M47, M55);
+	L4 = XOR(M54, M58);
+	L5 = XOR(M49, M61);
+	L6 = XOR(M62, L5);
+	L7 = XOR(M46, L3);
+	L8 = XOR(M51, M59);
+	L9 = XOR(M52, M53);
+	L10 = XOR(M53, L4);
+	L11 = XOR(M60, L2);
+	L12 = XOR(M48, M51);
+	L13 = XOR(M50, L0);
+	L14 = XOR(M52, M61);
+	L15 = XOR(M55, L1);
+	L16 = XOR(M56, L0);
+	L17 = XOR(M57, L1);
+	L18 = XOR(M58, L8);
+	L19 = XOR(M63, L4);
+	L20 = XOR(L0, L1);
+	L21 = XOR(L1, L7);
+	L22 = XOR(L3, L12);
+	L23 = XOR(L18, L2);
+	L24 = XOR(L15, L9);
+	L25 = XOR(L6, L10);
+	L26 = XOR(L7, L9);
+	L27 = XOR(L8, L10);
+	L28 = XOR(L11, L14);
+	L29 = XOR(L11, L17);
+
+	q[7] = XOR(L6, L24);
+	q[6] = XNOR(L16, L26);
+	q[5] = XNOR(L19, L28);
+	q[4] = XOR(L6, L21);
+	q[3] = XOR(L20, L22);
+	q[2] = XOR(L25, L29);
+	q[1] = XNOR(L13, L27);
+	q[0] = XNOR(L6, L23);
+}
+
+/*
+ * The linear part of the inverse affine transformation followed by
+ * adding 0x05, that is the inverse affine transformation of x ^ 0x63.
+ */
+static void inv_affine_05(uint8x16_t q[8])
+{
+	uint8x16_t t[8] = { };
+	unsigned int i = 0;
+
+	for (i = 0; i < 8; i++)
+		t[i] = XOR(XOR(q[(i + 2) % 8], q[(i + 5) % 8]), q[(i + 7) % 8]);
+
+	for (i = 0; i < 8; i++)
+		q[i] = t[i];
+	q[0] = vmvnq_u8(q[0]);
+	q[2] = vmvnq_u8(q[2]);
+}
+
+/*
+ * With S(x) = A(x^-1) ^ 0x63 and L the linear part of A^-1:
+ * S^-1(y) = L(S(L(y) ^ 0x05)) ^ 0x05
+ */
+static void inv_sub_bytes(uint8x16_t q[8])
+{
+	inv_affine_05(q);
+	sub_bytes(q);
+	inv_affine_05(q);
+}
+
+/* Multiplication by x in GF(2^8) */
+static void xtime(uint8x16_t d[8], const uint8x16_t a[8])
+{
+	uint8x16_t a7 = a[7];
+
+	d[7] = a[6];
+	d[6] = a[5];
+	d[5] = a[4];
+	d[4] = XOR(a[3], a7);
+	d[3] = XOR(a[2], a7);
+	d[2] = a[1];
+	d[1] = XOR(a[0], a7);
+	d[0] = a7;
+}
+
+/* Rotates the rows of each column, row r is replaced by row r + n */
+static uint8x16_t rot_rows(uint8x16_t x, const int n)
+{
+	switch (n) {
+	case 1:
+		return vextq_u8(x, x, 4);
+	case 2:
+		return vextq_u8(x, x, 8);
+	default:
+		return vextq_u8(x, x, 12);
+	}
+}
+
+/* out = 2 * a + 3 * a1 + a2 + a3 = 2 * (a + a1) + a1 + (a2 + a3) */
+static void mix_columns(struct aes_bs_state *s)
+{
+	uint8x16_t r1[8] = { };
+	uint8x16_t t[8] = { };
+	uint8x16_t t2[8] = { };
+	unsigned int i = 0;
+
+	for (i = 0; i < 8; i++) {
+		r1[i] = rot_rows(s->q[i], 1);
+		t[i] = XOR(s->q[i], r1[i]);
+	}
+	xtime(t2, t);
+	for (i = 0; i < 8; i++)
+		s->q[i] = XOR(XOR(t2[i], r1[i]), rot_rows(t[i], 2));
+}
+
+/*
+ * InvMixColumns is MixColumns preceded by adding 4 * (a + a2) to every
+ * byte a of a column, a2 being the byte two rows away.
+ */
+static void inv_mix_columns(struct aes_bs_state *s)
+{
+	uint8x16_t t[8] = { };
+	uint8x16_t t2[8] = { };
+	unsigned int i = 0;
+
+	for (i = 0; i < 8; i++)
+		t[i] = XOR(s->q[i], rot_rows(s->q[i], 2));
+	xtime(t2, t);
+	xtime(t, t2);
+	for (i = 0; i < 8; i++)
+		s->q[i] = XOR(s->q[i], t[i]);
+
+	mix_columns(s);
+}
+
+static void encrypt_bs(struct aes_bs_state *s, const uint8_t *rk,
+		       unsigned int round_count)
+{
+	unsigned int n = 0;
+
+	add_round_key(s, rk);
+	for (n = 1; n < round_count; n++) {
+		sub_bytes(s->q);
+		shift_rows(s, shift_rows_idx);
+		mix_columns(s);
+		add_round_key(s, rk + n * TEE_AES_BLOCK_SIZE);
+	}
+	sub_bytes(s->q);
+	shift_rows(s, shift_rows_idx);
+	add_round_key(s, rk + round_count * TEE_AES_BLOCK_SIZE);
+}
+
+static void decrypt_bs(struct aes_bs_state *s, const uint8_t *rk,
+		       unsigned int round_count)
+{
+	unsigned int n = 0;
+
+	add_round_key(s, rk + round_count * TEE_AES_BLOCK_SIZE);
+	for (n = round_count - 1; n > 0; n--) {
+		shift_rows(s, inv_shift_rows_idx);
+		inv_sub_bytes(s->q);
+		add_round_key(s, rk + n * TEE_AES_BLOCK_SIZE);
+		inv_mix_columns(s);
+	}
+	shift_rows(s, inv_shift_rows_idx);
+	inv_sub_bytes(s->q);
+	add_round_key(s, rk);
+}
+
+static void sub_word(uint8_t w[4])
+{
+	uint8x16_t q[8] = { };
+	uint8_t b[16] = { };
+
+	memcpy(b, w, 4);
+	bytes_to_planes(q, vld1q_u8(b));
+	sub_bytes(q);
+	vst1q_u8(b, planes_to_bytes(q));
+	memcpy(w, b, 4);
+}
+
+/* The round keys are stored as consecutive blocks in AES byte order */
+void aes_neon_bs_expand_enc_key(uint8_t *rk, const uint8_t *key, size_t key_len,
+				unsigned int round_count)
+{
+	unsigned int nk = key_len / 4;
+	unsigned int nw = (round_count + 1) * 4;
+	uint8_t rcon = 1;
+	uint8_t t[4] = { };
+	unsigned int i = 0;
+	unsigned int j = 0;
+
+	memcpy(rk, key, key_len);
+	for (i = nk; i < nw; i++) {
+		memcpy(t, rk + (i - 1) * 4, sizeof(t));
+		if (!(i % nk)) {
+			uint8_t t0 = t[0];
+
+			t[0] = t[1];
+			t[1] = t[2];
+			t[2] = t[3];
+			t[3] = t0;
+			sub_word(t);
+			t[0] ^= rcon;
+			rcon = (rcon << 1) ^ ((rcon >> 7) * 0x1b);
+		} else if (nk > 6 && (i % nk) == 4) {
+			sub_word(t);
+		}
+		for (j = 0; j < 4; j++)
+			rk[i * 4 + j] = rk[(i - nk) * 4 + j] ^ t[j];
+	}
+}
+
+void aes_neon_bs_ecb_enc(uint8_t *out, const uint8_t *in, const uint8_t *rk,
+			 unsigned int round_count, size_t block_count)
+{
+	struct aes_bs_state s = { };
+	size_t n = 0;
+
+	while (block_count) {
+		n = MIN(block_count, (size_t)AES_BS_BLOCKS);
+		load_blocks(&s, in, n);
+		encrypt_bs(&s, rk, round_count);
+		store_blocks(out, &s, n);
+
+		in += n * TEE_AES_BLOCK_SIZE;
+		out += n * TEE_AES_BLOCK_SIZE;
+		block_count -= n;
+	}
+}
+
+void aes_neon_bs_ecb_dec(uint8_t *out, const uint8_t *in, const uint8_t *rk,
+			 unsigned int round_count, size_t block_count)
+{
+	struct aes_bs_state s = { };
+	size_t n = 0;
+
+	while (block_count) {
+		n = MIN(block_count, (size_t)AES_BS_BLOCKS);
+		load_blocks(&s, in, n);
+		decrypt_bs(&s, rk, round_count);
+		store_blocks(out, &s, n);
+
+		in += n * TEE_AES_BLOCK_SIZE;
+		out += n * TEE_AES_BLOCK_SIZE;
+		block_count -= n;
+	}
+}
+
+/* Only one block at a time can be encrypted, this is not bitslice friendly */
+void aes_neon_bs_cbc_enc(uint8_t *out, const uint8_t *in, const uint8_t *rk,
+			 unsigned int round_count, size_t block_count,
+			 uint8_t *iv)
+{
+	uint8x16_t x = vld1q_u8(iv);
+	uint8_t b[TEE_AES_BLOCK_SIZE] = { };
+	struct aes_bs_state s = { };
+
+	while (block_count) {
+		vst1q_u8(b, veorq_u8(x, vld1q_u8(in)));
+		load_blocks(&s, b, 1);
+		encrypt_bs(&s, rk, round_count);
+		store_blocks(out, &s, 1);
+		x = vld1q_u8(out);
+
+		in += TEE_AES_BLOCK_SIZE;
+		out += TEE_AES_BLOCK_SIZE;
+		block_count--;
+	}
+	vst1q_u8(iv, x);
+}
+
+void aes_neon_bs_cbc_dec(uint8_t *out, const uint8_t *in, const uint8_t *rk,
+			 unsigned int round_count, size_t block_count,
+			 uint8_t *iv)
+{
+	uint8_t b[AES_BS_BLOCKS * TEE_AES_BLOCK_SIZE] = { };
+	uint8x16_t x = vld1q_u8(iv);
+	struct aes_bs_state s = { };
+	uint8x16_t c = { };
+	size_t n = 0;
+	size_t m = 0;
+
+	while (block_count) {
+		n = MIN(block_count, (size_t)AES_BS_BLOCKS);
+		/* Keep the ciphertext in case @out and @in overlap */
+		memcpy(b, in, n * TEE_AES_BLOCK_SIZE);
+		load_blocks(&s, b, n);
+		decrypt_bs(&s, rk, round_count);
+		store_blocks(out, &s, n);
+
+		for (m = 0; m < n; m++) {
+			uint8_t *o = out + m * TEE_AES_BLOCK_SIZE;
+
+			c = vld1q_u8(b + m * TEE_AES_BLOCK_SIZE);
+			vst1q_u8(o, veorq_u8(vld1q_u8(o), x));
+			x = c;
+		}
+
+		in += n * TEE_AES_BLOCK_SIZE;
+		out += n * TEE_AES_BLOCK_SIZE;
+		block_count -= n;
+	}
+	vst1q_u8(iv, x);
+}
+
+static void ctr_inc_be(uint8_t ctr[TEE_AES_BLOCK_SIZE])
+{
+	int n = 0;
+
+	for (n = TEE_AES_BLOCK_SIZE - 1; n >= 0; n--)
+		if (++ctr[n])
+			break;
+}
+
+void aes_neon_bs_ctr_be_enc(uint8_t *out, const uint8_t *in, const uint8_t *rk,
+			    unsigned int round_count, size_t block_count,
+			    uint8_t *ctr)
+{
+	uint8_t ks[AES_BS_BLOCKS * TEE_AES_BLOCK_SIZE] = { };
+	struct aes_bs_state s = { };
+	size_t n = 0;
+	size_t m = 0;
+
+	while (block_count) {
+		n = MIN(block_count, (size_t)AES_BS_BLOCKS);
+		for (m = 0; m < n; m++) {
+			memcpy(ks + m * TEE_AES_BLOCK_SIZE, ctr,
+			       TEE_AES_BLOCK_SIZE);
+			ctr_inc_be(ctr);
+		}
+		load_blocks(&s, ks, n);
+		encrypt_bs(&s, rk, round_count);
+		store_blocks(ks, &s, n);
+
+		for (m = 0; m < n * TEE_AES_BLOCK_SIZE;
+		     m += TEE_AES_BLOCK_SIZE)
+			vst1q_u8(out + m, veorq_u8(vld1q_u8(in + m),
+						   vld1q_u8(ks + m)));
+
+		in += n * TEE_AES_BLOCK_SIZE;
+		out += n * TEE_AES_BLOCK_SIZE;
+		block_count -= n;
+	}
+}
+
+/* Multiplication of the tweak by x in GF(2^128), little endian */
+static void xts_next_tweak(uint8_t t[TEE_AES_BLOCK_SIZE])
+{
+	uint8_t carry = t[TEE_AES_BLOCK_SIZE - 1] >> 7;
+	int n = 0;
+
+	for (n = TEE_AES_BLOCK_SIZE - 1; n > 0; n--)
+		t[n] = (t[n] << 1) | (t[n - 1] >> 7);
+	t[0] = (t[0] << 1) ^ (carry * 0x87);
+}
+
+void aes_neon_bs_xts_crypt(uint8_t *out, const uint8_t *in, const uint8_t *rk1,
+			   unsigned int round_count, size_t block_count,
+			   const uint8_t *rk2, uint8_t *tweak, bool encrypt)
+{
+	uint8_t tw[AES_BS_BLOCKS * TEE_AES_BLOCK_SIZE] = { };
+	uint8_t b[AES_BS_BLOCKS * TEE_AES_BLOCK_SIZE] = { };
+	uint8_t t[TEE_AES_BLOCK_SIZE] = { };
+	struct aes_bs_state s = { };
+	size_t n = 0;
+	size_t m = 0;
+
+	/* The tweak is passed in clear and returned encrypted */
+	load_blocks(&s, tweak, 1);
+	encrypt_bs(&s, rk2, round_count);
+	store_blocks(t, &s, 1);
+
+	while (block_count) {
+		n = MIN(block_count, (size_t)AES_BS_BLOCKS);
+		for (m = 0; m < n * TEE_AES_BLOCK_SIZE;
+		     m += TEE_AES_BLOCK_SIZE) {
+			memcpy(tw + m, t, TEE_AES_BLOCK_SIZE);
+			vst1q_u8(b + m, veorq_u8(vld1q_u8(in + m),
+						 vld1q_u8(t)));
+			xts_next_tweak(t);
+		}
+
+		load_blocks(&s, b, n);
+		if (encrypt)
+			encrypt_bs(&s, rk1, round_count);
+		else
+			decrypt_bs(&s, rk1, round_count);
+		store_blocks(b, &s, n);
+
+		for (m = 0; m < n * TEE_AES_BLOCK_SIZE;
+		     m += TEE_AES_BLOCK_SIZE)
+			vst1q_u8(out + m, veorq_u8(vld1q_u8(b + m),
+						   vld1q_u8(tw + m)));
+
+		in += n * TEE_AES_BLOCK_SIZE;
+		out += n * TEE_AES_BLOCK_SIZE;
+		block_count -= n;
+	}
+	memcpy(tweak, t, sizeof(t));
+}
@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2022, Microchip
+ */
+
+/*
+ * Glue code for the multi-buffer SHA-256 in sha256_mb_neon_core.c. This
+ * file is compiled without access to the FP/SIMD registers, only the
+ * functions in sha256_mb_neon_core.c use them.
+ */
+
+#include <assert.h>
+#include <crypto/crypto_accel.h>
+#include <kernel/thread.h>
+#include <types_ext.h>
+
+#include "sha256_mb_neon.h"
+
+void crypto_accel_sha256_mb_compress(uint32_t state[8][SHA256_MB_NEON_LANES],
+				     const void *src[SHA256_MB_NEON_LANES],
+				     unsigned int block_count)
+{
+	uint32_t vfp_state = 0;
+
+	COMPILE_TIME_ASSERT(CRYPTO_ACCEL_SHA256_MB_LANES ==
+			    SHA256_MB_NEON_LANES);
+
+	vfp_state = thread_kernel_enable_vfp();
+	sha256_mb_neon_compress(state, (const uint8_t **)src, block_count);
+	thread_kernel_disable_vfp(vfp_state);
+}
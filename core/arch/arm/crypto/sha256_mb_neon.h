@@ -0,0 +1,23 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2022, Microchip
+ */
+
+#ifndef __SHA256_MB_NEON_H
+#define __SHA256_MB_NEON_H
+
+#include <types_ext.h>
+
+#define SHA256_MB_NEON_LANES	4
+
+/*
+ * Multi-buffer SHA-256 kernel, see sha256_mb_neon_core.c. Compresses
+ * @block_count blocks of each of the SHA256_MB_NEON_LANES messages in
+ * @src, @state[n] holds word n of the state of all lanes. Must be called
+ * with VFP enabled.
+ */
+void sha256_mb_neon_compress(uint32_t state[8][SHA256_MB_NEON_LANES],
+			     const uint8_t *src[SHA256_MB_NEON_LANES],
+			     unsigned int block_count);
+
+#endif /*__SHA256_MB_NEON_H*/
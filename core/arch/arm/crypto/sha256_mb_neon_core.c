@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2022, Microchip
+ */
+
+/*
+ * Multi-buffer SHA-256 with NEON
+ *
+ * Four independent messages are hashed in parallel, each 32-bit lane of
+ * the NEON registers carries the corresponding word of one message.
+ */
+
+#include <arm_neon.h>
+#include <types_ext.h>
+
+#include "sha256_mb_neon.h"
+
+#define LANES	SHA256_MB_NEON_LANES
+
+static const uint32_t sha256_k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+#define ROR(x, n)	vorrq_u32(vshrq_n_u32((x), (n)), \
+				  vshlq_n_u32((x), 32 - (n)))
+
+#define S0(x)	veorq_u32(veorq_u32(ROR((x), 2), ROR((x), 13)), ROR((x), 22))
+#define S1(x)	veorq_u32(veorq_u32(ROR((x), 6), ROR((x), 11)), ROR((x), 25))
+#define s0(x)	veorq_u32(veorq_u32(ROR((x), 7), ROR((x), 18)), \
+			  vshrq_n_u32((x), 3))
+#define s1(x)	veorq_u32(veorq_u32(ROR((x), 17), ROR((x), 19)), \
+			  vshrq_n_u32((x), 10))
+
+/* Ch(x, y, z) = (x & y) ^ (~x & z) */
+static uint32x4_t ch(uint32x4_t x, uint32x4_t y, uint32x4_t z)
+{
+	return vorrq_u32(vandq_u32(x, y), vbicq_u32(z, x));
+}
+
+/* Maj(x, y, z) = (x & y) ^ (x & z) ^ (y & z) */
+static uint32x4_t maj(uint32x4_t x, uint32x4_t y, uint32x4_t z)
+{
+	return vorrq_u32(vandq_u32(x, y), vandq_u32(z, vorrq_u32(x, y)));
+}
+
+static void transpose(uint32x4_t v[4])
+{
+	uint32x4x2_t t0 = vtrnq_u32(v[0], v[1]);
+	uint32x4x2_t t1 = vtrnq_u32(v[2], v[3]);
+
+	v[0] = vcombine_u32(vget_low_u32(t0.val[0]), vget_low_u32(t1.val[0]));
+	v[1] = vcombine_u32(vget_low_u32(t0.val[1]), vget_low_u32(t1.val[1]));
+	v[2] = vcombine_u32(vget_high_u32(t0.val[0]),
+			    vget_high_u32(t1.val[0]));
+	v[3] = vcombine_u32(vget_high_u32(t0.val[1]),
+			    vget_high_u32(t1.val[1]));
+}
+
+/* Loads one block of each lane, w[n] holds word n of all lanes */
+static void load_block(uint32x4_t w[16], const uint8_t *src[LANES],
+		       size_t offs)
+{
+	size_t n = 0;
+	size_t l = 0;
+
+	for (n = 0; n < 16; n += 4) {
+		for (l = 0; l < LANES; l++)
+			w[n + l] = vreinterpretq_u32_u8(
+				vrev32q_u8(vld1q_u8(src[l] + offs + n * 4)));
+		transpose(w + n);
+	}
+}
+
+void sha256_mb_neon_compress(uint32_t state[8][LANES],
+			     const uint8_t *src[LANES],
+			     unsigned int block_count)
+{
+	uint32x4_t st[8] = { };
+	uint32x4_t v[8] = { };
+	uint32x4_t w[16] = { };
+	uint32x4_t t1 = { };
+	uint32x4_t t2 = { };
+	unsigned int blk = 0;
+	size_t n = 0;
+
+	for (n = 0; n < 8; n++)
+		st[n] = vld1q_u32(state[n]);
+
+	for (blk = 0; blk < block_count; blk++) {
+		load_block(w, src, blk * 64);
+
+		for (n = 0; n < 8; n++)
+			v[n] = st[n];
+
+		for (n = 0; n < 64; n++) {
+			if (n >= 16)
+				w[n & 15] = vaddq_u32(
+					vaddq_u32(w[n & 15],
+						  s1(w[(n - 2) & 15])),
+					vaddq_u32(s0(w[(n - 15) & 15]),
+						  w[(n - 7) & 15]));
+
+			t1 = vaddq_u32(vaddq_u32(v[7], S1(v[4])),
+				       ch(v[4], v[5], v[6]));
+			t1 = vaddq_u32(t1, vaddq_u32(vdupq_n_u32(sha256_k[n]),
+						     w[n & 15]));
+			t2 = vaddq_u32(S0(v[0]), maj(v[0], v[1], v[2]));
+
+			v[7] = v[6];
+			v[6] = v[5];
+			v[5] = v[4];
+			v[4] = vaddq_u32(v[3], t1);
+			v[3] = v[2];
+			v[2] = v[1];
+			v[1] = v[0];
+			v[0] = vaddq_u32(t1, t2);
+		}
+
+		for (n = 0; n < 8; n++)
+			st[n] = vaddq_u32(st[n], v[n]);
+	}
+
+	for (n = 0; n < 8; n++)
+		vst1q_u32(state[n], st[n]);
+}
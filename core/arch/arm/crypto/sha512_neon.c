@@ -0,0 +1,25 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2022, Microchip
+ */
+
+/*
+ * Glue code for the NEON SHA-512 in sha512_neon_core.c. This file is
+ * compiled without access to the FP/SIMD registers, only the functions
+ * in sha512_neon_core.c use them.
+ */
+
+#include <crypto/crypto_accel.h>
+#include <kernel/thread.h>
+
+#include "sha512_neon.h"
+
+void crypto_accel_sha512_compress(uint64_t state[8], const void *src,
+				  unsigned int block_count)
+{
+	uint32_t vfp_state = 0;
+
+	vfp_state = thread_kernel_enable_vfp();
+	sha512_neon_transform(state, src, block_count);
+	thread_kernel_disable_vfp(vfp_state);
+}
@@ -0,0 +1,18 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2022, Microchip
+ */
+
+#ifndef __SHA512_NEON_H
+#define __SHA512_NEON_H
+
+#include <types_ext.h>
+
+/*
+ * SHA-512 kernel, see sha512_neon_core.c. Must be called with VFP
+ * enabled.
+ */
+void sha512_neon_transform(uint64_t state[8], const uint8_t *src,
+			   unsigned int block_count);
+
+#endif /*__SHA512_NEON_H*/
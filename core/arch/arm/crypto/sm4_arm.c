@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2022, Microchip
+ */
+
+/*
+ * SM4 block cipher modes on top of sm4_arm_crypt_blocks(), provided
+ * either by the NEON or the Crypto Extensions implementation. Trailing
+ * blocks not filling a complete group are processed in a bounce buffer.
+ */
+
+#include <crypto/crypto_accel.h>
+#include <kernel/thread.h>
+#include <string.h>
+#include <string_ext.h>
+#include <types_ext.h>
+#include <util.h>
+
+#include "sm4_arm.h"
+
+#define GROUP_SIZE	(SM4_ARM_BLOCKS * SM4_ARM_BLOCK_SIZE)
+
+static void xor_buf(uint8_t *dst, const uint8_t *a, const uint8_t *b,
+		    size_t len)
+{
+	size_t n = 0;
+
+	for (n = 0; n < len; n++)
+		dst[n] = a[n] ^ b[n];
+}
+
+void crypto_accel_sm4_ecb(void *out, const void *in, const uint32_t rk[32],
+			  unsigned int block_count)
+{
+	uint8_t buf[GROUP_SIZE] = { };
+	uint32_t vfp_state = 0;
+	const uint8_t *s = in;
+	uint8_t *d = out;
+	size_t len = 0;
+
+	vfp_state = thread_kernel_enable_vfp();
+
+	for (; block_count >= SM4_ARM_BLOCKS; block_count -= SM4_ARM_BLOCKS) {
+		sm4_arm_crypt_blocks(d, s, rk);
+		s += GROUP_SIZE;
+		d += GROUP_SIZE;
+	}
+	if (block_count) {
+		len = block_count * SM4_ARM_BLOCK_SIZE;
+		memcpy(buf, s, len);
+		sm4_arm_crypt_blocks(buf, buf, rk);
+		memcpy(d, buf, len);
+	}
+
+	thread_kernel_disable_vfp(vfp_state);
+
+	memzero_explicit(buf, sizeof(buf));
+}
+
+void crypto_accel_sm4_cbc_enc(void *out, const void *in,
+			      const uint32_t rk[32], unsigned int block_count,
+			      void *iv)
+{
+	uint8_t buf[GROUP_SIZE] = { };
+	uint32_t vfp_state = 0;
+	const uint8_t *s = in;
+	uint8_t *d = out;
+
+	memcpy(buf, iv, SM4_ARM_BLOCK_SIZE);
+
+	vfp_state = thread_kernel_enable_vfp();
+
+	/* Serial by nature, only the first block of the group is used */
+	for (; block_count; block_count--) {
+		xor_buf(buf, buf, s, SM4_ARM_BLOCK_SIZE);
+		sm4_arm_crypt_blocks(buf, buf, rk);
+		memcpy(d, buf, SM4_ARM_BLOCK_SIZE);
+		s += SM4_ARM_BLOCK_SIZE;
+		d += SM4_ARM_BLOCK_SIZE;
+	}
+
+	thread_kernel_disable_vfp(vfp_state);
+
+	memcpy(iv, buf, SM4_ARM_BLOCK_SIZE);
+	memzero_explicit(buf, sizeof(buf));
+}
+
+void crypto_accel_sm4_cbc_dec(void *out, const void *in,
+			      const uint32_t rk[32], unsigned int block_count,
+			      void *iv)
+{
+	uint8_t c[GROUP_SIZE + SM4_ARM_BLOCK_SIZE] = { };
+	uint8_t p[GROUP_SIZE] = { };
+	uint32_t vfp_state = 0;
+	const uint8_t *s = in;
+	uint8_t *d = out;
+	unsigned int nb = 0;
+	size_t len = 0;
+
+	/* c holds the previous ciphertext block followed by the group */
+	memcpy(c, iv, SM4_ARM_BLOCK_SIZE);
+
+	vfp_state = thread_kernel_enable_vfp();
+
+	while (block_count) {
+		nb = MIN(block_count, (unsigned int)SM4_ARM_BLOCKS);
+		len = nb * SM4_ARM_BLOCK_SIZE;
+		/* Copy the ciphertext before it's overwritten if in-place */
+		memcpy(c + SM4_ARM_BLOCK_SIZE, s, len);
+		sm4_arm_crypt_blocks(p, c + SM4_ARM_BLOCK_SIZE, rk);
+		xor_buf(d, p, c, len);
+		memcpy(c, c + len, SM4_ARM_BLOCK_SIZE);
+
+		block_count -= nb;
+		s += len;
+		d += len;
+	}
+
+	thread_kernel_disable_vfp(vfp_state);
+
+	memcpy(iv, c, SM4_ARM_BLOCK_SIZE);
+	memzero_explicit(p, sizeof(p));
+}
+
+static void ctr_inc(uint8_t ctr[SM4_ARM_BLOCK_SIZE])
+{
+	size_t n = SM4_ARM_BLOCK_SIZE;
+
+	while (n && !++ctr[n - 1])
+		n--;
+}
+
+void crypto_accel_sm4_ctr_be_enc(void *out, const void *in,
+				 const uint32_t rk[32],
+				 unsigned int block_count, void *iv)
+{
+	uint8_t ks[GROUP_SIZE] = { };
+	uint32_t vfp_state = 0;
+	const uint8_t *s = in;
+	uint8_t *d = out;
+	unsigned int nb = 0;
+	size_t len = 0;
+	size_t n = 0;
+
+	vfp_state = thread_kernel_enable_vfp();
+
+	while (block_count) {
+		nb = MIN(block_count, (unsigned int)SM4_ARM_BLOCKS);
+		len = nb * SM4_ARM_BLOCK_SIZE;
+		for (n = 0; n < len; n += SM4_ARM_BLOCK_SIZE) {
+			memcpy(ks + n, iv, SM4_ARM_BLOCK_SIZE);
+			ctr_inc(iv);
+		}
+		sm4_arm_crypt_blocks(ks, ks, rk);
+		xor_buf(d, s, ks, len);
+
+		block_count -= nb;
+		s += len;
+		d += len;
+	}
+
+	thread_kernel_disable_vfp(vfp_state);
+
+	memzero_explicit(ks, sizeof(ks));
+}
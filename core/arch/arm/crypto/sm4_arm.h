@@ -0,0 +1,23 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2022, Microchip
+ */
+
+#ifndef __SM4_ARM_H
+#define __SM4_ARM_H
+
+#include <types_ext.h>
+
+#define SM4_ARM_BLOCK_SIZE	16
+/* Number of blocks processed by each call to sm4_arm_crypt_blocks() */
+#define SM4_ARM_BLOCKS		4
+
+/*
+ * Encrypts the SM4_ARM_BLOCKS blocks at @src into @dst with the round
+ * keys @rk, a decryption is done by passing the round keys in reverse
+ * order. @src and @dst may be equal. Must be called with VFP enabled.
+ */
+void sm4_arm_crypt_blocks(uint8_t dst[], const uint8_t src[],
+			  const uint32_t rk[32]);
+
+#endif /*__SM4_ARM_H*/
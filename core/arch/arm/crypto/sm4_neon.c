@@ -0,0 +1,180 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2022, Microchip
+ */
+
+/*
+ * SM4 with NEON
+ *
+ * Four blocks are processed in parallel, each 32-bit lane of the NEON
+ * registers carries the corresponding word of one block. The S-box is
+ * held in NEON registers and applied with table lookup instructions, so
+ * unlike the generic implementation there are no memory accesses
+ * depending on the key or the data.
+ */
+
+#include <arm_neon.h>
+#include <compiler.h>
+#include <types_ext.h>
+#include <util.h>
+
+#include "sm4_arm.h"
+
+static const uint8_t sm4_sbox[256] __aligned(16) = {
+	0xd6, 0x90, 0xe9, 0xfe, 0xcc, 0xe1, 0x3d, 0xb7,
+	0x16, 0xb6, 0x14, 0xc2, 0x28, 0xfb, 0x2c, 0x05,
+	0x2b, 0x67, 0x9a, 0x76, 0x2a, 0xbe, 0x04, 0xc3,
+	0xaa, 0x44, 0x13, 0x26, 0x49, 0x86, 0x06, 0x99,
+	0x9c, 0x42, 0x50, 0xf4, 0x91, 0xef, 0x98, 0x7a,
+	0x33, 0x54, 0x0b, 0x43, 0xed, 0xcf, 0xac, 0x62,
+	0xe4, 0xb3, 0x1c, 0xa9, 0xc9, 0x08, 0xe8, 0x95,
+	0x80, 0xdf, 0x94, 0xfa, 0x75, 0x8f, 0x3f, 0xa6,
+	0x47, 0x07, 0xa7, 0xfc, 0xf3, 0x73, 0x17, 0xba,
+	0x83, 0x59, 0x3c, 0x19, 0xe6, 0x85, 0x4f, 0xa8,
+	0x68, 0x6b, 0x81, 0xb2, 0x71, 0x64, 0xda, 0x8b,
+	0xf8, 0xeb, 0x0f, 0x4b, 0x70, 0x56, 0x9d, 0x35,
+	0x1e, 0x24, 0x0e, 0x5e, 0x63, 0x58, 0xd1, 0xa2,
+	0x25, 0x22, 0x7c, 0x3b, 0x01, 0x21, 0x78, 0x87,
+	0xd4, 0x00, 0x46, 0x57, 0x9f, 0xd3, 0x27, 0x52,
+	0x4c, 0x36, 0x02, 0xe7, 0xa0, 0xc4, 0xc8, 0x9e,
+	0xea, 0xbf, 0x8a, 0xd2, 0x40, 0xc7, 0x38, 0xb5,
+	0xa3, 0xf7, 0xf2, 0xce, 0xf9, 0x61, 0x15, 0xa1,
+	0xe0, 0xae, 0x5d, 0xa4, 0x9b, 0x34, 0x1a, 0x55,
+	0xad, 0x93, 0x32, 0x30, 0xf5, 0x8c, 0xb1, 0xe3,
+	0x1d, 0xf6, 0xe2, 0x2e, 0x82, 0x66, 0xca, 0x60,
+	0xc0, 0x29, 0x23, 0xab, 0x0d, 0x53, 0x4e, 0x6f,
+	0xd5, 0xdb, 0x37, 0x45, 0xde, 0xfd, 0x8e, 0x2f,
+	0x03, 0xff, 0x6a, 0x72, 0x6d, 0x6c, 0x5b, 0x51,
+	0x8d, 0x1b, 0xaf, 0x92, 0xbb, 0xdd, 0xbc, 0x7f,
+	0x11, 0xd9, 0x5c, 0x41, 0x1f, 0x10, 0x5a, 0xd8,
+	0x0a, 0xc1, 0x31, 0x88, 0xa5, 0xcd, 0x7b, 0xbd,
+	0x2d, 0x74, 0xd0, 0x12, 0xb8, 0xe5, 0xb4, 0xb0,
+	0x89, 0x69, 0x97, 0x4a, 0x0c, 0x96, 0x77, 0x7e,
+	0x65, 0xb9, 0xf1, 0x09, 0xc5, 0x6e, 0xc6, 0x84,
+	0x18, 0xf0, 0x7d, 0xec, 0x3a, 0xdc, 0x4d, 0x20,
+	0x79, 0xee, 0x5f, 0x3e, 0xd7, 0xcb, 0x39, 0x48,
+};
+
+#ifdef __aarch64__
+/* The S-box in four 64 byte tables for TBL/TBX */
+struct sbox {
+	uint8x16x4_t t[4];
+};
+
+static void load_sbox(struct sbox *s)
+{
+	size_t n = 0;
+	size_t m = 0;
+
+	for (n = 0; n < ARRAY_SIZE(s->t); n++)
+		for (m = 0; m < 4; m++)
+			s->t[n].val[m] = vld1q_u8(sm4_sbox + n * 64 + m * 16);
+}
+
+static uint8x16_t sbox_lookup(const struct sbox *s, uint8x16_t x)
+{
+	uint8x16_t r = vqtbl4q_u8(s->t[0], x);
+	size_t n = 0;
+
+	/* Out of range indices leave the destination byte untouched */
+	for (n = 1; n < ARRAY_SIZE(s->t); n++)
+		r = vqtbx4q_u8(r, s->t[n], vsubq_u8(x, vdupq_n_u8(n * 64)));
+
+	return r;
+}
+#else
+/* The S-box in eight 32 byte tables for VTBL/VTBX */
+struct sbox {
+	uint8x8x4_t t[8];
+};
+
+static void load_sbox(struct sbox *s)
+{
+	size_t n = 0;
+	size_t m = 0;
+
+	for (n = 0; n < ARRAY_SIZE(s->t); n++)
+		for (m = 0; m < 4; m++)
+			s->t[n].val[m] = vld1_u8(sm4_sbox + n * 32 + m * 8);
+}
+
+static uint8x8_t sbox_lookup_half(const struct sbox *s, uint8x8_t x)
+{
+	uint8x8_t r = vtbl4_u8(s->t[0], x);
+	size_t n = 0;
+
+	/* Out of range indices leave the destination byte untouched */
+	for (n = 1; n < ARRAY_SIZE(s->t); n++)
+		r = vtbx4_u8(r, s->t[n], vsub_u8(x, vdup_n_u8(n * 32)));
+
+	return r;
+}
+
+static uint8x16_t sbox_lookup(const struct sbox *s, uint8x16_t x)
+{
+	return vcombine_u8(sbox_lookup_half(s, vget_low_u8(x)),
+			   sbox_lookup_half(s, vget_high_u8(x)));
+}
+#endif
+
+#define ROL(x, n)	vorrq_u32(vshlq_n_u32((x), (n)), \
+				  vshrq_n_u32((x), 32 - (n)))
+
+/* The non-linear substitution followed by the linear transform L */
+static uint32x4_t sm4_t(const struct sbox *s, uint32x4_t x)
+{
+	uint32x4_t b = vreinterpretq_u32_u8(sbox_lookup(s,
+						vreinterpretq_u8_u32(x)));
+
+	return veorq_u32(veorq_u32(veorq_u32(b, ROL(b, 2)),
+				   veorq_u32(ROL(b, 10), ROL(b, 18))),
+			 ROL(b, 24));
+}
+
+static void transpose(uint32x4_t v[4])
+{
+	uint32x4x2_t t0 = vtrnq_u32(v[0], v[1]);
+	uint32x4x2_t t1 = vtrnq_u32(v[2], v[3]);
+
+	v[0] = vcombine_u32(vget_low_u32(t0.val[0]), vget_low_u32(t1.val[0]));
+	v[1] = vcombine_u32(vget_low_u32(t0.val[1]), vget_low_u32(t1.val[1]));
+	v[2] = vcombine_u32(vget_high_u32(t0.val[0]),
+			    vget_high_u32(t1.val[0]));
+	v[3] = vcombine_u32(vget_high_u32(t0.val[1]),
+			    vget_high_u32(t1.val[1]));
+}
+
+void sm4_arm_crypt_blocks(uint8_t dst[], const uint8_t src[],
+			  const uint32_t rk[32])
+{
+	struct sbox s = { };
+	uint32x4_t x[4] = { };
+	uint32x4_t t = { };
+	size_t n = 0;
+
+	load_sbox(&s);
+
+	/* x[n] holds word n of all blocks */
+	for (n = 0; n < 4; n++)
+		x[n] = vreinterpretq_u32_u8(vrev32q_u8(
+			vld1q_u8(src + n * SM4_ARM_BLOCK_SIZE)));
+	transpose(x);
+
+	for (n = 0; n < 32; n++) {
+		t = veorq_u32(veorq_u32(x[(n + 1) % 4], x[(n + 2) % 4]),
+			      veorq_u32(x[(n + 3) % 4], vdupq_n_u32(rk[n])));
+		x[n % 4] = veorq_u32(x[n % 4], sm4_t(&s, t));
+	}
+
+	/* The output is the last four words in reverse order */
+	t = x[0];
+	x[0] = x[3];
+	x[3] = t;
+	t = x[1];
+	x[1] = x[2];
+	x[2] = t;
+	transpose(x);
+	for (n = 0; n < 4; n++)
+		vst1q_u8(dst + n * SM4_ARM_BLOCK_SIZE,
+			 vrev32q_u8(vreinterpretq_u8_u32(x[n])));
+}
@@ -2,6 +2,9 @@ ifeq ($(CFG_CRYPTO_WITH_CE),y)
 srcs-$(CFG_ARM64_core) += ghash-ce-core_a64.S
 srcs-$(CFG_ARM32_core) += ghash-ce-core_a32.S
 srcs-y += aes-gcm-ce.c
+ifeq ($(CFG_HWSUPP_PMULT_64),y)
+srcs-$(CFG_ARM64_core) += aes-gcm-ce-stitch_a64.S
+endif
 endif
 
 ifeq ($(CFG_CRYPTO_AES_ARM_CE),y)
@@ -11,6 +14,25 @@ aflags-aes_modes_armv8a_ce_a64.S-y += -DINTERLEAVE=4
 srcs-$(CFG_ARM32_core) += aes_modes_armv8a_ce_a32.S
 endif
 
+ifeq ($(CFG_CRYPTO_AES_ARM_NEON),y)
+srcs-y += aes_neon_bs.c
+srcs-y += aes_neon_bs_core.c
+cflags-aes_neon_bs_core.c-y += $(core-neon-cflags)
+cflags-remove-aes_neon_bs_core.c-y += $(core-neon-cflags-remove)
+ifeq ($(CFG_CRYPTO_GCM),y)
+srcs-$(CFG_ARM64_core) += ghash-ce-core_a64.S
+srcs-$(CFG_ARM32_core) += ghash-ce-core_a32.S
+srcs-y += aes-gcm-neon.c
+endif
+endif
+
+ifeq ($(CFG_CRYPTO_SHA256_ARM_NEON_MB),y)
+srcs-y += sha256_mb_neon.c
+srcs-y += sha256_mb_neon_core.c
+cflags-sha256_mb_neon_core.c-y += $(core-neon-cflags)
+cflags-remove-sha256_mb_neon_core.c-y += $(core-neon-cflags-remove)
+endif
+
 ifeq ($(CFG_CRYPTO_SHA1_ARM_CE),y)
 srcs-y += sha1_armv8a_ce.c
 srcs-$(CFG_ARM64_core) += sha1_armv8a_ce_a64.S
@@ -22,3 +44,27 @@ srcs-y += sha256_armv8a_ce.c
 srcs-$(CFG_ARM64_core) += sha256_armv8a_ce_a64.S
 srcs-$(CFG_ARM32_core) += sha256_armv8a_ce_a32.S
 endif
+
+ifeq ($(CFG_CRYPTO_SHA512_ARM_CE),y)
+srcs-$(CFG_ARM64_core) += sha512_armv8a_ce.c
+srcs-$(CFG_ARM64_core) += sha512_armv8a_ce_a64.S
+endif
+
+ifeq ($(CFG_CRYPTO_SHA512_ARM_NEON),y)
+srcs-y += sha512_neon.c
+srcs-y += sha512_neon_core.c
+cflags-sha512_neon_core.c-y += $(core-neon-cflags)
+cflags-remove-sha512_neon_core.c-y += $(core-neon-cflags-remove)
+endif
+
+ifeq ($(CFG_CRYPTO_SM4_ARM_CE),y)
+srcs-$(CFG_ARM64_core) += sm4_armv8a_ce_a64.S
+endif
+
+ifeq ($(CFG_CRYPTO_SM4_ARM_NEON),y)
+srcs-y += sm4_neon.c
+cflags-sm4_neon.c-y += $(core-neon-cflags)
+cflags-remove-sm4_neon.c-y += $(core-neon-cflags-remove)
+endif
+
+srcs-$(CFG_CORE_CRYPTO_SM4_ACCEL) += sm4_arm.c
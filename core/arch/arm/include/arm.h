@@ -98,6 +98,10 @@
 #define CNTKCTL_PL0PCTEN	BIT(0) /* physical counter el0 access enable */
 #define CNTKCTL_PL0VCTEN	BIT(1) /* virtual counter el0 access enable */
 
+/* Performance Monitors definitions */
+#define PMCR_E			BIT(0)
+#define PMCNTENSET_C		BIT(31)
+
 #ifdef ARM32
 #include <arm32.h>
 #endif
@@ -117,6 +121,34 @@ static inline __noprof uint64_t barrier_read_counter_timer(void)
 #endif
 }
 
+/*
+ * Starts the cycle counter of the calling core unless it's already
+ * running. The Performance Monitors are shared with the normal world
+ * which may stop the counter at any time, so this is done before each
+ * measurement rather than once at boot.
+ */
+static inline __noprof void enable_cycle_counter(void)
+{
+	uint32_t pmcr = read_pmcr();
+
+	if (!(read_pmcntenset() & PMCNTENSET_C))
+		write_pmcntenset(PMCNTENSET_C);
+	if (!(pmcr & PMCR_E))
+		write_pmcr(pmcr | PMCR_E);
+	isb();
+}
+
+/*
+ * Returns the lower 32 bits of the cycle counter, which is all ARM32
+ * provides. Differences of two reads are valid as long as less than
+ * 2^32 cycles elapsed.
+ */
+static inline __noprof uint32_t barrier_read_cycle_counter(void)
+{
+	isb();
+	return read_pmccntr();
+}
+
 static inline bool feat_bti_is_implemented(void)
 {
 #ifdef ARM32
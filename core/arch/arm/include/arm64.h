@@ -341,6 +341,10 @@ DEFINE_REG_READ_FUNC_(cntps_tval, uint32_t, cntps_tval_el1)
 DEFINE_REG_WRITE_FUNC_(cntps_tval, uint32_t, cntps_tval_el1)
 
 DEFINE_REG_READ_FUNC_(pmccntr, uint64_t, pmccntr_el0)
+DEFINE_REG_READ_FUNC_(pmcr, uint32_t, pmcr_el0)
+DEFINE_REG_WRITE_FUNC_(pmcr, uint32_t, pmcr_el0)
+DEFINE_REG_READ_FUNC_(pmcntenset, uint32_t, pmcntenset_el0)
+DEFINE_REG_WRITE_FUNC_(pmcntenset, uint32_t, pmcntenset_el0)
 
 DEFINE_U64_REG_READWRITE_FUNCS(ttbr0_el1)
 DEFINE_U64_REG_READWRITE_FUNCS(ttbr1_el1)
@@ -7,6 +7,7 @@
 #define __GHASH_CE_CORE_H
 
 #include <inttypes.h>
+#include <stddef.h>
 
 struct internal_ghash_key {
 	uint64_t h[2];
@@ -36,6 +37,21 @@ void pmull_gcm_decrypt(int blocks, uint64_t dg[2], uint8_t dst[],
 		       const struct internal_ghash_key *ghash_key,
 		       uint64_t ctr[], const uint64_t rk[], int rounds);
 
+/*
+ * Stitched AES-CTR and GHASH processing four blocks at a time, @blocks
+ * must be a multiple of four. @ctr is the big endian counter of the first
+ * block and is updated to follow the last block. Must be called with
+ * VFP enabled.
+ */
+void pmull_gcm_encrypt_4x(size_t blocks, uint64_t dg[2], uint8_t dst[],
+			  const uint8_t src[],
+			  const struct internal_ghash_key *ghash_key,
+			  uint64_t ctr[], const uint64_t rk[], int rounds);
+void pmull_gcm_decrypt_4x(size_t blocks, uint64_t dg[2], uint8_t dst[],
+			  const uint8_t src[],
+			  const struct internal_ghash_key *ghash_key,
+			  uint64_t ctr[], const uint64_t rk[], int rounds);
+
 uint32_t pmull_gcm_aes_sub(uint32_t input);
 
 void pmull_gcm_encrypt_block(uint8_t dst[], const uint8_t src[], int rounds);
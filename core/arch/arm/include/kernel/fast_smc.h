@@ -0,0 +1,130 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2022, Microchip
+ */
+#ifndef __KERNEL_FAST_SMC_H
+#define __KERNEL_FAST_SMC_H
+
+#include <keep.h>
+#include <kernel/thread.h>
+#include <scattered_array.h>
+#include <tee_api_types.h>
+#include <types_ext.h>
+#include <util.h>
+
+/*
+ * Latency histogram of a fast SMC function. Bucket n counts the calls
+ * which took between 2^(FAST_SMC_HIST_SHIFT + n) and
+ * 2^(FAST_SMC_HIST_SHIFT + n + 1) CPU cycles, the first and last buckets
+ * also count all calls shorter respectively longer than that.
+ */
+#define FAST_SMC_HIST_SHIFT	U(6)
+#define FAST_SMC_HIST_BUCKETS	U(16)
+
+#define FAST_SMC_DESC_LENGTH	32
+
+/*
+ * struct fast_smc_stats - latency statistics of a fast SMC function
+ * @count:	number of calls
+ * @cycles:	accumulated CPU cycles spent in the handler
+ * @min:	fastest call in CPU cycles
+ * @max:	slowest call in CPU cycles
+ * @hist:	latency histogram, see FAST_SMC_HIST_SHIFT
+ */
+struct fast_smc_stats {
+	uint64_t count;
+	uint64_t cycles;
+	uint32_t min;
+	uint32_t max;
+	uint32_t hist[FAST_SMC_HIST_BUCKETS];
+};
+
+/*
+ * struct fast_smc_func - a registered fast SMC function
+ * @func_id:	SMC function ID, for SiP functions only the function number
+ * @name:	name of the function, reported together with the statistics
+ * @handler:	serves the call, updates @args with the result
+ * @stats:	per core statistics
+ */
+struct fast_smc_func {
+	uint32_t func_id;
+	const char *name;
+	void (*handler)(struct thread_smc_args *args);
+#ifdef CFG_FAST_SMC_STATS
+	struct fast_smc_stats *stats;
+#endif
+};
+
+/*
+ * struct fast_smc_report - statistics of one function as reported by
+ * fast_smc_get_stats()
+ * @desc:	name of the function
+ * @func_id:	SMC function ID as registered
+ * @sip:	1 for a platform SiP function, 0 otherwise
+ * @stats:	statistics accumulated over all cores
+ */
+struct fast_smc_report {
+	char desc[FAST_SMC_DESC_LENGTH];
+	uint32_t func_id;
+	uint32_t sip;
+	struct fast_smc_stats stats;
+};
+
+#ifdef CFG_FAST_SMC_STATS
+#define __FAST_SMC_STATS \
+	.stats = (struct fast_smc_stats [CFG_TEE_CORE_NB_CORE]){ },
+#else
+#define __FAST_SMC_STATS
+#endif
+
+/*
+ * SiP functions are served by the platform from the secure monitor where
+ * paging isn't possible, the handlers are kept unpaged.
+ */
+#define __fast_smc_register(array_name, id, fn) \
+	DECLARE_KEEP_PAGER(fn); \
+	SCATTERED_ARRAY_DEFINE_ITEM(array_name, struct fast_smc_func) = { \
+		.func_id = (id), .name = #fn, .handler = (fn), \
+		__FAST_SMC_STATS \
+	}
+
+/*
+ * Registers @fn to serve the OP-TEE fast SMC function @id, see
+ * __tee_entry_fast()
+ */
+#define fast_smc_register(id, fn) __fast_smc_register(fast_smc, (id), fn)
+
+/*
+ * Registers @fn to serve the fast SiP service function number @num
+ * dispatched with sip_smc_dispatch() by the platform
+ */
+#define sip_smc_register(num, fn) __fast_smc_register(sip_smc, (num), fn)
+
+/*
+ * Calls the handler registered with fast_smc_register() matching
+ * @args->a0. Returns false if there's no such handler.
+ */
+bool fast_smc_dispatch(struct thread_smc_args *args);
+
+/*
+ * Calls the handler registered with sip_smc_register() matching the
+ * function number of @args->a0. The caller is expected to have checked
+ * that @args->a0 is a SiP service call. Returns false if there's no such
+ * handler.
+ */
+bool sip_smc_dispatch(struct thread_smc_args *args);
+
+#ifdef CFG_FAST_SMC_STATS
+/*
+ * Fills in @reports with the statistics of all registered functions
+ * @reports:	array of @count elements
+ * @count:	in: number of elements in @reports, out: number of functions
+ * @reset:	if true, clear the statistics once reported
+ *
+ * Returns TEE_ERROR_SHORT_BUFFER if @reports is too small.
+ */
+TEE_Result fast_smc_get_stats(struct fast_smc_report *reports, size_t *count,
+			      bool reset);
+#endif
+
+#endif /*__KERNEL_FAST_SMC_H*/
@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2022, Microchip
+ */
+
+#include <arm.h>
+#include <compiler.h>
+#include <kernel/fast_smc.h>
+#include <kernel/misc.h>
+#include <scattered_array.h>
+#include <sm/optee_smc.h>
+#include <string.h>
+#include <string_ext.h>
+#include <util.h>
+
+#define FAST_SMC_BEGIN(array_name) \
+	SCATTERED_ARRAY_BEGIN(array_name, struct fast_smc_func)
+#define FAST_SMC_END(array_name) \
+	SCATTERED_ARRAY_END(array_name, struct fast_smc_func)
+
+#ifdef CFG_FAST_SMC_STATS
+static unsigned int get_bucket(uint32_t cycles)
+{
+	unsigned int l = 0;
+
+	if (!cycles)
+		return 0;
+
+	l = 31 - __builtin_clz(cycles);
+	if (l < FAST_SMC_HIST_SHIFT)
+		return 0;
+
+	return MIN(l - FAST_SMC_HIST_SHIFT, FAST_SMC_HIST_BUCKETS - 1);
+}
+
+static void update_stats(struct fast_smc_stats *s, uint32_t cycles)
+{
+	if (!s->count || cycles < s->min)
+		s->min = cycles;
+	if (cycles > s->max)
+		s->max = cycles;
+	s->count++;
+	s->cycles += cycles;
+	s->hist[get_bucket(cycles)]++;
+}
+
+/* Fast SMCs are served with all exceptions masked, we stay on this core */
+static void call_handler(const struct fast_smc_func *f,
+			 struct thread_smc_args *args)
+{
+	uint32_t t = 0;
+
+	enable_cycle_counter();
+	t = barrier_read_cycle_counter();
+	f->handler(args);
+	update_stats(f->stats + get_core_pos(),
+		     barrier_read_cycle_counter() - t);
+}
+#else
+static void call_handler(const struct fast_smc_func *f,
+			 struct thread_smc_args *args)
+{
+	f->handler(args);
+}
+#endif
+
+/*
+ * The tables are expected to be small, a dozen or so entries, so a
+ * linear search is about as fast as anything else while it keeps
+ * registration free from any boot time sorting.
+ */
+static bool dispatch(const struct fast_smc_func *begin,
+		     const struct fast_smc_func *end, uint32_t func_id,
+		     struct thread_smc_args *args)
+{
+	const struct fast_smc_func *f = NULL;
+
+	for (f = begin; f < end; f++) {
+		if (f->func_id == func_id) {
+			call_handler(f, args);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool fast_smc_dispatch(struct thread_smc_args *args)
+{
+	return dispatch(FAST_SMC_BEGIN(fast_smc), FAST_SMC_END(fast_smc),
+			args->a0, args);
+}
+
+bool sip_smc_dispatch(struct thread_smc_args *args)
+{
+	return dispatch(FAST_SMC_BEGIN(sip_smc), FAST_SMC_END(sip_smc),
+			OPTEE_SMC_FUNC_NUM(args->a0), args);
+}
+
+#ifdef CFG_FAST_SMC_STATS
+static void get_func_report(struct fast_smc_report *r,
+			    const struct fast_smc_func *f, bool sip,
+			    bool reset)
+{
+	struct fast_smc_stats *s = NULL;
+	size_t n = 0;
+	size_t m = 0;
+
+	memset(r, 0, sizeof(*r));
+	strlcpy(r->desc, f->name, sizeof(r->desc));
+	r->func_id = f->func_id;
+	r->sip = sip;
+
+	for (n = 0; n < CFG_TEE_CORE_NB_CORE; n++) {
+		s = f->stats + n;
+		if (s->count) {
+			if (!r->stats.count || s->min < r->stats.min)
+				r->stats.min = s->min;
+			r->stats.max = MAX(r->stats.max, s->max);
+			r->stats.count += s->count;
+			r->stats.cycles += s->cycles;
+			for (m = 0; m < FAST_SMC_HIST_BUCKETS; m++)
+				r->stats.hist[m] += s->hist[m];
+		}
+		if (reset)
+			memset(s, 0, sizeof(*s));
+	}
+}
+
+TEE_Result fast_smc_get_stats(struct fast_smc_report *reports, size_t *count,
+			      bool reset)
+{
+	const struct fast_smc_func *f = NULL;
+	size_t n = 0;
+
+	n = FAST_SMC_END(fast_smc) - FAST_SMC_BEGIN(fast_smc) +
+	    FAST_SMC_END(sip_smc) - FAST_SMC_BEGIN(sip_smc);
+	if (*count < n) {
+		*count = n;
+		return TEE_ERROR_SHORT_BUFFER;
+	}
+
+	/*
+	 * The statistics are updated by other cores without locking, a
+	 * report may be slightly inconsistent if taken while SMCs are
+	 * being served.
+	 */
+	n = 0;
+	for (f = FAST_SMC_BEGIN(fast_smc); f < FAST_SMC_END(fast_smc); f++)
+		get_func_report(reports + n++, f, false, reset);
+	for (f = FAST_SMC_BEGIN(sip_smc); f < FAST_SMC_END(sip_smc); f++)
+		get_func_report(reports + n++, f, true, reset);
+
+	*count = n;
+	return TEE_SUCCESS;
+}
+#endif /*CFG_FAST_SMC_STATS*/
@@ -34,6 +34,7 @@ static size_t shm_release_waiters;
 struct mobj_reg_shm {
 	struct mobj mobj;
 	SLIST_ENTRY(mobj_reg_shm) next;
+	TAILQ_ENTRY(mobj_reg_shm) idle_link;
 	uint64_t cookie;
 	tee_mm_entry_t *mm;
 	paddr_t page_offset;
@@ -41,6 +42,7 @@ struct mobj_reg_shm {
 	bool guarded;
 	bool releasing;
 	bool release_frees;
+	bool idle;
 	paddr_t pages[];
 };
 
@@ -55,12 +57,43 @@ static size_t mobj_reg_shm_size(size_t nr_pages)
 	return s;
 }
 
-static SLIST_HEAD(reg_shm_head, mobj_reg_shm) reg_shm_list =
-	SLIST_HEAD_INITIALIZER(reg_shm_head);
+/*
+ * Registered shared memory objects are indexed on their cookie in a hash
+ * table since normal world may register thousands of buffers and each
+ * invoke looks up its memory references by cookie.
+ */
+#define REG_SHM_HASH_BITS	8
+
+SLIST_HEAD(reg_shm_head, mobj_reg_shm);
+static struct reg_shm_head reg_shm_hash[BIT(REG_SHM_HASH_BITS)];
+
+/*
+ * Mapped objects with a map count of zero. The mapping is kept until the
+ * object is freed, the virtual address space is needed for another
+ * object, more than REG_SHM_IDLE_MAX objects are idle or the idle
+ * mappings together cover more than CFG_CORE_DYN_SHM_IDLE_VA_SIZE bytes,
+ * least recently used first.
+ */
+#define REG_SHM_IDLE_MAX	64
+
+static TAILQ_HEAD(, mobj_reg_shm) reg_shm_idle_list =
+	TAILQ_HEAD_INITIALIZER(reg_shm_idle_list);
+static size_t reg_shm_idle_count;
+static struct mobj_reg_shm_stats reg_shm_stats;
 
+/* Protects reg_shm_hash and the release fields of struct mobj_reg_shm */
 static unsigned int reg_shm_slist_lock = SPINLOCK_UNLOCK;
+/* Protects reg_shm_idle_list and the mapping fields of struct mobj_reg_shm */
 static unsigned int reg_shm_map_lock = SPINLOCK_UNLOCK;
 
+static struct reg_shm_head *reg_shm_bucket(uint64_t cookie)
+{
+	/* Fibonacci hashing of the folded cookie */
+	uint32_t h = (uint32_t)(cookie ^ (cookie >> 32)) * 0x9e3779b9;
+
+	return reg_shm_hash + (h >> (32 - REG_SHM_HASH_BITS));
+}
+
 static struct mobj_reg_shm *to_mobj_reg_shm(struct mobj *mobj);
 
 static TEE_Result mobj_reg_shm_get_pa(struct mobj *mobj, size_t offst,
@@ -112,13 +145,54 @@ static void *mobj_reg_shm_get_va(struct mobj *mobj, size_t offst, size_t len)
 				 mrs->page_offset);
 }
 
-static void reg_shm_unmap_helper(struct mobj_reg_shm *r)
+static size_t reg_shm_va_size(struct mobj_reg_shm *r)
+{
+	return tee_mm_get_bytes(r->mm);
+}
+
+static void reg_shm_idle_remove(struct mobj_reg_shm *r)
 {
-	assert(r->mm);
-	assert(r->mm->pool->shift == SMALL_PAGE_SHIFT);
-	core_mmu_unmap_pages(tee_mm_get_smem(r->mm), r->mm->size);
-	tee_mm_free(r->mm);
+	TAILQ_REMOVE(&reg_shm_idle_list, r, idle_link);
+	r->idle = false;
+	reg_shm_idle_count--;
+	reg_shm_stats.idle_va_size -= reg_shm_va_size(r);
+}
+
+/*
+ * Detaches the mapping of @r, unmapped with reg_shm_unmap_va(). Called
+ * with reg_shm_map_lock held.
+ */
+static tee_mm_entry_t *reg_shm_detach_va(struct mobj_reg_shm *r)
+{
+	tee_mm_entry_t *mm = r->mm;
+
+	assert(mm);
+	if (r->idle)
+		reg_shm_idle_remove(r);
 	r->mm = NULL;
+	reg_shm_stats.unmaps++;
+
+	return mm;
+}
+
+/*
+ * Unmaps and frees virtual address space detached with
+ * reg_shm_detach_va(). The space is only freed once unmapped so it can't
+ * be mapped again in the meantime, which allows this to be done after
+ * releasing reg_shm_map_lock.
+ */
+static void reg_shm_unmap_va(tee_mm_entry_t *mm)
+{
+	assert(mm->pool->shift == SMALL_PAGE_SHIFT);
+	core_mmu_unmap_pages(tee_mm_get_smem(mm), mm->size);
+	tee_mm_free(mm);
+}
+
+/* Called with reg_shm_map_lock held */
+static tee_mm_entry_t *reg_shm_idle_evict(void)
+{
+	reg_shm_stats.evictions++;
+	return reg_shm_detach_va(TAILQ_FIRST(&reg_shm_idle_list));
 }
 
 static void reg_shm_free_helper(struct mobj_reg_shm *mobj_reg_shm)
@@ -126,11 +200,12 @@ static void reg_shm_free_helper(struct mobj_reg_shm *mobj_reg_shm)
 	uint32_t exceptions = cpu_spin_lock_xsave(&reg_shm_map_lock);
 
 	if (mobj_reg_shm->mm)
-		reg_shm_unmap_helper(mobj_reg_shm);
+		reg_shm_unmap_va(reg_shm_detach_va(mobj_reg_shm));
 
 	cpu_spin_unlock_xrestore(&reg_shm_map_lock, exceptions);
 
-	SLIST_REMOVE(&reg_shm_list, mobj_reg_shm, mobj_reg_shm, next);
+	SLIST_REMOVE(reg_shm_bucket(mobj_reg_shm->cookie), mobj_reg_shm,
+		     mobj_reg_shm, next);
 	free(mobj_reg_shm);
 }
 
@@ -177,13 +252,40 @@ static TEE_Result mobj_reg_shm_get_cattr(struct mobj *mobj __unused,
 	return TEE_SUCCESS;
 }
 
+/*
+ * Makes @r idle, keeping it mapped if it fits in the budget of idle
+ * virtual address space. Returns a mapping to unmap once
+ * reg_shm_map_lock is released if @r couldn't be made idle yet, or NULL.
+ * Called with reg_shm_map_lock held.
+ */
+static tee_mm_entry_t *reg_shm_idle_insert(struct mobj_reg_shm *r)
+{
+	size_t sz = reg_shm_va_size(r);
+
+	if (sz > CFG_CORE_DYN_SHM_IDLE_VA_SIZE)
+		return reg_shm_detach_va(r);
+
+	if (reg_shm_idle_count >= REG_SHM_IDLE_MAX ||
+	    reg_shm_stats.idle_va_size + sz > CFG_CORE_DYN_SHM_IDLE_VA_SIZE)
+		return reg_shm_idle_evict();
+
+	TAILQ_INSERT_TAIL(&reg_shm_idle_list, r, idle_link);
+	r->idle = true;
+	reg_shm_idle_count++;
+	reg_shm_stats.idle_va_size += sz;
+
+	return NULL;
+}
+
 static TEE_Result mobj_reg_shm_inc_map(struct mobj *mobj)
 {
 	TEE_Result res = TEE_SUCCESS;
 	struct mobj_reg_shm *r = to_mobj_reg_shm(mobj);
+	tee_mm_entry_t *mm = NULL;
 	uint32_t exceptions = 0;
 	size_t sz = 0;
 
+again:
 	while (true) {
 		if (refcount_inc(&r->mapcount))
 			return TEE_SUCCESS;
@@ -201,11 +303,27 @@ static TEE_Result mobj_reg_shm_inc_map(struct mobj *mobj)
 
 	/*
 	 * If we have beated another thread calling mobj_reg_shm_dec_map()
-	 * to get the lock we need only to reinitialize mapcount to 1.
+	 * to get the lock or if the mapping is still cached we need only
+	 * to reinitialize mapcount to 1.
 	 */
+	if (r->idle) {
+		reg_shm_idle_remove(r);
+		reg_shm_stats.reuses++;
+	}
 	if (!r->mm) {
 		sz = ROUNDUP(mobj->size + r->page_offset, SMALL_PAGE_SIZE);
 		r->mm = tee_mm_alloc(&tee_mm_shm, sz);
+		if (!r->mm && !TAILQ_EMPTY(&reg_shm_idle_list)) {
+			/*
+			 * Make room by unmapping the least recently used
+			 * idle object with the lock released and start
+			 * over.
+			 */
+			mm = reg_shm_idle_evict();
+			cpu_spin_unlock_xrestore(&reg_shm_map_lock, exceptions);
+			reg_shm_unmap_va(mm);
+			goto again;
+		}
 		if (!r->mm) {
 			res = TEE_ERROR_OUT_OF_MEMORY;
 			goto out;
@@ -219,6 +337,7 @@ static TEE_Result mobj_reg_shm_inc_map(struct mobj *mobj)
 			r->mm = NULL;
 			goto out;
 		}
+		reg_shm_stats.maps++;
 	}
 
 	refcount_set(&r->mapcount, 1);
@@ -231,17 +350,28 @@ out:
 static TEE_Result mobj_reg_shm_dec_map(struct mobj *mobj)
 {
 	struct mobj_reg_shm *r = to_mobj_reg_shm(mobj);
+	tee_mm_entry_t *mm = NULL;
 	uint32_t exceptions = 0;
 
 	if (!refcount_dec(&r->mapcount))
 		return TEE_SUCCESS;
 
-	exceptions = cpu_spin_lock_xsave(&reg_shm_map_lock);
-
-	if (!refcount_val(&r->mapcount))
-		reg_shm_unmap_helper(r);
+	/*
+	 * Keep the mapping to avoid mapping the same pages again when the
+	 * object is used again. Unmapping involves TLB maintenance so
+	 * mappings that must go are unmapped one at a time with the lock
+	 * released.
+	 */
+	do {
+		exceptions = cpu_spin_lock_xsave(&reg_shm_map_lock);
+		mm = NULL;
+		if (!refcount_val(&r->mapcount) && r->mm && !r->idle)
+			mm = reg_shm_idle_insert(r);
+		cpu_spin_unlock_xrestore(&reg_shm_map_lock, exceptions);
 
-	cpu_spin_unlock_xrestore(&reg_shm_map_lock, exceptions);
+		if (mm)
+			reg_shm_unmap_va(mm);
+	} while (mm);
 
 	return TEE_SUCCESS;
 }
@@ -332,7 +462,7 @@ struct mobj *mobj_reg_shm_alloc(paddr_t *pages, size_t num_pages,
 	}
 
 	exceptions = cpu_spin_lock_xsave(&reg_shm_slist_lock);
-	SLIST_INSERT_HEAD(&reg_shm_list, mobj_reg_shm, next);
+	SLIST_INSERT_HEAD(reg_shm_bucket(cookie), mobj_reg_shm, next);
 	cpu_spin_unlock_xrestore(&reg_shm_slist_lock, exceptions);
 
 	return &mobj_reg_shm->mobj;
@@ -353,7 +483,7 @@ static struct mobj_reg_shm *reg_shm_find_unlocked(uint64_t cookie)
 {
 	struct mobj_reg_shm *mobj_reg_shm = NULL;
 
-	SLIST_FOREACH(mobj_reg_shm, &reg_shm_list, next)
+	SLIST_FOREACH(mobj_reg_shm, reg_shm_bucket(cookie), next)
 		if (mobj_reg_shm->cookie == cookie)
 			return mobj_reg_shm;
 
@@ -430,6 +560,21 @@ TEE_Result mobj_reg_shm_release_by_cookie(uint64_t cookie)
 	return TEE_SUCCESS;
 }
 
+void mobj_reg_shm_get_stats(struct mobj_reg_shm_stats *stats, bool reset)
+{
+	uint32_t exceptions = cpu_spin_lock_xsave(&reg_shm_map_lock);
+
+	*stats = reg_shm_stats;
+	if (reset) {
+		reg_shm_stats.maps = 0;
+		reg_shm_stats.unmaps = 0;
+		reg_shm_stats.reuses = 0;
+		reg_shm_stats.evictions = 0;
+	}
+
+	cpu_spin_unlock_xrestore(&reg_shm_map_lock, exceptions);
+}
+
 struct mobj *mobj_mapped_shm_alloc(paddr_t *pages, size_t num_pages,
 				  paddr_t page_offset, uint64_t cookie)
 {
@@ -8,6 +8,7 @@
 #include <drivers/scmi-msg.h>
 #include <drivers/wdt.h>
 #include <io.h>
+#include <kernel/fast_smc.h>
 #include <kernel/tee_misc.h>
 #include <kernel/thread.h>
 #include <mm/core_memprot.h>
@@ -18,33 +19,31 @@
 #include <sam_pl310.h>
 #include <sam_sfr.h>
 
-static enum sm_handler_ret sam_sip_handler(struct thread_smc_args *args)
-{
-	switch (OPTEE_SMC_FUNC_NUM(args->a0)) {
 #if defined(CFG_PL310)
-	case SAMA5_SMC_SIP_L2X0_WRITE_CTRL:
-		return sam_pl310_write_ctrl(args);
-#endif
-	case SAMA5_SMC_SIP_SFR_REG_CALL_ID:
-		return sam_sfr_access_reg(args);
-	case SAMA5_SMC_SIP_SCMI_CALL_ID:
-		scmi_smt_fastcall_smc_entry(0);
-		args->a0 = SAMA5_SMC_SIP_RETURN_SUCCESS;
-		break;
-#if defined(CFG_ATMEL_PM)
-	case SAMA5_SMC_SIP_SET_SUSPEND_MODE:
-		at91_pm_set_suspend_mode(args);
-		break;
-	case SAMA5_SMC_SIP_GET_SUSPEND_MODE:
-		at91_pm_get_suspend_mode(args);
-		break;
+static void sam_sip_l2x0_write_ctrl(struct thread_smc_args *args)
+{
+	sam_pl310_write_ctrl(args);
+}
+sip_smc_register(SAMA5_SMC_SIP_L2X0_WRITE_CTRL, sam_sip_l2x0_write_ctrl);
 #endif
-	default:
-		return SM_HANDLER_PENDING_SMC;
-	}
 
-	return SM_HANDLER_SMC_HANDLED;
+static void sam_sip_sfr_reg(struct thread_smc_args *args)
+{
+	sam_sfr_access_reg(args);
 }
+sip_smc_register(SAMA5_SMC_SIP_SFR_REG_CALL_ID, sam_sip_sfr_reg);
+
+static void sam_sip_scmi(struct thread_smc_args *args)
+{
+	scmi_smt_fastcall_smc_entry(0);
+	args->a0 = SAMA5_SMC_SIP_RETURN_SUCCESS;
+}
+sip_smc_register(SAMA5_SMC_SIP_SCMI_CALL_ID, sam_sip_scmi);
+
+#if defined(CFG_ATMEL_PM)
+sip_smc_register(SAMA5_SMC_SIP_SET_SUSPEND_MODE, at91_pm_set_suspend_mode);
+sip_smc_register(SAMA5_SMC_SIP_GET_SUSPEND_MODE, at91_pm_get_suspend_mode);
+#endif
 
 enum sm_handler_ret sm_platform_handler(struct sm_ctx *ctx)
 {
@@ -58,7 +57,10 @@ enum sm_handler_ret sm_platform_handler(struct sm_ctx *ctx)
 		if (ret == SM_HANDLER_SMC_HANDLED)
 			return ret;
 
-		return sam_sip_handler(args);
+		if (sip_smc_dispatch(args))
+			return SM_HANDLER_SMC_HANDLED;
+
+		return SM_HANDLER_PENDING_SMC;
 	default:
 		return SM_HANDLER_PENDING_SMC;
 	}
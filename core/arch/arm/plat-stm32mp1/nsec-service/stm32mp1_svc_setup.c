@@ -5,6 +5,7 @@
 
 #include <config.h>
 #include <drivers/scmi-msg.h>
+#include <kernel/fast_smc.h>
 #include <kernel/thread.h>
 #include <sm/optee_smc.h>
 #include <sm/sm.h>
@@ -13,48 +14,51 @@
 #include "bsec_svc.h"
 #include "stm32mp1_smc.h"
 
-static enum sm_handler_ret sip_service(struct sm_ctx *ctx __unused,
-				       struct thread_smc_args *args)
+static void sip_call_count(struct thread_smc_args *args)
 {
-	switch (OPTEE_SMC_FUNC_NUM(args->a0)) {
-	case STM32_SIP_SVC_FUNC_CALL_COUNT:
-		args->a0 = STM32_SIP_SVC_FUNCTION_COUNT;
-		break;
-	case STM32_SIP_SVC_FUNC_VERSION:
-		args->a0 = STM32_SIP_SVC_VERSION_MAJOR;
-		args->a1 = STM32_SIP_SVC_VERSION_MINOR;
-		break;
-	case STM32_SIP_SVC_FUNC_UID:
-		args->a0 = STM32_SIP_SVC_UID_0;
-		args->a1 = STM32_SIP_SVC_UID_1;
-		args->a2 = STM32_SIP_SVC_UID_2;
-		args->a3 = STM32_SIP_SVC_UID_3;
-		break;
-	case STM32_SIP_SVC_FUNC_SCMI_AGENT0:
-		if (IS_ENABLED(CFG_STM32MP1_SCMI_SIP)) {
-			scmi_smt_fastcall_smc_entry(0);
-			args->a0 = STM32_SIP_SVC_OK;
-		} else {
-			args->a0 = ARM_SMCCC_RET_NOT_SUPPORTED;
-		}
-		break;
-	case STM32_SIP_SVC_FUNC_SCMI_AGENT1:
-		if (IS_ENABLED(CFG_STM32MP1_SCMI_SIP)) {
-			scmi_smt_fastcall_smc_entry(1);
-			args->a0 = STM32_SIP_SVC_OK;
-		} else {
-			args->a0 = ARM_SMCCC_RET_NOT_SUPPORTED;
-		}
-		break;
-	case STM32_SIP_SVC_FUNC_BSEC:
-		bsec_main(args);
-		break;
-	default:
-		return SM_HANDLER_PENDING_SMC;
+	args->a0 = STM32_SIP_SVC_FUNCTION_COUNT;
+}
+sip_smc_register(STM32_SIP_SVC_FUNC_CALL_COUNT, sip_call_count);
+
+static void sip_version(struct thread_smc_args *args)
+{
+	args->a0 = STM32_SIP_SVC_VERSION_MAJOR;
+	args->a1 = STM32_SIP_SVC_VERSION_MINOR;
+}
+sip_smc_register(STM32_SIP_SVC_FUNC_VERSION, sip_version);
+
+static void sip_uid(struct thread_smc_args *args)
+{
+	args->a0 = STM32_SIP_SVC_UID_0;
+	args->a1 = STM32_SIP_SVC_UID_1;
+	args->a2 = STM32_SIP_SVC_UID_2;
+	args->a3 = STM32_SIP_SVC_UID_3;
+}
+sip_smc_register(STM32_SIP_SVC_FUNC_UID, sip_uid);
+
+static void sip_scmi_agent(struct thread_smc_args *args, unsigned int agent)
+{
+	if (IS_ENABLED(CFG_STM32MP1_SCMI_SIP)) {
+		scmi_smt_fastcall_smc_entry(agent);
+		args->a0 = STM32_SIP_SVC_OK;
+	} else {
+		args->a0 = ARM_SMCCC_RET_NOT_SUPPORTED;
 	}
+}
 
-	return SM_HANDLER_SMC_HANDLED;
+static void sip_scmi_agent0(struct thread_smc_args *args)
+{
+	sip_scmi_agent(args, 0);
 }
+sip_smc_register(STM32_SIP_SVC_FUNC_SCMI_AGENT0, sip_scmi_agent0);
+
+static void sip_scmi_agent1(struct thread_smc_args *args)
+{
+	sip_scmi_agent(args, 1);
+}
+sip_smc_register(STM32_SIP_SVC_FUNC_SCMI_AGENT1, sip_scmi_agent1);
+
+sip_smc_register(STM32_SIP_SVC_FUNC_BSEC, bsec_main);
 
 enum sm_handler_ret sm_platform_handler(struct sm_ctx *ctx)
 {
@@ -65,7 +69,9 @@ enum sm_handler_ret sm_platform_handler(struct sm_ctx *ctx)
 
 	switch (OPTEE_SMC_OWNER_NUM(args->a0)) {
 	case OPTEE_SMC_OWNER_SIP:
-		return sip_service(ctx, args);
+		if (sip_smc_dispatch(args))
+			return SM_HANDLER_SMC_HANDLED;
+		return SM_HANDLER_PENDING_SMC;
 	default:
 		return SM_HANDLER_PENDING_SMC;
 	}
@@ -6,6 +6,7 @@
 
 #include <config.h>
 #include <kernel/boot.h>
+#include <kernel/fast_smc.h>
 #include <kernel/misc.h>
 #include <kernel/notif.h>
 #include <kernel/tee_l2cc_mutex.h>
@@ -208,84 +209,58 @@ static void get_async_notif_value(struct thread_smc_args *args)
 		args->a2 |= OPTEE_SMC_ASYNC_NOTIF_PENDING;
 }
 
-/*
- * If tee_entry_fast() is overridden, it's still supposed to call this
- * function.
- */
-void __tee_entry_fast(struct thread_smc_args *args)
+static void tee_entry_enable_async_notif(struct thread_smc_args *args)
 {
-	switch (args->a0) {
+	if (IS_ENABLED(CFG_CORE_ASYNC_NOTIF)) {
+		notif_deliver_atomic_event(NOTIF_EVENT_STARTED);
+		args->a0 = OPTEE_SMC_RETURN_OK;
+	} else {
+		args->a0 = OPTEE_SMC_RETURN_UNKNOWN_FUNCTION;
+	}
+}
 
-	/* Generic functions */
-	case OPTEE_SMC_CALLS_COUNT:
-		tee_entry_get_api_call_count(args);
-		break;
-	case OPTEE_SMC_CALLS_UID:
-		tee_entry_get_api_uuid(args);
-		break;
-	case OPTEE_SMC_CALLS_REVISION:
-		tee_entry_get_api_revision(args);
-		break;
-	case OPTEE_SMC_CALL_GET_OS_UUID:
-		tee_entry_get_os_uuid(args);
-		break;
-	case OPTEE_SMC_CALL_GET_OS_REVISION:
-		tee_entry_get_os_revision(args);
-		break;
+static void tee_entry_get_async_notif_value(struct thread_smc_args *args)
+{
+	if (IS_ENABLED(CFG_CORE_ASYNC_NOTIF))
+		get_async_notif_value(args);
+	else
+		args->a0 = OPTEE_SMC_RETURN_UNKNOWN_FUNCTION;
+}
 
-	/* OP-TEE specific SMC functions */
+/* Generic functions */
+fast_smc_register(OPTEE_SMC_CALLS_COUNT, tee_entry_get_api_call_count);
+fast_smc_register(OPTEE_SMC_CALLS_UID, tee_entry_get_api_uuid);
+fast_smc_register(OPTEE_SMC_CALLS_REVISION, tee_entry_get_api_revision);
+fast_smc_register(OPTEE_SMC_CALL_GET_OS_UUID, tee_entry_get_os_uuid);
+fast_smc_register(OPTEE_SMC_CALL_GET_OS_REVISION, tee_entry_get_os_revision);
+
+/* OP-TEE specific SMC functions */
 #ifdef CFG_CORE_RESERVED_SHM
-	case OPTEE_SMC_GET_SHM_CONFIG:
-		tee_entry_get_shm_config(args);
-		break;
+fast_smc_register(OPTEE_SMC_GET_SHM_CONFIG, tee_entry_get_shm_config);
 #endif
-	case OPTEE_SMC_L2CC_MUTEX:
-		tee_entry_fastcall_l2cc_mutex(args);
-		break;
-	case OPTEE_SMC_EXCHANGE_CAPABILITIES:
-		tee_entry_exchange_capabilities(args);
-		break;
-	case OPTEE_SMC_DISABLE_SHM_CACHE:
-		tee_entry_disable_shm_cache(args);
-		break;
-	case OPTEE_SMC_ENABLE_SHM_CACHE:
-		tee_entry_enable_shm_cache(args);
-		break;
-	case OPTEE_SMC_BOOT_SECONDARY:
-		tee_entry_boot_secondary(args);
-		break;
-	case OPTEE_SMC_GET_THREAD_COUNT:
-		tee_entry_get_thread_count(args);
-		break;
-
+fast_smc_register(OPTEE_SMC_L2CC_MUTEX, tee_entry_fastcall_l2cc_mutex);
+fast_smc_register(OPTEE_SMC_EXCHANGE_CAPABILITIES,
+		  tee_entry_exchange_capabilities);
+fast_smc_register(OPTEE_SMC_DISABLE_SHM_CACHE, tee_entry_disable_shm_cache);
+fast_smc_register(OPTEE_SMC_ENABLE_SHM_CACHE, tee_entry_enable_shm_cache);
+fast_smc_register(OPTEE_SMC_BOOT_SECONDARY, tee_entry_boot_secondary);
+fast_smc_register(OPTEE_SMC_GET_THREAD_COUNT, tee_entry_get_thread_count);
 #if defined(CFG_VIRTUALIZATION)
-	case OPTEE_SMC_VM_CREATED:
-		tee_entry_vm_created(args);
-		break;
-	case OPTEE_SMC_VM_DESTROYED:
-		tee_entry_vm_destroyed(args);
-		break;
+fast_smc_register(OPTEE_SMC_VM_CREATED, tee_entry_vm_created);
+fast_smc_register(OPTEE_SMC_VM_DESTROYED, tee_entry_vm_destroyed);
 #endif
+fast_smc_register(OPTEE_SMC_ENABLE_ASYNC_NOTIF, tee_entry_enable_async_notif);
+fast_smc_register(OPTEE_SMC_GET_ASYNC_NOTIF_VALUE,
+		  tee_entry_get_async_notif_value);
 
-	case OPTEE_SMC_ENABLE_ASYNC_NOTIF:
-		if (IS_ENABLED(CFG_CORE_ASYNC_NOTIF)) {
-			notif_deliver_atomic_event(NOTIF_EVENT_STARTED);
-			args->a0 = OPTEE_SMC_RETURN_OK;
-		} else {
-			args->a0 = OPTEE_SMC_RETURN_UNKNOWN_FUNCTION;
-		}
-		break;
-	case OPTEE_SMC_GET_ASYNC_NOTIF_VALUE:
-		if (IS_ENABLED(CFG_CORE_ASYNC_NOTIF))
-			get_async_notif_value(args);
-		else
-			args->a0 = OPTEE_SMC_RETURN_UNKNOWN_FUNCTION;
-		break;
-
-	default:
+/*
+ * If tee_entry_fast() is overridden, it's still supposed to call this
+ * function.
+ */
+void __tee_entry_fast(struct thread_smc_args *args)
+{
+	if (!fast_smc_dispatch(args))
 		args->a0 = OPTEE_SMC_RETURN_UNKNOWN_FUNCTION;
-		break;
-	}
 }
 
 size_t tee_entry_generic_get_api_call_count(void)
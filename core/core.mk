@@ -142,6 +142,12 @@ libdir = core/lib/zlib
 include mk/lib.mk
 endif
 
+ifneq (,$(filter y,$(CFG_TA_COMPRESSION) $(CFG_EARLY_TA_PAGED)))
+libname = lz4
+libdir = core/lib/lz4
+include mk/lib.mk
+endif
+
 libname = unw
 libdir = lib/libunw
 include mk/lib.mk
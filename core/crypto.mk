@@ -44,6 +44,9 @@ CFG_CRYPTO_RSA ?= y
 CFG_CRYPTO_DH ?= y
 # ECC includes ECDSA and ECDH
 CFG_CRYPTO_ECC ?= y
+# Precomputed comb for the generator of NIST P-256, P-384 and SM2, speeds
+# up signing and key generation at the cost of ~4kB of heap
+CFG_CRYPTO_ECC_COMB ?= y
 CFG_CRYPTO_SM2_PKE ?= y
 CFG_CRYPTO_SM2_DSA ?= y
 CFG_CRYPTO_SM2_KEP ?= y
@@ -79,11 +82,52 @@ CFG_CRYPTO_SHA256_ARM_CE ?= $(CFG_CRYPTO_SHA256)
 CFG_CORE_CRYPTO_SHA256_ACCEL ?= $(CFG_CRYPTO_SHA256_ARM_CE)
 CFG_CRYPTO_SHA1_ARM_CE ?= $(CFG_CRYPTO_SHA1)
 CFG_CORE_CRYPTO_SHA1_ACCEL ?= $(CFG_CRYPTO_SHA1_ARM_CE)
+# The SHA512 instructions are an optional ARMv8.2 extension (FEAT_SHA512),
+# only available in AArch64 and lacking in many cores implementing the
+# other Cryptographic Extensions. Enable CFG_CRYPTO_SHA512_ARM_CE only if
+# all cores support them.
+CFG_CRYPTO_SHA512_ARM_CE ?= n
+$(eval $(call cfg-depends-all,CFG_CRYPTO_SHA512_ARM_CE,CFG_ARM64_core))
+CFG_CORE_CRYPTO_SHA512_ACCEL ?= $(CFG_CRYPTO_SHA512_ARM_CE)
 CFG_CRYPTO_AES_ARM_CE ?= $(CFG_CRYPTO_AES)
 CFG_CORE_CRYPTO_AES_ACCEL ?= $(CFG_CRYPTO_AES_ARM_CE)
+# The SM4 instructions (FEAT_SM4) are optional in the same way as the
+# SHA512 instructions.
+CFG_CRYPTO_SM4_ARM_CE ?= n
+$(eval $(call cfg-depends-all,CFG_CRYPTO_SM4_ARM_CE,CFG_ARM64_core))
+ifeq ($(CFG_CRYPTO_SM4_ARM_CE),y)
+$(call force,CFG_CRYPTO_SM4_ARM_NEON,n,conflicts with CFG_CRYPTO_SM4_ARM_CE)
+endif
+# The NEON SM4 has no data dependent memory accesses, unlike the generic
+# table based implementation, but it's only faster when four blocks are
+# processed at once. It's therefore not enabled by default.
+CFG_CRYPTO_SM4_ARM_NEON ?= n
+CFG_CORE_CRYPTO_SM4_ACCEL ?= $(call cfg-one-enabled,CFG_CRYPTO_SM4_ARM_CE \
+					       CFG_CRYPTO_SM4_ARM_NEON)
 
 else #CFG_CRYPTO_WITH_CE
 
+# CFG_CRYPTO_WITH_NEON selects the constant time bitsliced NEON
+# implementation of AES, the NEON based GHASH, the NEON multi-buffer
+# SHA-256 and the NEON SHA-512 on cores lacking the Cryptographic
+# Extensions, typically ARMv7-A cores like Cortex-A7/A9. The table-free
+# NEON SM4 is enabled separately with CFG_CRYPTO_SM4_ARM_NEON=y.
+CFG_CRYPTO_WITH_NEON ?= n
+
+ifeq ($(CFG_CRYPTO_WITH_NEON),y)
+CFG_CRYPTO_AES_ARM_NEON ?= $(CFG_CRYPTO_AES)
+CFG_CORE_CRYPTO_AES_ACCEL ?= $(CFG_CRYPTO_AES_ARM_NEON)
+CFG_CRYPTO_SHA256_ARM_NEON_MB ?= $(CFG_CRYPTO_SHA256)
+CFG_CORE_CRYPTO_SHA256_MB_ACCEL ?= $(CFG_CRYPTO_SHA256_ARM_NEON_MB)
+CFG_CRYPTO_SHA512_ARM_NEON ?= $(CFG_CRYPTO_SHA512)
+CFG_CORE_CRYPTO_SHA512_ACCEL ?= $(CFG_CRYPTO_SHA512_ARM_NEON)
+CFG_CRYPTO_SM4_ARM_NEON ?= n
+CFG_CORE_CRYPTO_SM4_ACCEL ?= $(CFG_CRYPTO_SM4_ARM_NEON)
+endif
+ifeq ($(CFG_CRYPTO_AES_ARM_NEON),y)
+$(call force,CFG_AES_GCM_TABLE_BASED,n,conflicts with CFG_CRYPTO_AES_ARM_NEON)
+endif
+
 CFG_AES_GCM_TABLE_BASED ?= y
 
 endif #!CFG_CRYPTO_WITH_CE
@@ -103,6 +147,24 @@ endif
 ifeq ($(CFG_CRYPTO_AES_ARM_CE),y)
 $(call force,CFG_WITH_VFP,y,required by CFG_CRYPTO_AES_ARM_CE)
 endif
+ifeq ($(CFG_CRYPTO_AES_ARM_NEON),y)
+$(call force,CFG_WITH_VFP,y,required by CFG_CRYPTO_AES_ARM_NEON)
+endif
+ifeq ($(CFG_CRYPTO_SHA256_ARM_NEON_MB),y)
+$(call force,CFG_WITH_VFP,y,required by CFG_CRYPTO_SHA256_ARM_NEON_MB)
+endif
+ifeq ($(CFG_CRYPTO_SHA512_ARM_CE),y)
+$(call force,CFG_WITH_VFP,y,required by CFG_CRYPTO_SHA512_ARM_CE)
+endif
+ifeq ($(CFG_CRYPTO_SHA512_ARM_NEON),y)
+$(call force,CFG_WITH_VFP,y,required by CFG_CRYPTO_SHA512_ARM_NEON)
+endif
+ifeq ($(CFG_CRYPTO_SM4_ARM_CE),y)
+$(call force,CFG_WITH_VFP,y,required by CFG_CRYPTO_SM4_ARM_CE)
+endif
+ifeq ($(CFG_CRYPTO_SM4_ARM_NEON),y)
+$(call force,CFG_WITH_VFP,y,required by CFG_CRYPTO_SM4_ARM_NEON)
+endif
 
 cryp-enable-all-depends = $(call cfg-enable-all-depends,$(strip $(1)),$(foreach v,$(2),CFG_CRYPTO_$(v)))
 $(eval $(call cryp-enable-all-depends,CFG_REE_FS, AES ECB CTR HMAC SHA256 GCM))
@@ -133,6 +195,7 @@ $(eval $(call cryp-dep-one, DES, ECB CBC))
 $(eval $(call cryp-dep-one, SM2_PKE, ECC))
 $(eval $(call cryp-dep-one, SM2_DSA, ECC))
 $(eval $(call cryp-dep-one, SM2_KEP, ECC))
+$(eval $(call cryp-dep-one, ECC_COMB, ECC))
 
 ###############################################################
 # libtomcrypt (LTC) specifics, phase #1
@@ -158,7 +221,7 @@ core-ltc-vars += CCM
 ifeq ($(CFG_CRYPTO_AES_GCM_FROM_CRYPTOLIB),y)
 core-ltc-vars += GCM
 endif
-core-ltc-vars += RSA DSA DH ECC
+core-ltc-vars += RSA DSA DH ECC ECC_COMB
 core-ltc-vars += SIZE_OPTIMIZATION
 core-ltc-vars += SM2_PKE
 core-ltc-vars += SM2_DSA
@@ -169,6 +232,7 @@ _CFG_CORE_LTC_MPI := $(CFG_CORE_MBEDTLS_MPI)
 _CFG_CORE_LTC_AES_ACCEL := $(CFG_CORE_CRYPTO_AES_ACCEL)
 _CFG_CORE_LTC_SHA1_ACCEL := $(CFG_CORE_CRYPTO_SHA1_ACCEL)
 _CFG_CORE_LTC_SHA256_ACCEL := $(CFG_CORE_CRYPTO_SHA256_ACCEL)
+_CFG_CORE_LTC_SHA512_ACCEL := $(CFG_CORE_CRYPTO_SHA512_ACCEL)
 endif
 
 ###############################################################
@@ -233,6 +297,20 @@ _CFG_CORE_LTC_ASN1 := $(call ltc-one-enabled, RSA DSA ECC)
 CRYPTO_MAKEFILES := $(sort $(wildcard core/drivers/crypto/*/crypto.mk))
 include $(CRYPTO_MAKEFILES)
 
+# Dispatch the hash and cipher requests either to the crypto driver or to
+# the software implementation depending on the request size and on the
+# number of requests already processed by the crypto driver. The size
+# above which the crypto driver is used is calibrated at boot with the
+# generic timer.
+CFG_CRYPTO_DRV_DISPATCH ?= n
+$(eval $(call cfg-depends-one,CFG_CRYPTO_DRV_DISPATCH, \
+	      CFG_CRYPTO_DRV_HASH CFG_CRYPTO_DRV_CIPHER))
+$(eval $(call cfg-depends-all,CFG_CRYPTO_DRV_DISPATCH, \
+	      CFG_CORE_HAS_GENERIC_TIMER))
+# Number of requests processed by the crypto driver at the same time above
+# which requests are processed in software
+CFG_CRYPTO_DRV_DISPATCH_DEPTH ?= 4
+
 # Enable TEE_ALG_RSASSA_PKCS1_V1_5 algorithm for signing with PKCS#1 v1.5 EMSA
 # without ASN.1 around the hash.
 ifeq ($(CFG_CRYPTOLIB_NAME),tomcrypt)
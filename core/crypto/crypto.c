@@ -14,6 +14,29 @@
 #include <string.h>
 #include <utee_defines.h>
 
+TEE_Result crypto_hash_sw_alloc_ctx(struct crypto_hash_ctx **ctx,
+				    uint32_t algo)
+{
+	switch (algo) {
+	case TEE_ALG_MD5:
+		return crypto_md5_alloc_ctx(ctx);
+	case TEE_ALG_SHA1:
+		return crypto_sha1_alloc_ctx(ctx);
+	case TEE_ALG_SHA224:
+		return crypto_sha224_alloc_ctx(ctx);
+	case TEE_ALG_SHA256:
+		return crypto_sha256_alloc_ctx(ctx);
+	case TEE_ALG_SHA384:
+		return crypto_sha384_alloc_ctx(ctx);
+	case TEE_ALG_SHA512:
+		return crypto_sha512_alloc_ctx(ctx);
+	case TEE_ALG_SM3:
+		return crypto_sm3_alloc_ctx(ctx);
+	default:
+		return TEE_ERROR_NOT_IMPLEMENTED;
+	}
+}
+
 TEE_Result crypto_hash_alloc_ctx(void **ctx, uint32_t algo)
 {
 	TEE_Result res = TEE_ERROR_NOT_IMPLEMENTED;
@@ -25,33 +48,8 @@ TEE_Result crypto_hash_alloc_ctx(void **ctx, uint32_t algo)
 	 */
 	res = drvcrypt_hash_alloc_ctx(&c, algo);
 
-	if (res == TEE_ERROR_NOT_IMPLEMENTED) {
-		switch (algo) {
-		case TEE_ALG_MD5:
-			res = crypto_md5_alloc_ctx(&c);
-			break;
-		case TEE_ALG_SHA1:
-			res = crypto_sha1_alloc_ctx(&c);
-			break;
-		case TEE_ALG_SHA224:
-			res = crypto_sha224_alloc_ctx(&c);
-			break;
-		case TEE_ALG_SHA256:
-			res = crypto_sha256_alloc_ctx(&c);
-			break;
-		case TEE_ALG_SHA384:
-			res = crypto_sha384_alloc_ctx(&c);
-			break;
-		case TEE_ALG_SHA512:
-			res = crypto_sha512_alloc_ctx(&c);
-			break;
-		case TEE_ALG_SM3:
-			res = crypto_sm3_alloc_ctx(&c);
-			break;
-		default:
-			break;
-		}
-	}
+	if (res == TEE_ERROR_NOT_IMPLEMENTED)
+		res = crypto_hash_sw_alloc_ctx(&c, algo);
 
 	if (!res)
 		*ctx = c;
@@ -94,6 +92,39 @@ TEE_Result crypto_hash_final(void *ctx, uint8_t *digest, size_t len)
 	return hash_ops(ctx)->final(ctx, digest, len);
 }
 
+TEE_Result crypto_cipher_sw_alloc_ctx(struct crypto_cipher_ctx **ctx,
+				      uint32_t algo)
+{
+	switch (algo) {
+	case TEE_ALG_AES_ECB_NOPAD:
+		return crypto_aes_ecb_alloc_ctx(ctx);
+	case TEE_ALG_AES_CBC_NOPAD:
+		return crypto_aes_cbc_alloc_ctx(ctx);
+	case TEE_ALG_AES_CTR:
+		return crypto_aes_ctr_alloc_ctx(ctx);
+	case TEE_ALG_AES_CTS:
+		return crypto_aes_cts_alloc_ctx(ctx);
+	case TEE_ALG_AES_XTS:
+		return crypto_aes_xts_alloc_ctx(ctx);
+	case TEE_ALG_DES_ECB_NOPAD:
+		return crypto_des_ecb_alloc_ctx(ctx);
+	case TEE_ALG_DES3_ECB_NOPAD:
+		return crypto_des3_ecb_alloc_ctx(ctx);
+	case TEE_ALG_DES_CBC_NOPAD:
+		return crypto_des_cbc_alloc_ctx(ctx);
+	case TEE_ALG_DES3_CBC_NOPAD:
+		return crypto_des3_cbc_alloc_ctx(ctx);
+	case TEE_ALG_SM4_ECB_NOPAD:
+		return crypto_sm4_ecb_alloc_ctx(ctx);
+	case TEE_ALG_SM4_CBC_NOPAD:
+		return crypto_sm4_cbc_alloc_ctx(ctx);
+	case TEE_ALG_SM4_CTR:
+		return crypto_sm4_ctr_alloc_ctx(ctx);
+	default:
+		return TEE_ERROR_NOT_IMPLEMENTED;
+	}
+}
+
 TEE_Result crypto_cipher_alloc_ctx(void **ctx, uint32_t algo)
 {
 	TEE_Result res = TEE_ERROR_NOT_IMPLEMENTED;
@@ -105,48 +136,8 @@ TEE_Result crypto_cipher_alloc_ctx(void **ctx, uint32_t algo)
 	 */
 	res = drvcrypt_cipher_alloc_ctx(&c, algo);
 
-	if (res == TEE_ERROR_NOT_IMPLEMENTED) {
-		switch (algo) {
-		case TEE_ALG_AES_ECB_NOPAD:
-			res = crypto_aes_ecb_alloc_ctx(&c);
-			break;
-		case TEE_ALG_AES_CBC_NOPAD:
-			res = crypto_aes_cbc_alloc_ctx(&c);
-			break;
-		case TEE_ALG_AES_CTR:
-			res = crypto_aes_ctr_alloc_ctx(&c);
-			break;
-		case TEE_ALG_AES_CTS:
-			res = crypto_aes_cts_alloc_ctx(&c);
-			break;
-		case TEE_ALG_AES_XTS:
-			res = crypto_aes_xts_alloc_ctx(&c);
-			break;
-		case TEE_ALG_DES_ECB_NOPAD:
-			res = crypto_des_ecb_alloc_ctx(&c);
-			break;
-		case TEE_ALG_DES3_ECB_NOPAD:
-			res = crypto_des3_ecb_alloc_ctx(&c);
-			break;
-		case TEE_ALG_DES_CBC_NOPAD:
-			res = crypto_des_cbc_alloc_ctx(&c);
-			break;
-		case TEE_ALG_DES3_CBC_NOPAD:
-			res = crypto_des3_cbc_alloc_ctx(&c);
-			break;
-		case TEE_ALG_SM4_ECB_NOPAD:
-			res = crypto_sm4_ecb_alloc_ctx(&c);
-			break;
-		case TEE_ALG_SM4_CBC_NOPAD:
-			res = crypto_sm4_cbc_alloc_ctx(&c);
-			break;
-		case TEE_ALG_SM4_CTR:
-			res = crypto_sm4_ctr_alloc_ctx(&c);
-			break;
-		default:
-			return TEE_ERROR_NOT_IMPLEMENTED;
-		}
-	}
+	if (res == TEE_ERROR_NOT_IMPLEMENTED)
+		res = crypto_cipher_sw_alloc_ctx(&c, algo);
 
 	if (!res)
 		*ctx = c;
@@ -186,6 +177,14 @@ TEE_Result crypto_cipher_init(void *ctx, TEE_OperationMode mode,
 				     iv, iv_len);
 }
 
+TEE_Result crypto_cipher_set_iv(void *ctx, const uint8_t *iv, size_t iv_len)
+{
+	if (!cipher_ops(ctx)->set_iv)
+		return TEE_ERROR_NOT_IMPLEMENTED;
+
+	return cipher_ops(ctx)->set_iv(ctx, iv, iv_len);
+}
+
 TEE_Result crypto_cipher_update(void *ctx, TEE_OperationMode mode __unused,
 				bool last_block, const uint8_t *data,
 				size_t len, uint8_t *dst)
@@ -803,3 +802,8 @@ TEE_Result crypto_acipher_sm2_kep_derive(struct ecc_keypair *my_key __unused,
 __weak void crypto_storage_obj_del(uint8_t *data __unused, size_t len __unused)
 {
 }
+
+__weak void
+crypto_acipher_flush_rsa_keypair_cache(struct rsa_keypair *s __unused)
+{
+}
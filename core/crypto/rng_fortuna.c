@@ -5,15 +5,22 @@
  * This is an implementation of the Fortuna cryptographic PRNG as defined in
  * https://www.schneier.com/academic/paperfiles/fortuna.pdf
  * There's one small exception, see comment in restart_pool() below.
+ *
+ * The generator is instantiated once per core so that concurrent readers
+ * don't serialize on a single key, see struct fortuna_gen below. Only the
+ * entropy pools are shared.
  */
 
 #include <assert.h>
+#include <atomic.h>
 #include <crypto/crypto.h>
+#include <kernel/misc.h>
 #include <kernel/mutex.h>
 #include <kernel/refcount.h>
-#include <kernel/spinlock.h>
 #include <kernel/tee_time.h>
+#include <kernel/thread.h>
 #include <string.h>
+#include <string_ext.h>
 #include <types_ext.h>
 #include <utee_defines.h>
 #include <util.h>
@@ -28,29 +35,33 @@
 #define RING_BUF_DATA_SIZE	4U
 
 /*
- * struct fortuna_state - state of the Fortuna PRNG
- * @ctx:		Cipher context used to produce the random numbers
- * @counter:		Counter which is encrypted to produce the random numbers
+ * struct fortuna_state - state of the entropy pools of the Fortuna PRNG
  * @pool0_length:	Amount of data added to pool0
  * @pool_ctx:		One hash context for each pool
  * @reseed_ctx:		Hash context used while reseeding
  * @reseed_count:	Number of time we've reseeded the PRNG, used to tell
  *			which pools should be used in the reseed process
+ * @seed:		Digest of the pools used in the last reseed
+ * @seed_gen:		Incremented each time @seed is updated, 0 until the
+ *			PRNG is initialized
+ * @failed:		Set once an error has left the PRNG in an unknown
+ *			state, all later reads fail
  * @next_reseed_time:	If we have a secure time, the earliest next time we
  *			may reseed
  *
- * To minimize the delay in crypto_rng_add_event() there's @pool_spin_lock
- * which protects everything needed by this function.
+ * Everything is protected by @state_mu except @seed_gen and @failed which
+ * are also read without it.
  *
  * @next_reseed_time is used as a rate limiter for reseeding.
  */
 static struct fortuna_state {
-	void *ctx;
-	uint64_t counter[2];
 	unsigned int pool0_length;
 	void *pool_ctx[NUM_POOLS];
 	void *reseed_ctx;
 	uint32_t reseed_count;
+	uint8_t seed[KEY_SIZE];
+	unsigned int seed_gen;
+	unsigned int failed;
 #ifndef CFG_SECURE_TIME_SOURCE_REE
 	TEE_Time next_reseed_time;
 #endif
@@ -58,6 +69,32 @@ static struct fortuna_state {
 
 static struct mutex state_mu = MUTEX_INITIALIZER;
 
+/*
+ * struct fortuna_gen - generator of the Fortuna PRNG
+ * @mu:		Serializes the readers using this generator
+ * @ctx:	Cipher context used to produce the random numbers
+ * @counter:	Counter which is encrypted to produce the random numbers
+ * @seed_gen:	Value of state.seed_gen when the key was derived
+ *
+ * There is one generator for each core, each keyed from its own previous
+ * output and the seed taken from the shared pools. Readers on different
+ * cores don't wait for each other.
+ */
+static struct fortuna_gen {
+	struct mutex mu;
+	void *ctx;
+	uint64_t counter[2];
+	unsigned int seed_gen;
+} gens[CFG_TEE_CORE_NB_CORE];
+
+/* Number of times a reader had to wait for the generator of its core */
+static unsigned int gen_contention;
+
+/*
+ * Queued events of each core. An event is pushed with all exceptions
+ * masked on the current core, so each ring has a single producer and the
+ * consumer holds @state_mu.
+ */
 static struct {
 	struct {
 		uint8_t snum;
@@ -67,9 +104,7 @@ static struct {
 	} elem[8];
 	unsigned int begin;
 	unsigned int end;
-} ring_buffer;
-
-unsigned int ring_buffer_spin_lock;
+} ring_buffer[CFG_TEE_CORE_NB_CORE];
 
 static void inc_counter(uint64_t counter[2])
 {
@@ -123,20 +158,20 @@ static void fortuna_done(void)
 	}
 	crypto_hash_free_ctx(state.reseed_ctx);
 	state.reseed_ctx = NULL;
-	crypto_cipher_free_ctx(state.ctx);
-	state.ctx = NULL;
+	for (n = 0; n < ARRAY_SIZE(gens); n++) {
+		crypto_cipher_free_ctx(gens[n].ctx);
+		gens[n].ctx = NULL;
+	}
 }
 
 TEE_Result crypto_rng_init(const void *data, size_t dlen)
 {
 	TEE_Result res;
-	uint8_t key[KEY_SIZE];
-	void *ctx;
 	size_t n;
 
-	COMPILE_TIME_ASSERT(sizeof(state.counter) == BLOCK_SIZE);
+	COMPILE_TIME_ASSERT(sizeof(gens[0].counter) == BLOCK_SIZE);
 
-	if (state.ctx)
+	if (state.seed_gen)
 		return TEE_ERROR_BAD_STATE;
 
 	memset(&state, 0, sizeof(state));
@@ -154,18 +189,19 @@ TEE_Result crypto_rng_init(const void *data, size_t dlen)
 	if (res)
 		goto err;
 
-	res = key_from_data(state.reseed_ctx, data, dlen, key);
-	if (res)
-		return res;
+	for (n = 0; n < ARRAY_SIZE(gens); n++) {
+		mutex_init(&gens[n].mu);
+		res = crypto_cipher_alloc_ctx(&gens[n].ctx, CIPHER_ALGO);
+		if (res)
+			goto err;
+	}
 
-	res = crypto_cipher_alloc_ctx(&ctx, CIPHER_ALGO);
-	if (res)
-		return res;
-	res = cipher_init(ctx, key);
+	/* The generators are keyed from the seed on first use */
+	res = key_from_data(state.reseed_ctx, data, dlen, state.seed);
 	if (res)
-		return res;
-	inc_counter(state.counter);
-	state.ctx = ctx;
+		goto err;
+	state.seed_gen = 1;
+
 	return TEE_SUCCESS;
 err:
 	fortuna_done();
@@ -176,49 +212,60 @@ static void push_ring_buffer(uint8_t snum, uint8_t pnum, const void *data,
 			     size_t dlen)
 {
 	uint8_t dl = MIN(RING_BUF_DATA_SIZE, dlen);
-	unsigned int next_begin;
-	uint32_t old_itr_status;
+	uint32_t exceptions = thread_mask_exceptions(THREAD_EXCP_ALL);
+	unsigned int next_begin = 0;
+	__typeof__(ring_buffer[0]) *rb = ring_buffer + get_core_pos();
 
-	/* Spinlock to serialize writers */
-	old_itr_status = cpu_spin_lock_xsave(&ring_buffer_spin_lock);
-
-	next_begin = (ring_buffer.begin + 1) % ARRAY_SIZE(ring_buffer.elem);
-	if (next_begin == atomic_load_uint(&ring_buffer.end))
+	next_begin = (rb->begin + 1) % ARRAY_SIZE(rb->elem);
+	if (next_begin == atomic_load_uint(&rb->end))
 		goto out; /* buffer is full */
 
-	ring_buffer.elem[next_begin].snum = snum;
-	ring_buffer.elem[next_begin].pnum = pnum;
-	ring_buffer.elem[next_begin].dlen = dl;
-	memcpy(ring_buffer.elem[next_begin].data, data, dl);
+	rb->elem[next_begin].snum = snum;
+	rb->elem[next_begin].pnum = pnum;
+	rb->elem[next_begin].dlen = dl;
+	memcpy(rb->elem[next_begin].data, data, dl);
 
-	atomic_store_uint(&ring_buffer.begin, next_begin);
+	atomic_store_uint(&rb->begin, next_begin);
 
 out:
-	cpu_spin_unlock_xrestore(&ring_buffer_spin_lock, old_itr_status);
+	thread_unmask_exceptions(exceptions);
 }
 
-static size_t pop_ring_buffer(uint8_t *snum, uint8_t *pnum,
+static size_t pop_ring_buffer(size_t core, uint8_t *snum, uint8_t *pnum,
 			      uint8_t data[RING_BUF_DATA_SIZE])
 {
+	__typeof__(ring_buffer[0]) *rb = ring_buffer + core;
 	unsigned int next_end;
 	size_t dlen;
 
-	if (atomic_load_uint(&ring_buffer.begin) == ring_buffer.end)
+	if (atomic_load_uint(&rb->begin) == rb->end)
 		return 0;
 
-	next_end = (ring_buffer.end + 1) % ARRAY_SIZE(ring_buffer.elem);
+	next_end = (rb->end + 1) % ARRAY_SIZE(rb->elem);
 
-	*snum = ring_buffer.elem[ring_buffer.end].snum;
-	*pnum = ring_buffer.elem[ring_buffer.end].pnum;
-	dlen = MIN(ring_buffer.elem[ring_buffer.end].dlen, RING_BUF_DATA_SIZE);
-	assert(ring_buffer.elem[ring_buffer.end].dlen == dlen);
-	memcpy(data, ring_buffer.elem[ring_buffer.end].data, dlen);
+	*snum = rb->elem[rb->end].snum;
+	*pnum = rb->elem[rb->end].pnum;
+	dlen = MIN(rb->elem[rb->end].dlen, RING_BUF_DATA_SIZE);
+	assert(rb->elem[rb->end].dlen == dlen);
+	memcpy(data, rb->elem[rb->end].data, dlen);
 
-	atomic_store_uint(&ring_buffer.end, next_end);
+	atomic_store_uint(&rb->end, next_end);
 
 	return dlen;
 }
 
+static bool ring_buffer_empty(void)
+{
+	size_t n = 0;
+
+	for (n = 0; n < ARRAY_SIZE(ring_buffer); n++)
+		if (atomic_load_uint(&ring_buffer[n].begin) !=
+		    atomic_load_uint(&ring_buffer[n].end))
+			return false;
+
+	return true;
+}
+
 static TEE_Result add_event(uint8_t snum, uint8_t pnum,
 			    const void *data, size_t dlen)
 {
@@ -247,21 +294,27 @@ static TEE_Result add_event(uint8_t snum, uint8_t pnum,
 
 static TEE_Result drain_ring_buffer(void)
 {
-	while (true) {
-		TEE_Result res;
-		uint8_t snum;
-		uint8_t pnum;
-		uint8_t data[RING_BUF_DATA_SIZE];
-		size_t dlen;
-
-		dlen = pop_ring_buffer(&snum, &pnum, data);
-		if (!dlen)
-			return TEE_SUCCESS;
-
-		res = add_event(snum, pnum, data, dlen);
-		if (res)
-			return res;
+	size_t n = 0;
+
+	for (n = 0; n < ARRAY_SIZE(ring_buffer); n++) {
+		while (true) {
+			TEE_Result res;
+			uint8_t snum;
+			uint8_t pnum;
+			uint8_t data[RING_BUF_DATA_SIZE];
+			size_t dlen;
+
+			dlen = pop_ring_buffer(n, &snum, &pnum, data);
+			if (!dlen)
+				break;
+
+			res = add_event(snum, pnum, data, dlen);
+			if (res)
+				return res;
+		}
 	}
+
+	return TEE_SUCCESS;
 }
 
 static unsigned int get_next_pnum(unsigned int *pnum)
@@ -312,15 +365,16 @@ void crypto_rng_add_event(enum crypto_rng_src sid, unsigned int *pnum,
 }
 
 /* GenerateBlocks */
-static TEE_Result generate_blocks(void *block, size_t nblocks)
+static TEE_Result generate_blocks(struct fortuna_gen *gen, void *block,
+				  size_t nblocks)
 {
 	uint8_t *b = block;
 	size_t n;
 
 	for (n = 0; n < nblocks; n++) {
-		TEE_Result res = crypto_cipher_update(state.ctx,
+		TEE_Result res = crypto_cipher_update(gen->ctx,
 						      TEE_MODE_ENCRYPT, false,
-						      (void *)state.counter,
+						      (void *)gen->counter,
 						      BLOCK_SIZE,
 						      b + n * BLOCK_SIZE);
 
@@ -329,7 +383,7 @@ static TEE_Result generate_blocks(void *block, size_t nblocks)
 		 * eventual errors, we must never re-use the counter with
 		 * the same key.
 		 */
-		inc_counter(state.counter);
+		inc_counter(gen->counter);
 		if (res)
 			return res;
 	}
@@ -338,18 +392,19 @@ static TEE_Result generate_blocks(void *block, size_t nblocks)
 }
 
 /* GenerateRandomData */
-static TEE_Result generate_random_data(void *buf, size_t blen)
+static TEE_Result generate_random_data(struct fortuna_gen *gen, void *buf,
+				       size_t blen)
 {
 	TEE_Result res;
 
-	res = generate_blocks(buf, blen / BLOCK_SIZE);
+	res = generate_blocks(gen, buf, blen / BLOCK_SIZE);
 	if (res)
 		return res;
 	if (blen % BLOCK_SIZE) {
 		uint8_t block[BLOCK_SIZE];
 		uint8_t *b = (uint8_t *)buf + ROUNDDOWN(blen, BLOCK_SIZE);
 
-		res = generate_blocks(block, 1);
+		res = generate_blocks(gen, block, 1);
 		if (res)
 			return res;
 		memcpy(b, block, blen % BLOCK_SIZE);
@@ -459,58 +514,154 @@ static TEE_Result maybe_reseed(void)
 		if (res)
 			return res;
 	}
-	res = hash_final(state.reseed_ctx, pool_digest);
+	res = hash_final(state.reseed_ctx, state.seed);
 	if (res)
 		return res;
 
-	crypto_cipher_final(state.ctx);
-	res = crypto_cipher_init(state.ctx, TEE_MODE_ENCRYPT,
-				 pool_digest, KEY_SIZE, NULL, 0, NULL, 0);
-	if (res)
-		return res;
-	inc_counter(state.counter);
+	/* The generators pick up the new seed on their next read */
+	atomic_store_uint(&state.seed_gen, state.seed_gen + 1);
 
 	return TEE_SUCCESS;
 }
 
-static TEE_Result fortuna_read(void *buf, size_t blen)
+/*
+ * Keys @gen from its own output, the core number and the last seed of the
+ * pools, the counter goes on.
+ */
+static TEE_Result reseed_gen(struct fortuna_gen *gen, uint32_t core)
 {
-	TEE_Result res;
+	uint8_t prev[KEY_SIZE] = { };
+	uint8_t key[KEY_SIZE] = { };
+	TEE_Result res = TEE_SUCCESS;
+	bool keyed = gen->seed_gen;
 
-	if (!state.ctx)
-		return TEE_ERROR_BAD_STATE;
+	if (keyed) {
+		res = generate_blocks(gen, prev, KEY_SIZE / BLOCK_SIZE);
+		if (res)
+			return res;
+	}
 
 	mutex_lock(&state_mu);
+	res = hash_init(state.reseed_ctx);
+	if (!res)
+		res = hash_update(state.reseed_ctx, prev, sizeof(prev));
+	if (!res)
+		res = hash_update(state.reseed_ctx, &core, sizeof(core));
+	if (!res)
+		res = hash_update(state.reseed_ctx, state.seed, KEY_SIZE);
+	if (!res)
+		res = hash_final(state.reseed_ctx, key);
+	gen->seed_gen = state.seed_gen;
+	mutex_unlock(&state_mu);
+	if (res)
+		goto out;
+
+	if (keyed)
+		crypto_cipher_final(gen->ctx);
+	res = cipher_init(gen->ctx, key);
+	inc_counter(gen->counter);
+out:
+	memzero_explicit(prev, sizeof(prev));
+	memzero_explicit(key, sizeof(key));
+	return res;
+}
+
+/*
+ * Feeds the queued events to the pools and reseeds if needed. Skipped if
+ * another thread holds the pools, the queued events are then left to the
+ * next reader.
+ */
+static TEE_Result maybe_update_pools(void)
+{
+	TEE_Result res = TEE_SUCCESS;
+
+	if (atomic_load_uint(&state.pool0_length) < MIN_POOL_SIZE &&
+	    ring_buffer_empty())
+		return TEE_SUCCESS;
+
+	if (!mutex_trylock(&state_mu))
+		return TEE_SUCCESS;
 
 	res = maybe_reseed();
+	if (!res)
+		res = drain_ring_buffer();
+	mutex_unlock(&state_mu);
+
+	return res;
+}
+
+static struct fortuna_gen *lock_gen(uint32_t *core)
+{
+	uint32_t exceptions = thread_mask_exceptions(THREAD_EXCP_FOREIGN_INTR);
+	struct fortuna_gen *gen = NULL;
+
+	/* The thread may move to another core, the mutex keeps it safe */
+	*core = get_core_pos();
+	thread_unmask_exceptions(exceptions);
+
+	gen = gens + *core;
+	if (!mutex_trylock(&gen->mu)) {
+		atomic_inc32(&gen_contention);
+		mutex_lock(&gen->mu);
+	}
+
+	return gen;
+}
+
+static TEE_Result fortuna_read(void *buf, size_t blen)
+{
+	struct fortuna_gen *gen = NULL;
+	TEE_Result res = TEE_SUCCESS;
+	uint32_t core = 0;
+
+	if (!atomic_load_uint(&state.seed_gen) ||
+	    atomic_load_uint(&state.failed))
+		return TEE_ERROR_BAD_STATE;
+
+	gen = lock_gen(&core);
+
+	res = maybe_update_pools();
 	if (res)
 		goto out;
 
+	if (gen->seed_gen != atomic_load_uint(&state.seed_gen)) {
+		res = reseed_gen(gen, core);
+		if (res)
+			goto out;
+	}
+
 	if (blen) {
 		uint8_t new_key[KEY_SIZE];
 
-		res = generate_random_data(buf, blen);
+		res = generate_random_data(gen, buf, blen);
 		if (res)
 			goto out;
 
-		res = generate_blocks(new_key, KEY_SIZE / BLOCK_SIZE);
-		if (res)
-			goto out;
-		crypto_cipher_final(state.ctx);
-		res = cipher_init(state.ctx, new_key);
+		res = generate_blocks(gen, new_key, KEY_SIZE / BLOCK_SIZE);
 		if (res)
 			goto out;
+		crypto_cipher_final(gen->ctx);
+		res = cipher_init(gen->ctx, new_key);
+		memzero_explicit(new_key, sizeof(new_key));
 	}
 
-	res = drain_ring_buffer();
 out:
+	/*
+	 * Other cores may be using the shared state, mark it as failed
+	 * instead of freeing it.
+	 */
 	if (res)
-		fortuna_done();
-	mutex_unlock(&state_mu);
+		atomic_store_uint(&state.failed, 1);
+	mutex_unlock(&gen->mu);
 
 	return res;
 }
 
+uint32_t crypto_rng_get_contention(void)
+{
+	return atomic_load_uint(&gen_contention);
+}
+
 TEE_Result crypto_rng_read(void *buf, size_t blen)
 {
 	size_t offs = 0;
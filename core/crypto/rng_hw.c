@@ -34,3 +34,7 @@ TEE_Result __weak crypto_rng_read(void *buf, size_t blen)
 	return TEE_SUCCESS;
 }
 
+uint32_t __weak crypto_rng_get_contention(void)
+{
+	return 0;
+}
@@ -0,0 +1,167 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2022, Microchip
+ */
+
+#include <crypto/crypto.h>
+#include <crypto/crypto_accel.h>
+#include <io.h>
+#include <string.h>
+#include <tee_api_types.h>
+#include <types_ext.h>
+#include <util.h>
+
+#define SHA256_BLOCK_SIZE	64
+
+static const uint32_t sha256_iv[8] = {
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+	0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+/*
+ * Copies the trailing partial block of the @len bytes long message at
+ * @data into @buf and appends the padding. Returns the number of blocks,
+ * one or two, in @buf.
+ */
+static size_t pad_tail(uint8_t buf[2 * SHA256_BLOCK_SIZE],
+		       const uint8_t *data, size_t len)
+{
+	size_t r = len % SHA256_BLOCK_SIZE;
+	size_t num_blocks = 1;
+
+	if (r >= SHA256_BLOCK_SIZE - sizeof(uint64_t))
+		num_blocks = 2;
+
+	memset(buf, 0, num_blocks * SHA256_BLOCK_SIZE);
+	if (r)
+		memcpy(buf, data + len - r, r);
+	buf[r] = 0x80;
+	put_be64(buf + num_blocks * SHA256_BLOCK_SIZE - sizeof(uint64_t),
+		 (uint64_t)len * 8);
+
+	return num_blocks;
+}
+
+#define LANES	CRYPTO_ACCEL_SHA256_MB_LANES
+
+/*
+ * struct mb_lane - a message being hashed in one lane
+ * @msg:	the message, NULL if the lane is idle
+ * @src:	next block to compress
+ * @num_blocks:	number of blocks left at @src
+ * @tail_blocks: number of blocks in @tail left once @num_blocks is done
+ * @tail:	trailing partial block with padding
+ */
+struct mb_lane {
+	struct hash_sha256_mb_msg *msg;
+	const uint8_t *src;
+	size_t num_blocks;
+	size_t tail_blocks;
+	uint8_t tail[2 * SHA256_BLOCK_SIZE];
+};
+
+static void lane_start(struct mb_lane *lane, uint32_t state[8][LANES],
+		       size_t l, struct hash_sha256_mb_msg *msg)
+{
+	size_t n = 0;
+
+	lane->msg = msg;
+	lane->src = msg->data;
+	lane->num_blocks = msg->len / SHA256_BLOCK_SIZE;
+	lane->tail_blocks = pad_tail(lane->tail, msg->data, msg->len);
+	if (!lane->num_blocks) {
+		lane->src = lane->tail;
+		lane->num_blocks = lane->tail_blocks;
+		lane->tail_blocks = 0;
+	}
+
+	for (n = 0; n < ARRAY_SIZE(sha256_iv); n++)
+		state[n][l] = sha256_iv[n];
+}
+
+/* Returns true when the message in @lane is completely compressed */
+static bool lane_advance(struct mb_lane *lane, size_t num_blocks)
+{
+	lane->src += num_blocks * SHA256_BLOCK_SIZE;
+	lane->num_blocks -= num_blocks;
+	if (lane->num_blocks)
+		return false;
+	if (!lane->tail_blocks)
+		return true;
+
+	lane->src = lane->tail;
+	lane->num_blocks = lane->tail_blocks;
+	lane->tail_blocks = 0;
+	return false;
+}
+
+static void lane_finish(struct mb_lane *lane, uint32_t state[8][LANES],
+			size_t l)
+{
+	size_t n = 0;
+
+	for (n = 0; n < ARRAY_SIZE(sha256_iv); n++)
+		put_be32(lane->msg->digest + n * sizeof(uint32_t),
+			 state[n][l]);
+	lane->msg = NULL;
+}
+
+/*
+ * Each lane hashes one message at a time. All lanes are advanced by the
+ * number of blocks left in the lane closest to a boundary, that is, the
+ * end of the message body or the padding. A lane which has completed
+ * its message is refilled with the next one so all lanes are kept busy
+ * until the last messages are processed.
+ */
+TEE_Result hash_sha256_mb_compute(struct hash_sha256_mb_msg *msgs,
+				  size_t count)
+{
+	uint32_t state[8][LANES] = { };
+	struct mb_lane lanes[LANES] = { };
+	const void *src[LANES] = { };
+	size_t num_blocks = 0;
+	size_t next = 0;
+	size_t first = 0;
+	size_t l = 0;
+
+	if (count && !msgs)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	for (l = 0; l < LANES && next < count; l++)
+		lane_start(lanes + l, state, l, msgs + next++);
+
+	while (true) {
+		num_blocks = SIZE_MAX;
+		first = LANES;
+		for (l = 0; l < LANES; l++) {
+			if (!lanes[l].msg)
+				continue;
+			if (first == LANES)
+				first = l;
+			num_blocks = MIN(num_blocks, lanes[l].num_blocks);
+			src[l] = lanes[l].src;
+		}
+		if (first == LANES)
+			break;
+
+		/* Idle lanes recompress the blocks of an active lane */
+		for (l = 0; l < LANES; l++)
+			if (!lanes[l].msg)
+				src[l] = src[first];
+
+		num_blocks = MIN(num_blocks, (size_t)UINT_MAX);
+		crypto_accel_sha256_mb_compress(state, src, num_blocks);
+
+		for (l = 0; l < LANES; l++) {
+			if (!lanes[l].msg ||
+			    !lane_advance(lanes + l, num_blocks))
+				continue;
+			lane_finish(lanes + l, state, l);
+			if (next < count)
+				lane_start(lanes + l, state, l,
+					   msgs + next++);
+		}
+	}
+
+	return TEE_SUCCESS;
+}
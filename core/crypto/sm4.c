@@ -14,6 +14,7 @@
 
 #include "sm4.h"
 #include <assert.h>
+#include <crypto/crypto_accel.h>
 #include <string.h>
 
 #define GET_UINT32_BE(n, b, i)				\
@@ -99,6 +100,7 @@ static uint8_t sm4Sbox(uint8_t inch)
 	return tab[inch];
 }
 
+#ifndef CFG_CORE_CRYPTO_SM4_ACCEL
 static uint32_t sm4Lt(uint32_t ka)
 {
 	uint32_t bb = 0;
@@ -120,6 +122,7 @@ static uint32_t sm4F(uint32_t x0, uint32_t x1, uint32_t x2, uint32_t x3,
 {
 	return x0 ^ sm4Lt(x1 ^ x2 ^ x3 ^ rk);
 }
+#endif /*!CFG_CORE_CRYPTO_SM4_ACCEL*/
 
 static uint32_t sm4CalciRK(uint32_t ka)
 {
@@ -160,6 +163,7 @@ static void sm4_setkey(uint32_t SK[32], const uint8_t key[16])
 	}
 }
 
+#ifndef CFG_CORE_CRYPTO_SM4_ACCEL
 static void sm4_one_round(uint32_t sk[32], const uint8_t input[16],
 			  uint8_t output[16])
 {
@@ -182,6 +186,7 @@ static void sm4_one_round(uint32_t sk[32], const uint8_t input[16],
 	PUT_UINT32_BE(ulbuf[33], output, 8);
 	PUT_UINT32_BE(ulbuf[32], output, 12);
 }
+#endif /*!CFG_CORE_CRYPTO_SM4_ACCEL*/
 
 void sm4_setkey_enc(struct sm4_context *ctx, const uint8_t key[16])
 {
@@ -200,6 +205,36 @@ void sm4_setkey_dec(struct sm4_context *ctx, const uint8_t key[16])
 		SWAP(ctx->sk[i], ctx->sk[31 - i]);
 }
 
+#ifdef CFG_CORE_CRYPTO_SM4_ACCEL
+void sm4_crypt_ecb(struct sm4_context *ctx, size_t length, const uint8_t *input,
+		   uint8_t *output)
+{
+	assert(!(length % 16));
+
+	crypto_accel_sm4_ecb(output, input, ctx->sk, length / 16);
+}
+
+void sm4_crypt_cbc(struct sm4_context *ctx, size_t length, uint8_t iv[16],
+		   const uint8_t *input, uint8_t *output)
+{
+	assert(!(length % 16));
+
+	if (ctx->mode == SM4_ENCRYPT)
+		crypto_accel_sm4_cbc_enc(output, input, ctx->sk, length / 16,
+					 iv);
+	else
+		crypto_accel_sm4_cbc_dec(output, input, ctx->sk, length / 16,
+					 iv);
+}
+
+void sm4_crypt_ctr(struct sm4_context *ctx, size_t length, uint8_t ctr[16],
+		   const uint8_t *input, uint8_t *output)
+{
+	assert(!(length % 16));
+
+	crypto_accel_sm4_ctr_be_enc(output, input, ctx->sk, length / 16, ctr);
+}
+#else /*!CFG_CORE_CRYPTO_SM4_ACCEL*/
 void sm4_crypt_ecb(struct sm4_context *ctx, size_t length, const uint8_t *input,
 		   uint8_t *output)
 {
@@ -268,3 +303,4 @@ void sm4_crypt_ctr(struct sm4_context *ctx, size_t length, uint8_t ctr[16],
 		length -= 16;
 	}
 }
+#endif /*!CFG_CORE_CRYPTO_SM4_ACCEL*/
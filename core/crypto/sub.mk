@@ -2,7 +2,7 @@ srcs-y += crypto.c
 
 ifeq (y-y,$(CFG_CRYPTO_AES)-$(CFG_CRYPTO_GCM))
 srcs-y += aes-gcm.c
-ifneq ($(CFG_CRYPTO_WITH_CE),y)
+ifeq (,$(filter y,$(CFG_CRYPTO_WITH_CE) $(CFG_CRYPTO_AES_ARM_NEON)))
 srcs-y += aes-gcm-sw.c
 ifeq ($(CFG_AES_GCM_TABLE_BASED),y)
 srcs-y += aes-gcm-ghash-tbl.c
@@ -10,6 +10,7 @@ endif
 endif
 endif
 
+srcs-$(CFG_CORE_CRYPTO_SHA256_MB_ACCEL) += sha256-mb.c
 srcs-$(CFG_WITH_USER_TA) += signed_hdr.c
 
 ifeq ($(CFG_WITH_SOFTWARE_PRNG),y)
@@ -408,7 +408,7 @@ void caam_jr_cancel(uint32_t job_id)
 			jr_privdata->callers[idx].pdesc = 0;
 			jr_privdata->callers[idx].jobctx = NULL;
 			jr_privdata->callers[idx].job_id = JR_JOB_FREE;
-			return;
+			break;
 		}
 	}
 
@@ -9,6 +9,7 @@
 #include <crypto/crypto_impl.h>
 #include <drvcrypt.h>
 #include <drvcrypt_cipher.h>
+#include <drvcrypt_dispatch.h>
 #include <kernel/panic.h>
 #include <malloc.h>
 #include <utee_defines.h>
@@ -169,8 +170,14 @@ static const struct crypto_cipher_ops cipher_ops = {
 	.copy_state = cipher_copy_state,
 };
 
-TEE_Result drvcrypt_cipher_alloc_ctx(struct crypto_cipher_ctx **ctx,
-				     uint32_t algo)
+/*
+ * Allocate a cipher context of the crypto driver
+ *
+ * @ctx    [out] Reference the API context pointer
+ * @algo   Cipher algorithm
+ */
+static TEE_Result hw_cipher_alloc_ctx(struct crypto_cipher_ctx **ctx,
+				      uint32_t algo)
 {
 	TEE_Result ret = TEE_ERROR_NOT_IMPLEMENTED;
 	struct crypto_cipher *cipher = NULL;
@@ -198,3 +205,10 @@ TEE_Result drvcrypt_cipher_alloc_ctx(struct crypto_cipher_ctx **ctx,
 
 	return ret;
 }
+
+TEE_Result drvcrypt_cipher_alloc_ctx(struct crypto_cipher_ctx **ctx,
+				     uint32_t algo)
+{
+	return drvcrypt_dispatch_cipher_alloc_ctx(ctx, algo,
+						  hw_cipher_alloc_ctx);
+}
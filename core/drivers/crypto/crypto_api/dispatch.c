@@ -0,0 +1,668 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2022, Microchip
+ *
+ * Brief   Dispatch of the hash and cipher requests between the crypto
+ *         driver and the software implementation.
+ *
+ * A dispatch context holds both a crypto driver context and a software
+ * context. The first update of a message selects the crypto driver if the
+ * update is at least as large as the threshold of the class of algorithms
+ * and if the crypto driver isn't already processing
+ * CFG_CRYPTO_DRV_DISPATCH_DEPTH requests, otherwise the software context
+ * is selected. Only the selected context is initialized, so a small
+ * request doesn't pay for the setup of the crypto driver. The threshold
+ * is the smallest request size for which the crypto driver was measured
+ * to be faster than the software at boot.
+ */
+#include <arm.h>
+#include <assert.h>
+#include <atomic.h>
+#include <crypto/crypto.h>
+#include <crypto/crypto_impl.h>
+#include <drvcrypt.h>
+#include <drvcrypt_dispatch.h>
+#include <initcall.h>
+#include <malloc.h>
+#include <string.h>
+#include <string_ext.h>
+#include <utee_defines.h>
+#include <util.h>
+
+/* Number of measures of a request size, the fastest one is kept */
+#define CALIB_RUNS	3
+#define CALIB_MIN_SIZE	64
+#define CALIB_MAX_SIZE	(16 * 1024)
+
+enum dispatch_class_id {
+	DISPATCH_HASH,
+	DISPATCH_CIPHER,
+	DISPATCH_NB_CLASSES
+};
+
+/*
+ * struct dispatch_class - dispatch state of a class of algorithms
+ * @name:	 name of the class
+ * @threshold:	 smallest request size processed by the crypto driver
+ * @depth:	 number of requests being processed by the crypto driver
+ * @calibrated:	 true if @threshold has been calibrated
+ * @hw_requests: number of requests processed by the crypto driver
+ * @sw_requests: number of requests processed in software
+ */
+struct dispatch_class {
+	const char *name;
+	size_t threshold;
+	uint32_t depth;
+	bool calibrated;
+	uint32_t hw_requests;
+	uint32_t sw_requests;
+};
+
+static struct dispatch_class classes[DISPATCH_NB_CLASSES] = {
+	[DISPATCH_HASH] = { .name = "hash" },
+	[DISPATCH_CIPHER] = { .name = "cipher" },
+};
+
+/*
+ * Returns true if a request of @len bytes must be processed by the crypto
+ * driver. The request is then accounted in the depth of @cls, hw_exit()
+ * must be called once it's done.
+ *
+ * @cls   Class of the algorithm
+ * @len   Size of the request
+ */
+static bool select_hw(struct dispatch_class *cls, size_t len)
+{
+	uint32_t depth = 0;
+
+	if (len >= cls->threshold) {
+		depth = atomic_load_u32(&cls->depth);
+		while (depth < CFG_CRYPTO_DRV_DISPATCH_DEPTH) {
+			if (atomic_cas_u32(&cls->depth, &depth, depth + 1)) {
+				atomic_inc32(&cls->hw_requests);
+				return true;
+			}
+		}
+	}
+
+	atomic_inc32(&cls->sw_requests);
+	return false;
+}
+
+static void hw_enter(struct dispatch_class *cls)
+{
+	atomic_inc32(&cls->depth);
+}
+
+static void hw_exit(struct dispatch_class *cls)
+{
+	atomic_dec32(&cls->depth);
+}
+
+static uint64_t min_u64(uint64_t a, uint64_t b)
+{
+	return a < b ? a : b;
+}
+
+/*
+ * Sets the threshold of @cls to the smallest request size for which
+ * @measure() of the crypto driver context @hw is faster than the one of the
+ * software context @sw. The driver is never used if it isn't faster for
+ * any request size.
+ *
+ * @cls      Class of the algorithms
+ * @measure  Measure the time in counter ticks to process @len bytes
+ * @hw       Crypto driver context
+ * @sw       Software context
+ */
+static void calibrate(struct dispatch_class *cls,
+		      uint64_t (*measure)(void *ctx, size_t len), void *hw,
+		      void *sw)
+{
+	uint64_t hw_time = 0;
+	uint64_t sw_time = 0;
+	size_t len = 0;
+	size_t n = 0;
+
+	for (len = CALIB_MIN_SIZE; len <= CALIB_MAX_SIZE; len *= 2) {
+		hw_time = UINT64_MAX;
+		sw_time = UINT64_MAX;
+		for (n = 0; n < CALIB_RUNS; n++) {
+			hw_time = min_u64(hw_time, measure(hw, len));
+			sw_time = min_u64(sw_time, measure(sw, len));
+		}
+
+		CRYPTO_TRACE("Dispatch %s %zu bytes: hw %" PRIu64
+			     " sw %" PRIu64, cls->name, len, hw_time, sw_time);
+
+		if (hw_time == UINT64_MAX)
+			return;
+		if (hw_time <= sw_time)
+			break;
+	}
+
+	if (len > CALIB_MAX_SIZE)
+		cls->threshold = SIZE_MAX;
+	else if (len == CALIB_MIN_SIZE)
+		cls->threshold = 0;
+	else
+		cls->threshold = len;
+	cls->calibrated = true;
+
+	IMSG("Crypto driver %s threshold: %zu bytes", cls->name,
+	     cls->threshold);
+}
+
+/* Input and output of the calibration requests */
+static uint8_t *calib_buf;
+
+#ifdef CFG_CRYPTO_DRV_HASH
+/*
+ * struct dispatch_hash - dispatching hash context
+ * @hash_ctx:	crypto API context
+ * @hw:		crypto driver context
+ * @sw:		software context
+ * @sel:	context processing the current message, NULL until selected
+ */
+struct dispatch_hash {
+	struct crypto_hash_ctx hash_ctx;
+	struct crypto_hash_ctx *hw;
+	struct crypto_hash_ctx *sw;
+	struct crypto_hash_ctx *sel;
+};
+
+static const struct crypto_hash_ops dispatch_hash_ops;
+
+static struct dispatch_hash *to_dispatch_hash(struct crypto_hash_ctx *ctx)
+{
+	assert(ctx && ctx->ops == &dispatch_hash_ops);
+
+	return container_of(ctx, struct dispatch_hash, hash_ctx);
+}
+
+static void hash_exit(struct dispatch_hash *h)
+{
+	if (h->sel == h->hw)
+		hw_exit(classes + DISPATCH_HASH);
+}
+
+/*
+ * Selects and initializes the context processing the message on its first
+ * update of @len bytes. If the crypto driver processes the message, it's
+ * accounted as busy until hash_exit().
+ */
+static TEE_Result hash_enter(struct dispatch_hash *h, size_t len)
+{
+	TEE_Result res = TEE_ERROR_GENERIC;
+
+	if (h->sel) {
+		if (h->sel == h->hw)
+			hw_enter(classes + DISPATCH_HASH);
+		return TEE_SUCCESS;
+	}
+
+	if (select_hw(classes + DISPATCH_HASH, len))
+		h->sel = h->hw;
+	else
+		h->sel = h->sw;
+
+	res = h->sel->ops->init(h->sel);
+	if (res) {
+		hash_exit(h);
+		h->sel = NULL;
+	}
+
+	return res;
+}
+
+static TEE_Result dispatch_hash_init(struct crypto_hash_ctx *ctx)
+{
+	struct dispatch_hash *h = to_dispatch_hash(ctx);
+
+	/* The context is initialized once selected */
+	h->sel = NULL;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result dispatch_hash_update(struct crypto_hash_ctx *ctx,
+				       const uint8_t *data, size_t len)
+{
+	struct dispatch_hash *h = to_dispatch_hash(ctx);
+	TEE_Result res = TEE_ERROR_GENERIC;
+
+	res = hash_enter(h, len);
+	if (res)
+		return res;
+
+	res = h->sel->ops->update(h->sel, data, len);
+	hash_exit(h);
+
+	return res;
+}
+
+static TEE_Result dispatch_hash_final(struct crypto_hash_ctx *ctx,
+				      uint8_t *digest, size_t len)
+{
+	struct dispatch_hash *h = to_dispatch_hash(ctx);
+	TEE_Result res = TEE_ERROR_GENERIC;
+
+	res = hash_enter(h, 0);
+	if (res)
+		return res;
+
+	res = h->sel->ops->final(h->sel, digest, len);
+	hash_exit(h);
+
+	return res;
+}
+
+static void dispatch_hash_free_ctx(struct crypto_hash_ctx *ctx)
+{
+	struct dispatch_hash *h = to_dispatch_hash(ctx);
+
+	h->hw->ops->free_ctx(h->hw);
+	h->sw->ops->free_ctx(h->sw);
+	free(h);
+}
+
+static void dispatch_hash_copy_state(struct crypto_hash_ctx *dst_ctx,
+				     struct crypto_hash_ctx *src_ctx)
+{
+	struct dispatch_hash *dst = to_dispatch_hash(dst_ctx);
+	struct dispatch_hash *src = to_dispatch_hash(src_ctx);
+
+	/* Only the selected context holds a state */
+	if (!src->sel)
+		dst->sel = NULL;
+	else if (src->sel == src->hw)
+		dst->sel = dst->hw;
+	else
+		dst->sel = dst->sw;
+
+	if (dst->sel)
+		dst->sel->ops->copy_state(dst->sel, src->sel);
+}
+
+static const struct crypto_hash_ops dispatch_hash_ops = {
+	.init = dispatch_hash_init,
+	.update = dispatch_hash_update,
+	.final = dispatch_hash_final,
+	.free_ctx = dispatch_hash_free_ctx,
+	.copy_state = dispatch_hash_copy_state,
+};
+
+TEE_Result drvcrypt_dispatch_hash_alloc_ctx(struct crypto_hash_ctx **ctx,
+					    uint32_t algo,
+					    hw_hash_allocate hw_alloc)
+{
+	TEE_Result res = TEE_ERROR_GENERIC;
+	struct dispatch_hash *h = NULL;
+
+	h = calloc(1, sizeof(*h));
+	if (!h)
+		return TEE_ERROR_OUT_OF_MEMORY;
+
+	res = hw_alloc(&h->hw, algo);
+	if (res)
+		goto err;
+
+	res = crypto_hash_sw_alloc_ctx(&h->sw, algo);
+	if (res == TEE_ERROR_NOT_IMPLEMENTED) {
+		/* Nothing to dispatch, only the crypto driver is available */
+		*ctx = h->hw;
+		free(h);
+		return TEE_SUCCESS;
+	}
+	if (res) {
+		h->hw->ops->free_ctx(h->hw);
+		goto err;
+	}
+
+	h->hash_ctx.ops = &dispatch_hash_ops;
+	*ctx = &h->hash_ctx;
+
+	return TEE_SUCCESS;
+err:
+	free(h);
+	return res;
+}
+
+static uint64_t measure_hash(void *ctx, size_t len)
+{
+	struct crypto_hash_ctx *c = ctx;
+	uint8_t digest[TEE_SHA256_HASH_SIZE] = { };
+	uint64_t start = barrier_read_counter_timer();
+
+	if (c->ops->init(c) || c->ops->update(c, calib_buf, len) ||
+	    c->ops->final(c, digest, sizeof(digest)))
+		return UINT64_MAX;
+
+	return barrier_read_counter_timer() - start;
+}
+
+/* SHA-256 is taken as representative of all the hash algorithms */
+static void calibrate_hash(void)
+{
+	struct crypto_hash_ctx *ctx = NULL;
+	struct dispatch_hash *h = NULL;
+
+	if (drvcrypt_hash_alloc_ctx(&ctx, TEE_ALG_SHA256))
+		return;
+
+	if (ctx->ops == &dispatch_hash_ops) {
+		h = to_dispatch_hash(ctx);
+		calibrate(classes + DISPATCH_HASH, measure_hash, h->hw, h->sw);
+	}
+	ctx->ops->free_ctx(ctx);
+}
+#else
+static void calibrate_hash(void)
+{
+}
+#endif /* CFG_CRYPTO_DRV_HASH */
+
+#ifdef CFG_CRYPTO_DRV_CIPHER
+/*
+ * struct dispatch_cipher - dispatching cipher context
+ * @cipher_ctx:	crypto API context
+ * @hw:		crypto driver context
+ * @sw:		software context
+ * @sel:	context processing the current operation, NULL until selected
+ * @mode:	operation mode, kept with the keys and IV until @sel is
+ *		initialized
+ */
+struct dispatch_cipher {
+	struct crypto_cipher_ctx cipher_ctx;
+	struct crypto_cipher_ctx *hw;
+	struct crypto_cipher_ctx *sw;
+	struct crypto_cipher_ctx *sel;
+	TEE_OperationMode mode;
+	uint8_t key1[TEE_AES_MAX_KEY_SIZE];
+	size_t key1_len;
+	uint8_t key2[TEE_AES_MAX_KEY_SIZE];
+	size_t key2_len;
+	uint8_t iv[TEE_AES_BLOCK_SIZE];
+	size_t iv_len;
+};
+
+static const struct crypto_cipher_ops dispatch_cipher_ops;
+
+static struct dispatch_cipher *
+to_dispatch_cipher(struct crypto_cipher_ctx *ctx)
+{
+	assert(ctx && ctx->ops == &dispatch_cipher_ops);
+
+	return container_of(ctx, struct dispatch_cipher, cipher_ctx);
+}
+
+static void cipher_wipe_keys(struct dispatch_cipher *c)
+{
+	memzero_explicit(c->key1, sizeof(c->key1));
+	memzero_explicit(c->key2, sizeof(c->key2));
+}
+
+static void cipher_exit(struct dispatch_cipher *c)
+{
+	if (c->sel == c->hw)
+		hw_exit(classes + DISPATCH_CIPHER);
+}
+
+/*
+ * Selects and initializes the context processing the operation on its
+ * first update of @len bytes. If the crypto driver processes the
+ * operation, it's accounted as busy until cipher_exit().
+ */
+static TEE_Result cipher_enter(struct dispatch_cipher *c, size_t len)
+{
+	TEE_Result res = TEE_ERROR_GENERIC;
+
+	if (c->sel) {
+		if (c->sel == c->hw)
+			hw_enter(classes + DISPATCH_CIPHER);
+		return TEE_SUCCESS;
+	}
+
+	if (select_hw(classes + DISPATCH_CIPHER, len))
+		c->sel = c->hw;
+	else
+		c->sel = c->sw;
+
+	res = c->sel->ops->init(c->sel, c->mode, c->key1, c->key1_len,
+				c->key2_len ? c->key2 : NULL, c->key2_len,
+				c->iv_len ? c->iv : NULL, c->iv_len);
+	if (res) {
+		cipher_exit(c);
+		c->sel = NULL;
+	} else {
+		cipher_wipe_keys(c);
+	}
+
+	return res;
+}
+
+static TEE_Result dispatch_cipher_init(struct crypto_cipher_ctx *ctx,
+				       TEE_OperationMode mode,
+				       const uint8_t *key1, size_t key1_len,
+				       const uint8_t *key2, size_t key2_len,
+				       const uint8_t *iv, size_t iv_len)
+{
+	struct dispatch_cipher *c = to_dispatch_cipher(ctx);
+
+	if (key1_len > sizeof(c->key1) || key2_len > sizeof(c->key2) ||
+	    iv_len > sizeof(c->iv))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	/* The context is initialized once selected */
+	c->sel = NULL;
+	c->mode = mode;
+	memcpy(c->key1, key1, key1_len);
+	c->key1_len = key1_len;
+	if (key2_len)
+		memcpy(c->key2, key2, key2_len);
+	c->key2_len = key2_len;
+	if (iv_len)
+		memcpy(c->iv, iv, iv_len);
+	c->iv_len = iv_len;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result dispatch_cipher_update(struct crypto_cipher_ctx *ctx,
+					 bool last_block, const uint8_t *data,
+					 size_t len, uint8_t *dst)
+{
+	struct dispatch_cipher *c = to_dispatch_cipher(ctx);
+	TEE_Result res = TEE_ERROR_GENERIC;
+
+	res = cipher_enter(c, len);
+	if (res)
+		return res;
+
+	res = c->sel->ops->update(c->sel, last_block, data, len, dst);
+	cipher_exit(c);
+
+	return res;
+}
+
+static void dispatch_cipher_final(struct crypto_cipher_ctx *ctx)
+{
+	struct dispatch_cipher *c = to_dispatch_cipher(ctx);
+
+	/* Only the selected context has been initialized */
+	if (c->sel)
+		c->sel->ops->final(c->sel);
+	cipher_wipe_keys(c);
+}
+
+static void dispatch_cipher_free_ctx(struct crypto_cipher_ctx *ctx)
+{
+	struct dispatch_cipher *c = to_dispatch_cipher(ctx);
+
+	c->hw->ops->free_ctx(c->hw);
+	c->sw->ops->free_ctx(c->sw);
+	cipher_wipe_keys(c);
+	free(c);
+}
+
+static void dispatch_cipher_copy_state(struct crypto_cipher_ctx *dst_ctx,
+				       struct crypto_cipher_ctx *src_ctx)
+{
+	struct dispatch_cipher *dst = to_dispatch_cipher(dst_ctx);
+	struct dispatch_cipher *src = to_dispatch_cipher(src_ctx);
+
+	dst->mode = src->mode;
+	memcpy(dst->key1, src->key1, sizeof(dst->key1));
+	dst->key1_len = src->key1_len;
+	memcpy(dst->key2, src->key2, sizeof(dst->key2));
+	dst->key2_len = src->key2_len;
+	memcpy(dst->iv, src->iv, sizeof(dst->iv));
+	dst->iv_len = src->iv_len;
+
+	/* Only the selected context holds a state */
+	if (!src->sel)
+		dst->sel = NULL;
+	else if (src->sel == src->hw)
+		dst->sel = dst->hw;
+	else
+		dst->sel = dst->sw;
+
+	if (dst->sel)
+		dst->sel->ops->copy_state(dst->sel, src->sel);
+}
+
+static const struct crypto_cipher_ops dispatch_cipher_ops = {
+	.init = dispatch_cipher_init,
+	.update = dispatch_cipher_update,
+	.final = dispatch_cipher_final,
+	.free_ctx = dispatch_cipher_free_ctx,
+	.copy_state = dispatch_cipher_copy_state,
+};
+
+TEE_Result drvcrypt_dispatch_cipher_alloc_ctx(struct crypto_cipher_ctx **ctx,
+					      uint32_t algo,
+					      hw_cipher_allocate hw_alloc)
+{
+	TEE_Result res = TEE_ERROR_GENERIC;
+	struct dispatch_cipher *c = NULL;
+
+	c = calloc(1, sizeof(*c));
+	if (!c)
+		return TEE_ERROR_OUT_OF_MEMORY;
+
+	res = hw_alloc(&c->hw, algo);
+	if (res)
+		goto err;
+
+	res = crypto_cipher_sw_alloc_ctx(&c->sw, algo);
+	if (res == TEE_ERROR_NOT_IMPLEMENTED) {
+		/* Nothing to dispatch, only the crypto driver is available */
+		*ctx = c->hw;
+		free(c);
+		return TEE_SUCCESS;
+	}
+	if (res) {
+		c->hw->ops->free_ctx(c->hw);
+		goto err;
+	}
+
+	c->cipher_ctx.ops = &dispatch_cipher_ops;
+	*ctx = &c->cipher_ctx;
+
+	return TEE_SUCCESS;
+err:
+	free(c);
+	return res;
+}
+
+static uint64_t measure_cipher(void *ctx, size_t len)
+{
+	static const uint8_t key[TEE_AES_BLOCK_SIZE] = { };
+	static const uint8_t iv[TEE_AES_BLOCK_SIZE] = { };
+	struct crypto_cipher_ctx *c = ctx;
+	uint64_t start = barrier_read_counter_timer();
+
+	if (c->ops->init(c, TEE_MODE_ENCRYPT, key, sizeof(key), NULL, 0, iv,
+			 sizeof(iv)) ||
+	    c->ops->update(c, true, calib_buf, len, calib_buf + len))
+		return UINT64_MAX;
+	c->ops->final(c);
+
+	return barrier_read_counter_timer() - start;
+}
+
+/* AES-128-CBC is taken as representative of all the cipher algorithms */
+static void calibrate_cipher(void)
+{
+	struct crypto_cipher_ctx *ctx = NULL;
+	struct dispatch_cipher *c = NULL;
+
+	if (drvcrypt_cipher_alloc_ctx(&ctx, TEE_ALG_AES_CBC_NOPAD))
+		return;
+
+	if (ctx->ops == &dispatch_cipher_ops) {
+		c = to_dispatch_cipher(ctx);
+		calibrate(classes + DISPATCH_CIPHER, measure_cipher, c->hw,
+			  c->sw);
+	}
+	ctx->ops->free_ctx(ctx);
+}
+#else
+static void calibrate_cipher(void)
+{
+}
+#endif /* CFG_CRYPTO_DRV_CIPHER */
+
+TEE_Result drvcrypt_dispatch_get_stats(struct drvcrypt_dispatch_report *reports,
+				       size_t *count, bool reset)
+{
+	struct dispatch_class *cls = NULL;
+	size_t n = 0;
+
+	if (*count < DISPATCH_NB_CLASSES) {
+		*count = DISPATCH_NB_CLASSES;
+		return TEE_ERROR_SHORT_BUFFER;
+	}
+
+	for (n = 0; n < DISPATCH_NB_CLASSES; n++) {
+		cls = classes + n;
+		memset(reports + n, 0, sizeof(*reports));
+		strlcpy(reports[n].name, cls->name, sizeof(reports[n].name));
+		reports[n].threshold = MIN(cls->threshold, (size_t)UINT32_MAX);
+		reports[n].max_depth = CFG_CRYPTO_DRV_DISPATCH_DEPTH;
+		reports[n].calibrated = cls->calibrated;
+		reports[n].hw_requests = atomic_load_u32(&cls->hw_requests);
+		reports[n].sw_requests = atomic_load_u32(&cls->sw_requests);
+		if (reset) {
+			atomic_store_u32(&cls->hw_requests, 0);
+			atomic_store_u32(&cls->sw_requests, 0);
+		}
+	}
+
+	*count = DISPATCH_NB_CLASSES;
+
+	return TEE_SUCCESS;
+}
+
+/*
+ * The crypto drivers register at initcall level, calibrate once they are
+ * all available.
+ */
+static TEE_Result dispatch_calibrate(void)
+{
+	calib_buf = malloc(2 * CALIB_MAX_SIZE);
+	if (!calib_buf) {
+		EMSG("Crypto driver dispatch not calibrated");
+		return TEE_SUCCESS;
+	}
+
+	calibrate_hash();
+	calibrate_cipher();
+
+	free(calib_buf);
+	calib_buf = NULL;
+
+	return TEE_SUCCESS;
+}
+
+boot_final(dispatch_calibrate);
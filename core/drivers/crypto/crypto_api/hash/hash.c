@@ -6,6 +6,7 @@
  */
 #include <assert.h>
 #include <drvcrypt.h>
+#include <drvcrypt_dispatch.h>
 #include <drvcrypt_hash.h>
 #include <utee_defines.h>
 #include <util.h>
@@ -22,7 +23,7 @@ TEE_Result drvcrypt_hash_alloc_ctx(struct crypto_hash_ctx **ctx, uint32_t algo)
 	hash_alloc = drvcrypt_get_ops(CRYPTO_HASH);
 
 	if (hash_alloc)
-		ret = hash_alloc(ctx, algo);
+		ret = drvcrypt_dispatch_hash_alloc_ctx(ctx, algo, hash_alloc);
 
 	CRYPTO_TRACE("hash alloc_ctx ret 0x%" PRIX32, ret);
 
@@ -0,0 +1,98 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2022, Microchip
+ *
+ * Brief   Dispatch of the requests between the crypto driver and the
+ *         software implementation.
+ */
+#ifndef __DRVCRYPT_DISPATCH_H__
+#define __DRVCRYPT_DISPATCH_H__
+
+#include <crypto/crypto_impl.h>
+#include <drvcrypt_hash.h>
+#include <tee_api_types.h>
+
+/*
+ * Crypto driver cipher context allocation function prototype
+ */
+typedef TEE_Result (*hw_cipher_allocate)(struct crypto_cipher_ctx **ctx,
+					 uint32_t algo);
+
+#define DRVCRYPT_DISPATCH_NAME_LEN	8
+
+/*
+ * struct drvcrypt_dispatch_report - dispatch state of a class of
+ * algorithms as reported by drvcrypt_dispatch_get_stats()
+ * @name:	 name of the class of algorithms
+ * @threshold:	 smallest request processed by the driver in bytes,
+ *		 UINT32_MAX if the driver is never used
+ * @max_depth:	 number of requests processed by the driver at the same
+ *		 time above which requests are processed in software
+ * @calibrated:	 1 if @threshold has been calibrated at boot, 0 otherwise
+ * @hw_requests: number of requests processed by the driver
+ * @sw_requests: number of requests processed in software
+ */
+struct drvcrypt_dispatch_report {
+	char name[DRVCRYPT_DISPATCH_NAME_LEN];
+	uint32_t threshold;
+	uint32_t max_depth;
+	uint32_t calibrated;
+	uint32_t hw_requests;
+	uint32_t sw_requests;
+};
+
+#ifdef CFG_CRYPTO_DRV_DISPATCH
+/*
+ * Allocate a hash context dispatching each message either to the crypto
+ * driver or to the software implementation. The choice is done on the
+ * first update of the message.
+ *
+ * @ctx       [out] Hash context
+ * @algo      Hash algorithm
+ * @hw_alloc  Crypto driver context allocation
+ */
+TEE_Result drvcrypt_dispatch_hash_alloc_ctx(struct crypto_hash_ctx **ctx,
+					    uint32_t algo,
+					    hw_hash_allocate hw_alloc);
+
+/*
+ * Allocate a cipher context dispatching each operation either to the
+ * crypto driver or to the software implementation. The choice is done on
+ * the first update following the initialization.
+ *
+ * @ctx       [out] Cipher context
+ * @algo      Cipher algorithm
+ * @hw_alloc  Crypto driver context allocation
+ */
+TEE_Result drvcrypt_dispatch_cipher_alloc_ctx(struct crypto_cipher_ctx **ctx,
+					      uint32_t algo,
+					      hw_cipher_allocate hw_alloc);
+
+/*
+ * Get the dispatch state of each class of algorithms
+ *
+ * @reports  [out] Dispatch reports
+ * @count    in: number of elements in @reports, out: number of classes
+ * @reset    If true, clear the requests counters once reported
+ *
+ * Returns TEE_ERROR_SHORT_BUFFER if @reports is too small.
+ */
+TEE_Result drvcrypt_dispatch_get_stats(struct drvcrypt_dispatch_report *reports,
+				       size_t *count, bool reset);
+#else
+static inline TEE_Result
+drvcrypt_dispatch_hash_alloc_ctx(struct crypto_hash_ctx **ctx, uint32_t algo,
+				 hw_hash_allocate hw_alloc)
+{
+	return hw_alloc(ctx, algo);
+}
+
+static inline TEE_Result
+drvcrypt_dispatch_cipher_alloc_ctx(struct crypto_cipher_ctx **ctx,
+				   uint32_t algo, hw_cipher_allocate hw_alloc)
+{
+	return hw_alloc(ctx, algo);
+}
+#endif /* CFG_CRYPTO_DRV_DISPATCH */
+
+#endif /* __DRVCRYPT_DISPATCH_H__ */
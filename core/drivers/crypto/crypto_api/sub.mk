@@ -1,4 +1,5 @@
 srcs-y += drvcrypt.c
+srcs-$(CFG_CRYPTO_DRV_DISPATCH) += dispatch.c
 
 subdirs-y += math
 
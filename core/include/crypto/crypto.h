@@ -47,6 +47,13 @@ void crypto_cipher_final(void *ctx);
 TEE_Result crypto_cipher_get_block_size(uint32_t algo, size_t *size);
 void crypto_cipher_free_ctx(void *ctx);
 void crypto_cipher_copy_state(void *dst_ctx, void *src_ctx);
+/*
+ * Restarts the operation of an initialized context with @iv, keeping its
+ * key schedule. Returns TEE_ERROR_NOT_IMPLEMENTED if the algorithm doesn't
+ * support it, the context must then be initialized again with
+ * crypto_cipher_init().
+ */
+TEE_Result crypto_cipher_set_iv(void *ctx, const uint8_t *iv, size_t iv_len);
 
 /* Message Authentication Code functions */
 TEE_Result crypto_mac_alloc_ctx(void **ctx, uint32_t algo);
@@ -116,6 +123,12 @@ struct rsa_keypair {
 	struct bignum *qp;	/* 1/q mod p */
 	struct bignum *dp;	/* d mod (p-1) */
 	struct bignum *dq;	/* d mod (q-1) */
+
+	/*
+	 * Optional crypto library precomputations for the key, released
+	 * with crypto_acipher_flush_rsa_keypair_cache()
+	 */
+	void *cache;
 };
 
 struct rsa_public_key {
@@ -192,6 +205,13 @@ TEE_Result crypto_acipher_alloc_ecc_keypair(struct ecc_keypair *s,
 					    size_t key_size_bits);
 void crypto_acipher_free_ecc_public_key(struct ecc_public_key *s);
 
+/*
+ * Releases the precomputations a crypto library may attach to the key.
+ * Must be called before any of the bignums of @s is updated, the
+ * precomputations are redone on next use.
+ */
+void crypto_acipher_flush_rsa_keypair_cache(struct rsa_keypair *s);
+
 /*
  * Key generation functions
  */
@@ -283,6 +303,38 @@ TEE_Result crypto_acipher_sm2_kep_derive(struct ecc_keypair *my_key,
 TEE_Result hash_sha256_check(const uint8_t *hash, const uint8_t *data,
 		size_t data_size);
 
+/*
+ * struct hash_sha256_mb_msg - a message for hash_sha256_mb_compute()
+ * @data:	the message
+ * @len:	length of the message in bytes
+ * @digest:	receives the TEE_SHA256_HASH_SIZE bytes digest
+ */
+struct hash_sha256_mb_msg {
+	const void *data;
+	size_t len;
+	uint8_t *digest;
+};
+
+/*
+ * Computes the SHA-256 digests of @count independent messages interleaved
+ * over the lanes of the multi-buffer implementation, which is
+ * considerably faster than hashing many short messages one by one. Like
+ * hash_sha256_check() this doesn't require crypto_init() to be called in
+ * advance. Only available with CFG_CORE_CRYPTO_SHA256_MB_ACCEL=y, callers
+ * are expected to use the regular SHA-256 functions otherwise.
+ */
+#ifdef CFG_CORE_CRYPTO_SHA256_MB_ACCEL
+TEE_Result hash_sha256_mb_compute(struct hash_sha256_mb_msg *msgs,
+				  size_t count);
+#else
+static inline TEE_Result
+hash_sha256_mb_compute(struct hash_sha256_mb_msg *msgs __unused,
+		       size_t count __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+#endif
+
 /*
  * Computes a SHA-512/256 hash, vetted conditioner as per NIST.SP.800-90B.
  * It doesn't require crypto_init() to be called in advance and has as few
@@ -343,6 +395,12 @@ void crypto_rng_add_event(enum crypto_rng_src sid, unsigned int *pnum,
  */
 TEE_Result crypto_rng_read(void *buf, size_t len);
 
+/*
+ * crypto_rng_get_contention() - number of crypto_rng_read() calls which
+ * had to wait for another reader since boot
+ */
+uint32_t crypto_rng_get_contention(void);
+
 /*
  * crypto_aes_expand_enc_key() - Expand an AES key
  * @key:	AES key buffer
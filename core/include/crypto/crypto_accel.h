@@ -40,8 +40,42 @@ void crypto_accel_aes_xts_dec(void *out, const void *in, const void *key1,
 			      unsigned int block_count, const void *key2,
 			      void *tweak);
 
+/*
+ * @rk is the SM4 key schedule, in reverse order for decryption. The
+ * counter in @iv is a 128-bit big endian number.
+ */
+void crypto_accel_sm4_ecb(void *out, const void *in, const uint32_t rk[32],
+			  unsigned int block_count);
+void crypto_accel_sm4_cbc_enc(void *out, const void *in,
+			      const uint32_t rk[32], unsigned int block_count,
+			      void *iv);
+void crypto_accel_sm4_cbc_dec(void *out, const void *in,
+			      const uint32_t rk[32], unsigned int block_count,
+			      void *iv);
+void crypto_accel_sm4_ctr_be_enc(void *out, const void *in,
+				 const uint32_t rk[32],
+				 unsigned int block_count, void *iv);
+
 void crypto_accel_sha1_compress(uint32_t state[5], const void *src,
 				unsigned int block_count);
 void crypto_accel_sha256_compress(uint32_t state[8], const void *src,
 				  unsigned int block_count);
+void crypto_accel_sha512_compress(uint64_t state[8], const void *src,
+				  unsigned int block_count);
+
+/*
+ * Number of independent messages hashed in parallel by
+ * crypto_accel_sha256_mb_compress()
+ */
+#define CRYPTO_ACCEL_SHA256_MB_LANES	4
+
+/*
+ * Compresses @block_count consecutive blocks from each of the
+ * CRYPTO_ACCEL_SHA256_MB_LANES messages in @src. Word n of the state of
+ * lane l is in @state[n][l].
+ */
+void
+crypto_accel_sha256_mb_compress(uint32_t state[8][CRYPTO_ACCEL_SHA256_MB_LANES],
+				const void *src[CRYPTO_ACCEL_SHA256_MB_LANES],
+				unsigned int block_count);
 #endif /*__CRYPTO_CRYPTO_ACCEL_H*/
@@ -163,6 +163,9 @@ struct crypto_cipher_ops {
 	void (*free_ctx)(struct crypto_cipher_ctx *ctx);
 	void (*copy_state)(struct crypto_cipher_ctx *dst_ctx,
 			   struct crypto_cipher_ctx *src_ctx);
+	/* Optional, restarts an initialized context with a new IV */
+	TEE_Result (*set_iv)(struct crypto_cipher_ctx *ctx, const uint8_t *iv,
+			     size_t iv_len);
 };
 
 #if defined(CFG_CRYPTO_AES) && defined(CFG_CRYPTO_ECB)
@@ -267,6 +270,16 @@ struct crypto_authenc_ops {
 TEE_Result crypto_aes_ccm_alloc_ctx(struct crypto_authenc_ctx **ctx);
 TEE_Result crypto_aes_gcm_alloc_ctx(struct crypto_authenc_ctx **ctx);
 
+/*
+ * Allocate a context of the default implementation of a hash or a cipher
+ * algorithm, that is the software one possibly using CPU extensions,
+ * regardless of the crypto drivers.
+ */
+TEE_Result crypto_hash_sw_alloc_ctx(struct crypto_hash_ctx **ctx,
+				    uint32_t algo);
+TEE_Result crypto_cipher_sw_alloc_ctx(struct crypto_cipher_ctx **ctx,
+				      uint32_t algo);
+
 #ifdef CFG_CRYPTO_DRV_HASH
 TEE_Result drvcrypt_hash_alloc_ctx(struct crypto_hash_ctx **ctx, uint32_t algo);
 #else
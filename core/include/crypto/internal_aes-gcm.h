@@ -12,7 +12,7 @@
 #include <utee_defines.h>
 #include <util.h>
 
-#ifdef CFG_CRYPTO_WITH_CE
+#if defined(CFG_CRYPTO_WITH_CE) || defined(CFG_CRYPTO_AES_ARM_NEON)
 #include <crypto/ghash-ce-core.h>
 #else
 struct internal_ghash_key {
@@ -113,7 +113,8 @@ void internal_aes_gcm_ghash_mult_tbl(struct internal_ghash_key *ghash_key,
 #endif
 
 /*
- * Must be implemented in core/arch/arm/crypto/ if CFG_CRYPTO_WITH_CE=y
+ * Must be implemented in core/arch/arm/crypto/ if CFG_CRYPTO_WITH_CE=y or
+ * CFG_CRYPTO_AES_ARM_NEON=y
  */
 void internal_aes_gcm_set_key(struct internal_aes_gcm_state *state,
 			      const struct internal_aes_gcm_key *enc_key);
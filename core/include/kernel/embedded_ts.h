@@ -8,18 +8,43 @@
 
 #include <compiler.h>
 #include <kernel/linker.h>
+#include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 #include <tee_api_types.h>
 #include <util.h>
 
+/*
+ * When @page_offs is set the TS is compressed one page at a time, see
+ * fobj_ro_lz4_paged_alloc(): @page_offs has one entry per page plus one
+ * and @page_hashes holds the SHA-256 of each uncompressed page, the last
+ * page being padded with zeroes. Else @ts is compressed with zlib if
+ * @uncompressed_size isn't 0.
+ */
 struct embedded_ts {
 	uint32_t flags;
 	TEE_UUID uuid;
 	uint32_t size;
 	uint32_t uncompressed_size; /* 0: not compressed */
 	const uint8_t *ts; /* @size bytes */
+	const uint32_t *page_offs; /* NULL: not compressed page by page */
+	const uint8_t *page_hashes;
+};
+
+/*
+ * struct emb_ts_inflate_stats - time spent inflating compressed embedded
+ *				  TSes (early TAs and secure partitions)
+ * @count:	Number of compressed TSes loaded
+ * @bytes:	Number of bytes inflated
+ * @usecs:	Usecs spent inflating
+ */
+struct emb_ts_inflate_stats {
+	uint64_t count;
+	uint64_t bytes;
+	uint64_t usecs;
 };
 
+struct fobj;
 struct ts_store_handle;
 
 TEE_Result emb_ts_read(struct ts_store_handle *h, void *data, size_t len);
@@ -32,5 +57,41 @@ TEE_Result emb_ts_open(const TEE_UUID *uuid,
 TEE_Result emb_ts_get_size(const struct ts_store_handle *h, size_t *size);
 TEE_Result emb_ts_get_tag(const struct ts_store_handle *h,
 			  uint8_t *tag, unsigned int *tag_len);
+
+#ifdef CFG_EARLY_TA_PAGED
+/*
+ * emb_ts_get_paged_fobj() - Get a read-only fobj loading pages of a TS
+ *			     compressed page by page on demand
+ * @h:		TS handle
+ * @page_offs:	First page of the TS covered by the fobj
+ * @num_pages:	Number of pages covered by the fobj
+ * @fobj:	Returned fobj
+ *
+ * The compressed TS is copied to secure DDR the first time, the pager
+ * can't read it where it's embedded in the pageable part of the TEE core.
+ *
+ * Returns TEE_ERROR_NOT_SUPPORTED if the TS isn't compressed page by page.
+ */
+TEE_Result emb_ts_get_paged_fobj(struct ts_store_handle *h,
+				 unsigned int page_offs,
+				 unsigned int num_pages, struct fobj **fobj);
+#endif
+
+#if defined(CFG_EMBEDDED_TS) && defined(CFG_TA_LOAD_STATS)
+/*
+ * emb_ts_get_inflate_stats() - Get the inflate statistics of the
+ *				 compressed TSes loaded so far
+ * @stats:	Returned statistics
+ * @reset:	If true, clear the statistics once reported
+ */
+void emb_ts_get_inflate_stats(struct emb_ts_inflate_stats *stats, bool reset);
+#else
+static inline void
+emb_ts_get_inflate_stats(struct emb_ts_inflate_stats *stats,
+			 bool reset __unused)
+{
+	memset(stats, 0, sizeof(*stats));
+}
+#endif
 #endif /* KERNEL_EMBEDDED_TS_H */
 
@@ -0,0 +1,48 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2022, Microchip
+ */
+#ifndef KERNEL_REE_FS_TA_H
+#define KERNEL_REE_FS_TA_H
+
+#include <compiler.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * struct ree_fs_ta_load_stats - time spent loading TAs from REE FS
+ * @count:	Number of TA binaries loaded
+ * @rpc:	Usecs fetching the binaries from tee-supplicant
+ * @verify:	Usecs verifying the signature of the headers
+ * @decrypt:	Usecs decrypting encrypted binaries
+ * @copy:	Usecs copying plain binaries out of shared memory
+ * @hash:	Usecs hashing the binaries
+ */
+struct ree_fs_ta_load_stats {
+	uint64_t count;
+	uint64_t rpc;
+	uint64_t verify;
+	uint64_t decrypt;
+	uint64_t copy;
+	uint64_t hash;
+};
+
+#if defined(CFG_REE_FS_TA) && defined(CFG_TA_LOAD_STATS)
+/*
+ * ree_fs_ta_get_load_stats() - Get the time spent in each phase of the
+ *				 TA binaries loaded so far
+ * @stats:	Returned statistics
+ * @reset:	If true, clear the statistics once reported
+ */
+void ree_fs_ta_get_load_stats(struct ree_fs_ta_load_stats *stats, bool reset);
+#else
+static inline void
+ree_fs_ta_get_load_stats(struct ree_fs_ta_load_stats *stats,
+			 bool reset __unused)
+{
+	memset(stats, 0, sizeof(*stats));
+}
+#endif
+
+#endif /* KERNEL_REE_FS_TA_H */
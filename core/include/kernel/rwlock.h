@@ -0,0 +1,61 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2022, Microchip
+ */
+#ifndef KERNEL_RWLOCK_H
+#define KERNEL_RWLOCK_H
+
+#include <kernel/mutex.h>
+#include <kernel/wait_queue.h>
+#include <types_ext.h>
+
+/*
+ * Size used to keep the per-core reader counters on separate cache
+ * lines. 64 bytes covers the L1 data cache line of all supported cores.
+ */
+#define RWLOCK_CPU_ALIGN	64
+
+/*
+ * Reader-writer lock optimized for read-mostly data.
+ *
+ * Each core has its own reader counter so taking and releasing a read
+ * lock only touches a cache line private to the current core as long as
+ * no writer is around. A thread may be rescheduled to another core while
+ * holding a read lock, the individual counters may then become negative
+ * but their sum is always the number of active readers.
+ *
+ * Writers are serialized with @writer_mutex and have preference: once a
+ * writer has announced itself in @writer, new readers are held back in
+ * @reader_wq until the writer has released the lock while the writer
+ * waits in @writer_wq for the current readers to drain.
+ *
+ * The lock is not recursive, a thread holding a read lock must not
+ * acquire it again for reading since it would deadlock with a pending
+ * writer.
+ */
+struct rwlock {
+	struct mutex writer_mutex;
+	struct wait_queue writer_wq;
+	struct wait_queue reader_wq;
+	unsigned int spin_lock;	/* used when operating on the wait queues */
+	unsigned int writer;	/* != 0 when a writer is pending or active */
+	struct rwlock_cpu {
+		int readers;
+	} __aligned(RWLOCK_CPU_ALIGN) cpu[CFG_TEE_CORE_NB_CORE];
+};
+
+#define RWLOCK_INITIALIZER { .writer_mutex = MUTEX_INITIALIZER, \
+			     .writer_wq = WAIT_QUEUE_INITIALIZER, \
+			     .reader_wq = WAIT_QUEUE_INITIALIZER }
+
+void rwlock_init(struct rwlock *rw);
+void rwlock_destroy(struct rwlock *rw);
+
+void rwlock_read_lock(struct rwlock *rw);
+bool rwlock_read_trylock(struct rwlock *rw);
+void rwlock_read_unlock(struct rwlock *rw);
+
+void rwlock_write_lock(struct rwlock *rw);
+void rwlock_write_unlock(struct rwlock *rw);
+
+#endif /*KERNEL_RWLOCK_H*/
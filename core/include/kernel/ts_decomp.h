@@ -0,0 +1,78 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2022, Microchip
+ */
+#ifndef KERNEL_TS_DECOMP_H
+#define KERNEL_TS_DECOMP_H
+
+#include <compiler.h>
+#include <signed_hdr.h>
+#include <tee_api_types.h>
+#include <types_ext.h>
+
+/*
+ * Streaming decompression of compressed TA images
+ *
+ * The compressed image is pulled through a callback as decompressed data
+ * is read, so a TA store can decrypt and hash the compressed image on the
+ * way in.
+ */
+
+/*
+ * ts_decomp_read_in_t - Read compressed data
+ * @ctx:	Context passed to ts_decomp_alloc()
+ * @buf:	Buffer receiving the data
+ * @len:	Number of bytes to read, never more than what's left of the
+ *		@in_size bytes passed to ts_decomp_alloc()
+ */
+typedef TEE_Result (*ts_decomp_read_in_t)(void *ctx, void *buf, size_t len);
+
+struct ts_decomp;
+
+#ifdef CFG_TA_COMPRESSION
+/*
+ * ts_decomp_alloc() - Allocate a decompression context
+ * @chdr:	Compression header of the image
+ * @in_size:	Size of the compressed image
+ * @read_in:	Callback reading the compressed image
+ * @ctx:	Context passed to @read_in
+ * @decomp:	Returned decompression context
+ */
+TEE_Result ts_decomp_alloc(const struct shdr_compressed_ta *chdr,
+			   size_t in_size, ts_decomp_read_in_t read_in,
+			   void *ctx, struct ts_decomp **decomp);
+
+/*
+ * ts_decomp_read() - Read decompressed data
+ * @decomp:	Decompression context
+ * @data:	Buffer receiving the data, NULL to skip the data
+ * @len:	Number of bytes to read
+ *
+ * When the last byte of the image is read, the whole compressed image
+ * must have been consumed or TEE_ERROR_BAD_FORMAT is returned.
+ */
+TEE_Result ts_decomp_read(struct ts_decomp *decomp, void *data, size_t len);
+
+void ts_decomp_free(struct ts_decomp *decomp);
+#else
+static inline TEE_Result
+ts_decomp_alloc(const struct shdr_compressed_ta *chdr __unused,
+		size_t in_size __unused, ts_decomp_read_in_t read_in __unused,
+		void *ctx __unused, struct ts_decomp **decomp __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+
+static inline TEE_Result ts_decomp_read(struct ts_decomp *decomp __unused,
+					void *data __unused,
+					size_t len __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+
+static inline void ts_decomp_free(struct ts_decomp *decomp __unused)
+{
+}
+#endif
+
+#endif /* KERNEL_TS_DECOMP_H */
@@ -8,6 +8,7 @@
 
 #include <tee_api_types.h>
 
+struct fobj;
 struct ts_store_handle;
 struct ts_store_ops {
 	/*
@@ -46,6 +47,18 @@ struct ts_store_ops {
 	 */
 	TEE_Result (*read)(struct ts_store_handle *h, void *data,
 			   size_t len);
+	/*
+	 * Optional. Return a read-only fobj with @num_pages pages of the TS
+	 * starting at page @page_offs, where each page is loaded and
+	 * verified the first time it's accessed instead of being read with
+	 * read() above. Returns TEE_ERROR_NOT_SUPPORTED if the TS can't be
+	 * paged in this way, the caller then reads the pages as usual.
+	 * This doesn't affect the offset of read().
+	 */
+	TEE_Result (*get_paged_fobj)(struct ts_store_handle *h,
+				     unsigned int page_offs,
+				     unsigned int num_pages,
+				     struct fobj **fobj);
 	/*
 	 * Close a TS handle. Do nothing if @h == NULL.
 	 */
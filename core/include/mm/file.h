@@ -94,6 +94,33 @@ struct file *file_get_by_tag(const uint8_t *tag, unsigned int taglen);
  */
 void file_put(struct file *f);
 
+/*
+ * file_cache_retain() - Keep a file after its last user is gone
+ * @f:		File pointer
+ *
+ * All slices of @f must hold data that has been verified, a later
+ * file_get_by_tag() with the same tag maps them as they are. At most
+ * CFG_TA_BIN_CACHE_COUNT files are kept, the least recently retained file
+ * is released first.
+ */
+void file_cache_retain(struct file *f);
+
+/*
+ * file_cache_release() - Stop keeping a file retained by file_cache_retain()
+ * @f:		File pointer
+ *
+ * Does nothing if @f isn't retained.
+ */
+void file_cache_release(struct file *f);
+
+/*
+ * file_cache_flush() - Release all files retained by file_cache_retain()
+ *
+ * Returns true if at least one file was released, that is, if memory may
+ * have been freed.
+ */
+bool file_cache_flush(void);
+
 /*
  * file_find_slice() - Find a slice covering the @page_offset
  * @f:		 File pointer
@@ -108,6 +108,27 @@ struct fobj *fobj_ro_reloc_paged_alloc(unsigned int num_pages, void *hashes,
 				       const void *reloc,
 				       unsigned int reloc_len, void *store);
 
+/*
+ * fobj_ro_lz4_paged_alloc() - Allocate initialized read-only storage
+ *			       compressed with LZ4
+ * @num_pages:	Number of pages covered
+ * @hashes:	Hashes to verify the uncompressed pages
+ * @offs:	@num_pages + 1 offsets into @store, page n is compressed in
+ *		the LZ4 block from @offs[n] up to @offs[n + 1], or stored
+ *		as is if that's SMALL_PAGE_SIZE bytes
+ * @store:	Compressed data for all pages
+ * @store_size:	Size of @store
+ *
+ * This object is like fobj_ro_paged_alloc() above, but each page is
+ * decompressed before it's verified. @hashes, @offs and @store are not
+ * freed with the object.
+ *
+ * Returns a valid pointer on success or NULL on failure.
+ */
+struct fobj *fobj_ro_lz4_paged_alloc(unsigned int num_pages,
+				     const void *hashes, const uint32_t *offs,
+				     const void *store, size_t store_size);
+
 /*
  * fobj_load_page() - Load a page into memory
  * @fobj:	Fobj pointer
@@ -152,28 +173,28 @@ static inline vaddr_t fobj_get_iv_vaddr(struct fobj *fobj,
 }
 #endif
 
+#ifndef CFG_PAGED_USER_TA
 /*
- * fobj_ta_mem_alloc() - Allocates TA memory
+ * fobj_sec_mem_alloc() - Allocates storage directly in secure memory
  * @num_pages:	Number of pages
  *
- * If paging of user TAs read/write paged fobj is allocated otherwise a
- * fobj which uses unpaged secure memory directly.
- *
  * Returns a valid pointer on success or NULL on failure.
  */
-#ifdef CFG_PAGED_USER_TA
-#define fobj_ta_mem_alloc(num_pages)	fobj_rw_paged_alloc(num_pages)
-#else
+struct fobj *fobj_sec_mem_alloc(unsigned int num_pages);
+#endif
+
 /*
- * fobj_sec_mem_alloc() - Allocates storage directly in secure memory
+ * fobj_ta_mem_alloc() - Allocates TA memory
  * @num_pages:	Number of pages
  *
+ * If paging of user TAs read/write paged fobj is allocated otherwise a
+ * fobj which uses unpaged secure memory directly. If the allocation
+ * fails the TA binaries retained by file_cache_retain() are released
+ * and the allocation is retried once.
+ *
  * Returns a valid pointer on success or NULL on failure.
  */
-struct fobj *fobj_sec_mem_alloc(unsigned int num_pages);
-
-#define fobj_ta_mem_alloc(num_pages)	fobj_sec_mem_alloc(num_pages)
-#endif
+struct fobj *fobj_ta_mem_alloc(unsigned int num_pages);
 
 /*
  * fobj_get() - Increase fobj reference count
@@ -285,6 +285,29 @@ TEE_Result mobj_reg_shm_release_by_cookie(uint64_t cookie);
  */
 void mobj_reg_shm_unguard(struct mobj *mobj);
 
+/*
+ * struct mobj_reg_shm_stats - mapping statistics of registered shared memory
+ * @maps:		number of times pages were mapped
+ * @unmaps:		number of times pages were unmapped
+ * @reuses:		number of times a kept mapping was used again
+ * @evictions:		number of kept mappings unmapped to make room
+ * @idle_va_size:	virtual address space held by kept mappings
+ */
+struct mobj_reg_shm_stats {
+	size_t maps;
+	size_t unmaps;
+	size_t reuses;
+	size_t evictions;
+	size_t idle_va_size;
+};
+
+/*
+ * mobj_reg_shm_get_stats() - get mapping statistics
+ * @stats:	returned statistics
+ * @reset:	if true, reset the counters, @stats->idle_va_size is kept
+ */
+void mobj_reg_shm_get_stats(struct mobj_reg_shm_stats *stats, bool reset);
+
 /*
  * mapped_shm represents registered shared buffer
  * which is mapped into OPTEE va space
@@ -8,6 +8,7 @@
 
 #include <stdint.h>
 #include <sys/queue.h>
+#include <tee_api_defines.h>
 #include <util.h>
 
 #define TEE_MATTR_VALID_BLOCK		BIT(0)
@@ -107,9 +108,22 @@ struct vm_paged_region {
 TAILQ_HEAD(vm_paged_region_head, vm_paged_region);
 TAILQ_HEAD(vm_region_head, vm_region);
 
+/*
+ * Placement of a parameter mapped during the previous invoke, used to map
+ * the same memory at the same address again. @mobj is only compared
+ * against, no reference is held.
+ */
+struct vm_param_hint {
+	const struct mobj *mobj;
+	size_t offs;
+	size_t size;
+	vaddr_t va;
+};
+
 struct vm_info {
 	struct vm_region_head regions;
 	unsigned int asid;
+	struct vm_param_hint param_hint[TEE_NUM_PARAMS];
 };
 
 static inline void mattr_perm_to_str(char *str, size_t size, uint32_t attr)
@@ -14,6 +14,8 @@ enum shdr_img_type {
 	SHDR_TA = 0,
 	SHDR_BOOTSTRAP_TA = 1,
 	SHDR_ENCRYPTED_TA = 2,
+	SHDR_COMPRESSED_TA = 3,
+	SHDR_ENCRYPTED_COMPRESSED_TA = 4,
 };
 
 #define SHDR_MAGIC	0x4f545348
@@ -126,6 +128,48 @@ static inline size_t shdr_enc_get_size(const struct shdr_encrypted_ta *ehdr)
 #define SHDR_ENC_GET_TAG(x)	({ typeof(x) _x = (x); \
 				   (SHDR_ENC_GET_IV(_x) + _x->iv_size); })
 
+/**
+ * struct shdr_compressed_ta - compressed TA header
+ * @algo:		compression algorithm, defined by
+ *			enum shdr_comp_algo
+ * @uncompressed_size:	size of the image once decompressed
+ *
+ * Follows struct shdr_bootstrap_ta, and struct shdr_encrypted_ta if the
+ * image is also encrypted. The image is compressed before it's encrypted
+ * and the hash covers the compressed image.
+ */
+struct shdr_compressed_ta {
+	uint32_t algo;
+	uint32_t uncompressed_size;
+};
+
+enum shdr_comp_algo {
+	SHDR_COMP_ZLIB = 0,
+	SHDR_COMP_LZ4 = 1,
+};
+
+/*
+ * An LZ4 compressed image is split in blocks of SHDR_LZ4_BLOCK_SIZE bytes
+ * of uncompressed data, the last one may be shorter. Each block is stored
+ * as a little endian 32-bit word followed by the block data. The low bits
+ * of the word hold the size of the data. If SHDR_LZ4_BLOCK_STORED is set
+ * the data is stored as is, else it's compressed in the LZ4 block format.
+ */
+#define SHDR_LZ4_BLOCK_SIZE	(16 * 1024)
+#define SHDR_LZ4_BLOCK_STORED	BIT32(31)
+
+static inline bool shdr_img_is_encrypted(uint32_t img_type)
+{
+	return img_type == SHDR_ENCRYPTED_TA ||
+	       img_type == SHDR_ENCRYPTED_COMPRESSED_TA;
+}
+
+static inline bool shdr_img_is_compressed(uint32_t img_type)
+{
+	return img_type == SHDR_COMPRESSED_TA ||
+	       img_type == SHDR_ENCRYPTED_COMPRESSED_TA;
+}
+
 /*
  * Allocates a struct shdr large enough to hold the entire header,
  * excluding a subheader like struct shdr_bootstrap_ta.
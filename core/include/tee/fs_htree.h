@@ -27,7 +27,7 @@
 
 /* Internal struct provided to let the rpc callbacks know the size if needed */
 struct tee_fs_htree_node_image {
-	/* Note that calc_node_hash() depends on hash first in struct */
+	/* Note that get_node_hash_msg() depends on hash first in struct */
 	uint8_t hash[TEE_FS_HTREE_HASH_SIZE];
 	uint8_t iv[TEE_FS_HTREE_IV_SIZE];
 	uint8_t tag[TEE_FS_HTREE_TAG_SIZE];
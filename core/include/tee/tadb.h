@@ -7,6 +7,7 @@
 #define __TEE_TADB_H
 
 #include <tee/tee_fs.h>
+#include <util.h>
 
 struct tee_tadb_ta_write;
 struct tee_tadb_ta_read;
@@ -16,7 +17,7 @@ struct tee_tadb_ta_read;
  * @uuid:	UUID of Trusted Application (TA) or Security Domain (SD)
  * @version:	Version of TA or SD
  * @custom_size:Size of customized properties, prepended to the encrypted
- *		TA binary
+ *		TA binary, ORed with TEE_TADB_CUSTOM_* flags
  * @bin_size:	Size of the binary TA
  */
 struct tee_tadb_property {
@@ -26,6 +27,21 @@ struct tee_tadb_property {
 	uint32_t bin_size;
 };
 
+/*
+ * The customized properties are a struct shdr_compressed_ta and the TA
+ * binary is compressed. A flag in @custom_size keeps the layout of the
+ * database entries unchanged.
+ */
+#define TEE_TADB_CUSTOM_COMPRESSED	BIT32(31)
+#define TEE_TADB_CUSTOM_FLAGS		TEE_TADB_CUSTOM_COMPRESSED
+
+/* Size of the customized properties of @prop without the flags */
+static inline size_t
+tee_tadb_custom_size(const struct tee_tadb_property *prop)
+{
+	return prop->custom_size & ~TEE_TADB_CUSTOM_FLAGS;
+}
+
 struct tee_fs_rpc_operation;
 
 struct tee_tadb_file_operations {
@@ -22,6 +22,7 @@ struct tee_obj {
 	size_t ds_pos;
 	struct tee_pobj *pobj;	/* ptr to persistant object */
 	struct tee_file_handle *fh;
+	struct tee_cryp_ks *ks;	/* context initialized with the key */
 };
 
 void tee_obj_add(struct user_ta_ctx *utc, struct tee_obj *o);
@@ -36,6 +36,24 @@ TEE_Result syscall_cryp_state_copy(unsigned long dst, unsigned long src);
 TEE_Result syscall_cryp_state_free(unsigned long state);
 void tee_svc_cryp_free_states(struct user_ta_ctx *utc);
 
+/*
+ * struct tee_cryp_cache_stats - statistics of the key and context caches
+ * @ks_hits:	 initializations done by copying the context cached with the
+ *		 key object
+ * @ks_misses:	 initializations done from the key
+ * @ctx_hits:	 digest contexts taken from the pool of the TA
+ * @ctx_misses:	 digest contexts allocated
+ */
+struct tee_cryp_cache_stats {
+	uint32_t ks_hits;
+	uint32_t ks_misses;
+	uint32_t ctx_hits;
+	uint32_t ctx_misses;
+};
+
+void tee_svc_cryp_get_cache_stats(struct tee_cryp_cache_stats *stats,
+				  bool reset);
+
 /* iv and iv_len are ignored for hash algorithms */
 TEE_Result syscall_hash_init(unsigned long state, const void *iv,
 			size_t iv_len);
@@ -72,6 +90,9 @@ TEE_Result syscall_authenc_dec_final(unsigned long state,
 			const void *src_data, size_t src_len, void *dest_data,
 			uint64_t *dest_len, const void *tag, size_t tag_len);
 
+TEE_Result syscall_cryp_update_vec(struct utee_cryp_update *upd,
+			unsigned long count);
+
 TEE_Result syscall_asymm_operate(unsigned long state,
 			const struct utee_attribute *usr_params,
 			size_t num_params, const void *src_data,
@@ -38,6 +38,9 @@ REGISTER_TA_STORE(2) = {
 	.get_size = emb_ts_get_size,
 	.get_tag = emb_ts_get_tag,
 	.read = emb_ts_read,
+#ifdef CFG_EARLY_TA_PAGED
+	.get_paged_fobj = emb_ts_get_paged_fobj,
+#endif
 	.close = emb_ts_close,
 };
 
@@ -47,7 +50,11 @@ static TEE_Result early_ta_init(void)
 	char __maybe_unused msg[60] = { '\0', };
 
 	for_each_early_ta(ta) {
-		if (ta->uncompressed_size)
+		if (ta->page_offs)
+			snprintf(msg, sizeof(msg),
+				 " (paged, uncompressed %u)",
+				 ta->uncompressed_size);
+		else if (ta->uncompressed_size)
 			snprintf(msg, sizeof(msg),
 				 " (compressed, uncompressed %u)",
 				 ta->uncompressed_size);
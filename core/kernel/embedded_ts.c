@@ -3,24 +3,51 @@
  * Copyright (c) 2017, Linaro Limited
  * Copyright (c) 2020, Arm Limited.
  */
+#include <config.h>
 #include <crypto/crypto.h>
 #include <initcall.h>
 #include <kernel/embedded_ts.h>
+#include <kernel/mutex.h>
+#include <kernel/tee_time.h>
 #include <kernel/ts_store.h>
+#include <limits.h>
+#include <mm/core_memprot.h>
+#include <mm/core_mmu.h>
+#include <mm/fobj.h>
+#include <mm/tee_mm.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/queue.h>
 #include <trace.h>
 #include <utee_defines.h>
 #include <util.h>
 #include <zlib.h>
 
+#ifdef CFG_EARLY_TA_PAGED
+#include <lz4.h>
+#endif
+
 struct ts_store_handle {
 	const struct embedded_ts *ts;
 	size_t offs;
 	z_stream strm;
+	uint64_t inflate_us;
+	uint8_t *page_buf;
+	unsigned int page_idx; /* Page in @page_buf, UINT_MAX if none */
 };
 
+/* Returns the system time in usecs, 0 if the load statistics are disabled */
+static uint64_t read_us(void)
+{
+	TEE_Time t = { };
+
+	if (!IS_ENABLED(CFG_TA_LOAD_STATS) || tee_time_get_sys_time(&t))
+		return 0;
+
+	return (uint64_t)t.seconds * 1000000 + t.millis * 1000;
+}
+
 static void *zalloc(void *opaque __unused, unsigned int items,
 		    unsigned int size)
 {
@@ -50,6 +77,211 @@ static bool decompression_init(z_stream *strm,
 	return true;
 }
 
+#ifdef CFG_EARLY_TA_PAGED
+/*
+ * struct emb_ts_pages - TS compressed page by page copied out of the
+ *			 pageable part of the core
+ * @ts:		The embedded TS
+ * @data:	Copy of @ts->ts in secure DDR
+ * @offs:	Copy of @ts->page_offs on the heap
+ * @hashes:	Copy of @ts->page_hashes on the heap
+ * @link:	Link in ts_pages_head
+ *
+ * The copy is used by the fobjs returned by emb_ts_get_paged_fobj() and is
+ * kept until the next reboot. As with the hashes of the pageable part of
+ * the core, the tables are kept on the heap and only the compressed data
+ * is moved to secure DDR.
+ */
+struct emb_ts_pages {
+	const struct embedded_ts *ts;
+	uint8_t *data;
+	uint32_t *offs;
+	uint8_t *hashes;
+	SLIST_ENTRY(emb_ts_pages) link;
+};
+
+static SLIST_HEAD(emb_ts_pages_head, emb_ts_pages) ts_pages_head =
+	SLIST_HEAD_INITIALIZER(ts_pages_head);
+static struct mutex ts_pages_mu = MUTEX_INITIALIZER;
+
+static unsigned int get_num_pages(const struct embedded_ts *ts)
+{
+	return ROUNDUP_DIV(ts->uncompressed_size, SMALL_PAGE_SIZE);
+}
+
+static TEE_Result paged_init(struct ts_store_handle *h)
+{
+	const struct embedded_ts *ts = h->ts;
+	unsigned int num_pages = get_num_pages(ts);
+	unsigned int n = 0;
+	uint32_t l = 0;
+
+	if (!num_pages || ts->page_offs[0] ||
+	    ts->page_offs[num_pages] != ts->size)
+		return TEE_ERROR_BAD_FORMAT;
+	for (n = 0; n < num_pages; n++) {
+		if (SUB_OVERFLOW(ts->page_offs[n + 1], ts->page_offs[n], &l) ||
+		    !l || l > SMALL_PAGE_SIZE)
+			return TEE_ERROR_BAD_FORMAT;
+	}
+
+	h->page_buf = malloc(SMALL_PAGE_SIZE);
+	if (!h->page_buf)
+		return TEE_ERROR_OUT_OF_MEMORY;
+	h->page_idx = UINT_MAX;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result decompress_page(const struct embedded_ts *ts,
+				  unsigned int page_idx, uint8_t *dst)
+{
+	const uint8_t *src = ts->ts + ts->page_offs[page_idx];
+	size_t src_len = ts->page_offs[page_idx + 1] - ts->page_offs[page_idx];
+	size_t len = SMALL_PAGE_SIZE;
+	TEE_Result res = TEE_SUCCESS;
+
+	if (src_len == SMALL_PAGE_SIZE) {
+		memcpy(dst, src, SMALL_PAGE_SIZE);
+		return TEE_SUCCESS;
+	}
+
+	res = lz4_decompress_block(src, src_len, dst, &len);
+	if (!res && len != SMALL_PAGE_SIZE)
+		res = TEE_ERROR_BAD_FORMAT;
+
+	return res;
+}
+
+static TEE_Result read_paged(struct ts_store_handle *h, void *data,
+			     size_t len)
+{
+	TEE_Result res = TEE_SUCCESS;
+	unsigned int page_idx = 0;
+	size_t next_offs = 0;
+	uint8_t *dst = data;
+	size_t pg_offs = 0;
+	size_t n = 0;
+
+	if (ADD_OVERFLOW(h->offs, len, &next_offs) ||
+	    next_offs > h->ts->uncompressed_size)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	/* Pages are compressed independently, skipped ones are left alone */
+	if (!data) {
+		h->offs = next_offs;
+		return TEE_SUCCESS;
+	}
+
+	while (len) {
+		page_idx = h->offs / SMALL_PAGE_SIZE;
+		pg_offs = h->offs % SMALL_PAGE_SIZE;
+		if (page_idx != h->page_idx) {
+			h->page_idx = UINT_MAX;
+			res = decompress_page(h->ts, page_idx, h->page_buf);
+			if (res)
+				return res;
+			h->page_idx = page_idx;
+		}
+
+		n = MIN(len, SMALL_PAGE_SIZE - pg_offs);
+		memcpy(dst, h->page_buf + pg_offs, n);
+		dst += n;
+		len -= n;
+		h->offs += n;
+	}
+
+	return TEE_SUCCESS;
+}
+
+static struct emb_ts_pages *copy_ts_pages(const struct embedded_ts *ts)
+{
+	unsigned int num_pages = get_num_pages(ts);
+	size_t offs_size = (num_pages + 1) * sizeof(uint32_t);
+	size_t hashes_size = num_pages * TEE_SHA256_HASH_SIZE;
+	struct emb_ts_pages *p = NULL;
+	tee_mm_entry_t *mm = NULL;
+
+	p = calloc(1, sizeof(*p));
+	if (!p)
+		return NULL;
+
+	p->offs = malloc(offs_size);
+	p->hashes = malloc(hashes_size);
+	if (!p->offs || !p->hashes)
+		goto err;
+
+	mm = tee_mm_alloc(&tee_mm_sec_ddr, ts->size);
+	if (!mm)
+		goto err;
+	p->data = phys_to_virt(tee_mm_get_smem(mm), MEM_AREA_TA_RAM, ts->size);
+	if (!p->data)
+		goto err;
+
+	memcpy(p->data, ts->ts, ts->size);
+	memcpy(p->offs, ts->page_offs, offs_size);
+	memcpy(p->hashes, ts->page_hashes, hashes_size);
+	p->ts = ts;
+
+	return p;
+err:
+	tee_mm_free(mm);
+	free(p->hashes);
+	free(p->offs);
+	free(p);
+	return NULL;
+}
+
+TEE_Result emb_ts_get_paged_fobj(struct ts_store_handle *h,
+				 unsigned int page_offs,
+				 unsigned int num_pages, struct fobj **fobj)
+{
+	const struct embedded_ts *ts = h->ts;
+	struct emb_ts_pages *p = NULL;
+	unsigned int end = 0;
+	struct fobj *f = NULL;
+
+	if (!ts->page_offs)
+		return TEE_ERROR_NOT_SUPPORTED;
+	if (!num_pages || ADD_OVERFLOW(page_offs, num_pages, &end) ||
+	    end > get_num_pages(ts))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	mutex_lock(&ts_pages_mu);
+	SLIST_FOREACH(p, &ts_pages_head, link)
+		if (p->ts == ts)
+			break;
+	if (!p) {
+		p = copy_ts_pages(ts);
+		if (p)
+			SLIST_INSERT_HEAD(&ts_pages_head, p, link);
+	}
+	mutex_unlock(&ts_pages_mu);
+	if (!p)
+		return TEE_ERROR_OUT_OF_MEMORY;
+
+	f = fobj_ro_lz4_paged_alloc(num_pages, p->hashes +
+				    page_offs * TEE_SHA256_HASH_SIZE,
+				    p->offs + page_offs, p->data, ts->size);
+	if (!f)
+		return TEE_ERROR_OUT_OF_MEMORY;
+
+	*fobj = f;
+	return TEE_SUCCESS;
+}
+#else
+static TEE_Result paged_init(struct ts_store_handle *h __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+
+static TEE_Result read_paged(struct ts_store_handle *h __unused,
+			     void *data __unused, size_t len __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+#endif /*CFG_EARLY_TA_PAGED*/
+
 TEE_Result emb_ts_open(const TEE_UUID *uuid,
 		       struct ts_store_handle **h,
 		       const struct embedded_ts*
@@ -57,6 +289,7 @@ TEE_Result emb_ts_open(const TEE_UUID *uuid,
 {
 	struct ts_store_handle *handle = NULL;
 	const struct embedded_ts *ts = NULL;
+	TEE_Result res = TEE_SUCCESS;
 
 	ts = find_ts(uuid);
 	if (!ts)
@@ -66,13 +299,19 @@ TEE_Result emb_ts_open(const TEE_UUID *uuid,
 	if (!handle)
 		return TEE_ERROR_OUT_OF_MEMORY;
 
-	if (ts->uncompressed_size) {
+	handle->ts = ts;
+	if (ts->page_offs) {
+		res = paged_init(handle);
+		if (res) {
+			free(handle);
+			return res;
+		}
+	} else if (ts->uncompressed_size) {
 		if (!decompression_init(&handle->strm, ts)) {
 			free(handle);
 			return TEE_ERROR_BAD_FORMAT;
 		}
 	}
-	handle->ts = ts;
 	*h = handle;
 
 	return TEE_SUCCESS;
@@ -140,6 +379,7 @@ static TEE_Result read_compressed(struct ts_store_handle *h, void *data,
 	size_t total = 0;
 	uint8_t *tmpbuf = NULL;
 	TEE_Result ret = TEE_SUCCESS;
+	uint64_t t = 0;
 	size_t out = 0;
 	int st = Z_OK;
 
@@ -170,6 +410,7 @@ static TEE_Result read_compressed(struct ts_store_handle *h, void *data,
 	 *   buffer is full (not a "hard" error, decompression can proceeed
 	 *   later).
 	 */
+	t = read_us();
 	do {
 		out = strm->total_out;
 		st = inflate(strm, Z_SYNC_FLUSH);
@@ -185,6 +426,7 @@ static TEE_Result read_compressed(struct ts_store_handle *h, void *data,
 			strm->avail_out = MIN(len - total, 1024U);
 		}
 	} while ((st == Z_OK || st == Z_BUF_ERROR) && (total != len));
+	h->inflate_us += read_us() - t;
 
 	if (st != Z_OK && st != Z_STREAM_END) {
 		EMSG("Decompression error (%d)", st);
@@ -200,16 +442,66 @@ out:
 
 TEE_Result emb_ts_read(struct ts_store_handle *h, void *data, size_t len)
 {
+	if (h->ts->page_offs)
+		return read_paged(h, data, len);
 	if (h->ts->uncompressed_size)
 		return read_compressed(h, data, len);
 	else
 		return read_uncompressed(h, data, len);
 }
 
+#ifdef CFG_TA_LOAD_STATS
+/*
+ * struct inflate_stats - accumulated inflate statistics
+ * @count:	Number of compressed TSes loaded
+ * @bytes:	Number of bytes inflated
+ * @usecs:	Usecs spent inflating
+ */
+struct inflate_stats {
+	uint64_t count;
+	uint64_t bytes;
+	uint64_t usecs;
+};
+
+static struct mutex inflate_stats_mu = MUTEX_INITIALIZER;
+static struct inflate_stats inflate_stats;
+
+static void update_inflate_stats(struct ts_store_handle *h)
+{
+	DMSG("%pUl: inflated %lu bytes in %"PRIu64" us", &h->ts->uuid,
+	     h->strm.total_out, h->inflate_us);
+
+	mutex_lock(&inflate_stats_mu);
+	inflate_stats.count++;
+	inflate_stats.bytes += h->strm.total_out;
+	inflate_stats.usecs += h->inflate_us;
+	mutex_unlock(&inflate_stats_mu);
+}
+
+void emb_ts_get_inflate_stats(struct emb_ts_inflate_stats *stats, bool reset)
+{
+	mutex_lock(&inflate_stats_mu);
+	stats->count = inflate_stats.count;
+	stats->bytes = inflate_stats.bytes;
+	stats->usecs = inflate_stats.usecs;
+	if (reset)
+		memset(&inflate_stats, 0, sizeof(inflate_stats));
+	mutex_unlock(&inflate_stats_mu);
+}
+#else
+static void update_inflate_stats(struct ts_store_handle *h __unused)
+{
+}
+#endif
+
 void emb_ts_close(struct ts_store_handle *h)
 {
-	if (h->ts->uncompressed_size)
+	if (h->ts->page_offs) {
+		free(h->page_buf);
+	} else if (h->ts->uncompressed_size) {
+		update_inflate_stats(h);
 		inflateEnd(&h->strm);
+	}
 	free(h);
 }
 
@@ -209,6 +209,16 @@ TEE_Result ldelf_syscall_close_bin(unsigned long handle)
 		res = binh->op->read(binh->h, NULL,
 				     binh->size_bytes - binh->offs_bytes);
 
+	/*
+	 * The whole binary has now been checked against its signed hash,
+	 * the tag, so the read-only slices added while mapping it can be
+	 * kept for the next instance loading the same binary.
+	 */
+	if (res)
+		file_cache_release(binh->f);
+	else
+		file_cache_retain(binh->f);
+
 	bin_close(binh);
 	if (handle_db_is_empty(&sys_ctx->db)) {
 		handle_db_destroy(&sys_ctx->db, bin_close);
@@ -257,6 +267,28 @@ static TEE_Result binh_copy_to(struct bin_handle *binh, vaddr_t va,
 	return TEE_SUCCESS;
 }
 
+/*
+ * Gets pages of the binary which the store loads on demand, @fobj is set
+ * to NULL if they must be copied into TA memory instead.
+ */
+static TEE_Result binh_get_paged_fobj(struct bin_handle *binh,
+				      unsigned int offs_pages,
+				      unsigned int num_pages,
+				      struct fobj **fobj)
+{
+	TEE_Result res = TEE_SUCCESS;
+
+	*fobj = NULL;
+	if (!binh->op->get_paged_fobj)
+		return TEE_SUCCESS;
+
+	res = binh->op->get_paged_fobj(binh->h, offs_pages, num_pages, fobj);
+	if (res == TEE_ERROR_NOT_SUPPORTED)
+		return TEE_SUCCESS;
+
+	return res;
+}
+
 TEE_Result ldelf_syscall_map_bin(vaddr_t *va, size_t num_bytes,
 				 unsigned long handle, size_t offs_bytes,
 				 size_t pad_begin, size_t pad_end,
@@ -268,6 +300,7 @@ TEE_Result ldelf_syscall_map_bin(vaddr_t *va, size_t num_bytes,
 	struct system_ctx *sys_ctx = sess->user_ctx;
 	struct bin_handle *binh = NULL;
 	uint32_t num_rounded_bytes = 0;
+	struct fobj *paged_fobj = NULL;
 	struct file_slice *fs = NULL;
 	bool file_is_locked = false;
 	struct mobj *mobj = NULL;
@@ -326,6 +359,12 @@ TEE_Result ldelf_syscall_map_bin(vaddr_t *va, size_t num_bytes,
 	}
 	file_is_locked = true;
 	fs = file_find_slice(binh->f, offs_pages);
+	if (!fs && !(flags & LDELF_MAP_FLAG_WRITEABLE)) {
+		res = binh_get_paged_fobj(binh, offs_pages, num_pages,
+					  &paged_fobj);
+		if (res)
+			goto err;
+	}
 	if (fs) {
 		/* If there's registered slice it has to match */
 		if (fs->page_offset != offs_pages ||
@@ -351,6 +390,26 @@ TEE_Result ldelf_syscall_map_bin(vaddr_t *va, size_t num_bytes,
 		mobj_put(mobj);
 		if (res)
 			goto err;
+	} else if (paged_fobj) {
+		/*
+		 * Nothing is read here, the pager loads each page from the
+		 * store the first time it's accessed.
+		 */
+		mobj = mobj_with_fobj_alloc(paged_fobj, binh->f);
+		fobj_put(paged_fobj);
+		if (!mobj) {
+			res = TEE_ERROR_OUT_OF_MEMORY;
+			goto err;
+		}
+		res = vm_map_pad(uctx, va, num_rounded_bytes,
+				 prot, VM_FLAG_READONLY,
+				 mobj, 0, pad_begin, pad_end, 0);
+		mobj_put(mobj);
+		if (res)
+			goto err;
+		res = file_add_slice(binh->f, paged_fobj, offs_pages);
+		if (res)
+			goto err_unmap_va;
 	} else {
 		struct fobj *f = fobj_ta_mem_alloc(num_pages);
 		struct file *file = NULL;
@@ -36,9 +36,13 @@
  */
 
 #include <assert.h>
+#include <config.h>
 #include <crypto/crypto.h>
 #include <initcall.h>
+#include <kernel/ree_fs_ta.h>
+#include <kernel/tee_time.h>
 #include <kernel/thread.h>
+#include <kernel/ts_decomp.h>
 #include <kernel/ts_store.h>
 #include <mm/core_memprot.h>
 #include <mm/tee_mm.h>
@@ -55,6 +59,12 @@
 #include <tee/uuid.h>
 #include <utee_defines.h>
 
+/*
+ * Decrypted or copied data is hashed in chunks of this size right after
+ * it's written, while it's still in the data cache.
+ */
+#define REE_FS_TA_CHUNK_SIZE	(4 * 1024)
+
 struct ree_fs_ta_handle {
 	struct shdr *nw_ta; /* Non-secure (shared memory) */
 	size_t nw_ta_size;
@@ -65,6 +75,11 @@ struct ree_fs_ta_handle {
 	void *enc_ctx;
 	struct shdr_bootstrap_ta *bs_hdr;
 	struct shdr_encrypted_ta *ehdr;
+	uint8_t *scratch; /* Decrypted data that's only hashed */
+	struct ree_fs_ta_load_stats stats;
+	struct shdr_compressed_ta chdr;
+	struct ts_decomp *decomp; /* Non-NULL if the image is compressed */
+	bool checked; /* The digest of the whole image has been checked */
 };
 
 struct ta_ver_db_hdr {
@@ -75,6 +90,26 @@ struct ta_ver_db_hdr {
 static const char ta_ver_db_obj_id[] = "ta_ver.db";
 static struct mutex ta_ver_db_mutex = MUTEX_INITIALIZER;
 
+/* Returns the system time in usecs, 0 if the load statistics are disabled */
+static uint64_t read_us(void)
+{
+	TEE_Time t = { };
+
+	if (!IS_ENABLED(CFG_TA_LOAD_STATS) || tee_time_get_sys_time(&t))
+		return 0;
+
+	return (uint64_t)t.seconds * 1000000 + t.millis * 1000;
+}
+
+/* Adds the usecs elapsed since @t to @acc and returns the current time */
+static uint64_t account_us(uint64_t *acc, uint64_t t)
+{
+	uint64_t now = read_us();
+
+	*acc += now - t;
+	return now;
+}
+
 /*
  * Load a TA via RPC with UUID defined by input param @uuid. The virtual
  * address of the raw TA binary is received in out parameter @ta.
@@ -124,6 +159,77 @@ exit:
 	return res;
 }
 
+/*
+ * Decrypts or copies @len bytes from @src to @dst and hashes them while
+ * they're still in the cache. With @dst == NULL the data is only hashed.
+ */
+static TEE_Result read_chunk(struct ree_fs_ta_handle *handle, uint8_t *dst,
+			     uint8_t *src, size_t len)
+{
+	const uint8_t *hash_src = dst;
+	TEE_Result res = TEE_SUCCESS;
+	uint64_t t = read_us();
+
+	if (shdr_img_is_encrypted(handle->shdr->img_type)) {
+		if (!dst) {
+			if (!handle->scratch) {
+				handle->scratch = malloc(REE_FS_TA_CHUNK_SIZE);
+				if (!handle->scratch)
+					return TEE_ERROR_OUT_OF_MEMORY;
+			}
+			dst = handle->scratch;
+		}
+		res = tee_ta_decrypt_update(handle->enc_ctx, dst, src, len);
+		if (res != TEE_SUCCESS)
+			return TEE_ERROR_SECURITY;
+		t = account_us(&handle->stats.decrypt, t);
+		hash_src = dst;
+	} else if (dst) {
+		/* Hash secure buffer (shm might be modified) */
+		memcpy(dst, src, len);
+		t = account_us(&handle->stats.copy, t);
+	} else {
+		hash_src = src;
+	}
+
+	res = crypto_hash_update(handle->hash_ctx, hash_src, len);
+	if (res != TEE_SUCCESS)
+		return TEE_ERROR_SECURITY;
+	account_us(&handle->stats.hash, t);
+
+	return TEE_SUCCESS;
+}
+
+/* Reads the image as it's stored, compressed or not */
+static TEE_Result read_stored(void *ctx, void *data, size_t len)
+{
+	struct ree_fs_ta_handle *handle = ctx;
+	uint8_t *src = (uint8_t *)handle->nw_ta + handle->offs;
+	TEE_Result res = TEE_SUCCESS;
+	uint8_t *dst = data;
+	size_t next_offs = 0;
+	size_t n = 0;
+
+	if (ADD_OVERFLOW(handle->offs, len, &next_offs) ||
+	    next_offs > handle->nw_ta_size)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	while (len) {
+		n = MIN(len, (size_t)REE_FS_TA_CHUNK_SIZE);
+		res = read_chunk(handle, dst, src, n);
+		if (res)
+			return res;
+		src += n;
+		if (dst)
+			dst += n;
+		len -= n;
+	}
+
+	handle->offs = next_offs;
+
+	return TEE_SUCCESS;
+}
+
 static TEE_Result ree_fs_ta_open(const TEE_UUID *uuid,
 				 struct ts_store_handle **h)
 {
@@ -138,15 +244,18 @@ static TEE_Result ree_fs_ta_open(const TEE_UUID *uuid,
 	struct shdr_bootstrap_ta *bs_hdr = NULL;
 	struct shdr_encrypted_ta *ehdr = NULL;
 	size_t shdr_sz = 0;
+	uint64_t t = 0;
 
 	handle = calloc(1, sizeof(*handle));
 	if (!handle)
 		return TEE_ERROR_OUT_OF_MEMORY;
 
 	/* Request TA from tee-supplicant */
+	t = read_us();
 	res = rpc_load(uuid, &ta, &ta_size, &mobj);
 	if (res != TEE_SUCCESS)
 		goto error;
+	t = account_us(&handle->stats.rpc, t);
 
 	/* Make secure copy of signed header */
 	shdr = shdr_alloc_and_copy(ta, ta_size);
@@ -159,8 +268,11 @@ static TEE_Result ree_fs_ta_open(const TEE_UUID *uuid,
 	res = shdr_verify_signature(shdr);
 	if (res != TEE_SUCCESS)
 		goto error_free_payload;
+	account_us(&handle->stats.verify, t);
 	if (shdr->img_type != SHDR_TA && shdr->img_type != SHDR_BOOTSTRAP_TA &&
-	    shdr->img_type != SHDR_ENCRYPTED_TA) {
+	    shdr->img_type != SHDR_ENCRYPTED_TA &&
+	    !(IS_ENABLED(CFG_TA_COMPRESSION) &&
+	      shdr_img_is_compressed(shdr->img_type))) {
 		res = TEE_ERROR_SECURITY;
 		goto error_free_payload;
 	}
@@ -186,8 +298,7 @@ static TEE_Result ree_fs_ta_open(const TEE_UUID *uuid,
 	}
 	offs = shdr_sz;
 
-	if (shdr->img_type == SHDR_BOOTSTRAP_TA ||
-	    shdr->img_type == SHDR_ENCRYPTED_TA) {
+	if (shdr->img_type != SHDR_TA) {
 		TEE_UUID bs_uuid = { };
 		size_t sz = shdr_sz;
 
@@ -224,7 +335,7 @@ static TEE_Result ree_fs_ta_open(const TEE_UUID *uuid,
 		handle->bs_hdr = bs_hdr;
 	}
 
-	if (shdr->img_type == SHDR_ENCRYPTED_TA) {
+	if (shdr_img_is_encrypted(shdr->img_type)) {
 		struct shdr_encrypted_ta img_ehdr = { };
 		size_t sz = shdr_sz;
 		size_t ehdr_sz = 0;
@@ -245,7 +356,6 @@ static TEE_Result ree_fs_ta_open(const TEE_UUID *uuid,
 			goto error_free_hash;
 		}
 
-
 		ehdr = malloc(ehdr_sz);
 		if (!ehdr) {
 			res = TEE_ERROR_OUT_OF_MEMORY;
@@ -267,6 +377,29 @@ static TEE_Result ree_fs_ta_open(const TEE_UUID *uuid,
 		handle->ehdr = ehdr;
 	}
 
+	if (shdr_img_is_compressed(shdr->img_type)) {
+		size_t sz = offs;
+
+		if (ADD_OVERFLOW(sz, sizeof(handle->chdr), &sz) ||
+		    ta_size < sz) {
+			res = TEE_ERROR_SECURITY;
+			goto error_free_hash;
+		}
+
+		memcpy(&handle->chdr, (uint8_t *)ta + offs,
+		       sizeof(handle->chdr));
+		res = crypto_hash_update(hash_ctx, (uint8_t *)&handle->chdr,
+					 sizeof(handle->chdr));
+		if (res != TEE_SUCCESS)
+			goto error_free_hash;
+		offs += sizeof(handle->chdr);
+
+		res = ts_decomp_alloc(&handle->chdr, shdr->img_size,
+				      read_stored, handle, &handle->decomp);
+		if (res != TEE_SUCCESS)
+			goto error_free_hash;
+	}
+
 	if (ta_size != offs + shdr->img_size) {
 		res = TEE_ERROR_SECURITY;
 		goto error_free_hash;
@@ -282,6 +415,7 @@ static TEE_Result ree_fs_ta_open(const TEE_UUID *uuid,
 	return TEE_SUCCESS;
 
 error_free_hash:
+	ts_decomp_free(handle->decomp);
 	crypto_hash_free_ctx(hash_ctx);
 error_free_payload:
 	thread_rpc_free_payload(mobj);
@@ -298,7 +432,10 @@ static TEE_Result ree_fs_ta_get_size(const struct ts_store_handle *h,
 {
 	struct ree_fs_ta_handle *handle = (struct ree_fs_ta_handle *)h;
 
-	*size = handle->shdr->img_size;
+	if (handle->decomp)
+		*size = handle->chdr.uncompressed_size;
+	else
+		*size = handle->shdr->img_size;
 	return TEE_SUCCESS;
 }
 
@@ -435,65 +572,23 @@ static TEE_Result ree_fs_ta_read(struct ts_store_handle *h, void *data,
 				 size_t len)
 {
 	struct ree_fs_ta_handle *handle = (struct ree_fs_ta_handle *)h;
-
-	uint8_t *src = (uint8_t *)handle->nw_ta + handle->offs;
-	size_t next_offs = 0;
-	uint8_t *dst = src;
 	TEE_Result res = TEE_SUCCESS;
 
-	if (ADD_OVERFLOW(handle->offs, len, &next_offs) ||
-	    next_offs > handle->nw_ta_size)
-		return TEE_ERROR_BAD_PARAMETERS;
-
-	if (handle->shdr->img_type == SHDR_ENCRYPTED_TA) {
-		if (data) {
-			dst = data; /* Hash secure buffer */
-			res = tee_ta_decrypt_update(handle->enc_ctx, dst, src,
-						    len);
-			if (res != TEE_SUCCESS)
-				return TEE_ERROR_SECURITY;
-		} else {
-			size_t num_bytes = 0;
-			size_t b_size = MIN(1024U, len);
-			uint8_t *b = malloc(b_size);
-
-			if (!b)
-				return TEE_ERROR_OUT_OF_MEMORY;
-
-			dst = NULL;
-			while (num_bytes < len) {
-				size_t n = MIN(b_size, len - num_bytes);
-
-				res = tee_ta_decrypt_update(handle->enc_ctx, b,
-							    src + num_bytes, n);
-				if (res)
-					break;
-				num_bytes += n;
-
-				res = crypto_hash_update(handle->hash_ctx, b,
-							 n);
-				if (res)
-					break;
-			}
-
-			free(b);
-			if (res != TEE_SUCCESS)
-				return TEE_ERROR_SECURITY;
-		}
-	} else if (data) {
-		dst = data; /* Hash secure buffer (shm might be modified) */
-		memcpy(dst, src, len);
-	}
-
-	if (dst) {
-		res = crypto_hash_update(handle->hash_ctx, dst, len);
-		if (res != TEE_SUCCESS)
-			return TEE_ERROR_SECURITY;
-	}
+	/*
+	 * A compressed image is read as needed to return @len bytes of
+	 * decompressed data, it may be consumed entirely before the last
+	 * decompressed byte is returned.
+	 */
+	if (handle->decomp)
+		res = ts_decomp_read(handle->decomp, data, len);
+	else
+		res = read_stored(handle, data, len);
+	if (res != TEE_SUCCESS)
+		return res;
 
-	handle->offs = next_offs;
-	if (handle->offs == handle->nw_ta_size) {
-		if (handle->shdr->img_type == SHDR_ENCRYPTED_TA) {
+	if (handle->offs == handle->nw_ta_size && !handle->checked) {
+		handle->checked = true;
+		if (shdr_img_is_encrypted(handle->shdr->img_type)) {
 			/*
 			 * Last read: time to finalize authenticated
 			 * decryption.
@@ -517,14 +612,49 @@ static TEE_Result ree_fs_ta_read(struct ts_store_handle *h, void *data,
 	return res;
 }
 
+#ifdef CFG_TA_LOAD_STATS
+static struct mutex load_stats_mu = MUTEX_INITIALIZER;
+static struct ree_fs_ta_load_stats load_stats;
+
+static void update_load_stats(struct ree_fs_ta_load_stats *s)
+{
+	mutex_lock(&load_stats_mu);
+	load_stats.count++;
+	load_stats.rpc += s->rpc;
+	load_stats.verify += s->verify;
+	load_stats.decrypt += s->decrypt;
+	load_stats.copy += s->copy;
+	load_stats.hash += s->hash;
+	mutex_unlock(&load_stats_mu);
+}
+
+void ree_fs_ta_get_load_stats(struct ree_fs_ta_load_stats *stats, bool reset)
+{
+	mutex_lock(&load_stats_mu);
+	*stats = load_stats;
+	if (reset)
+		memset(&load_stats, 0, sizeof(load_stats));
+	mutex_unlock(&load_stats_mu);
+}
+#else
+static void update_load_stats(struct ree_fs_ta_load_stats *s __unused)
+{
+}
+#endif
+
 static void ree_fs_ta_close(struct ts_store_handle *h)
 {
 	struct ree_fs_ta_handle *handle = (struct ree_fs_ta_handle *)h;
 
 	if (!handle)
 		return;
+
+	update_load_stats(&handle->stats);
+
+	ts_decomp_free(handle->decomp);
 	thread_rpc_free_payload(handle->mobj);
 	crypto_hash_free_ctx(handle->hash_ctx);
+	free(handle->scratch);
 	free(handle->shdr);
 	free(handle->ehdr);
 	free(handle->bs_hdr);
@@ -0,0 +1,202 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2022, Microchip
+ */
+
+#include <assert.h>
+#include <atomic.h>
+#include <kernel/misc.h>
+#include <kernel/panic.h>
+#include <kernel/rwlock.h>
+#include <kernel/spinlock.h>
+#include <kernel/thread.h>
+#include <kernel/wait_queue.h>
+
+/*
+ * Full memory barrier. The read lock fast path depends on the store to
+ * the per-core counter being visible to other cores before @writer is
+ * sampled and vice versa for the writer.
+ */
+static void rwlock_barrier(void)
+{
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static void add_reader(struct rwlock *rw, int delta)
+{
+	uint32_t exceptions = thread_mask_exceptions(THREAD_EXCP_FOREIGN_INTR);
+	struct rwlock_cpu *c = rw->cpu + get_core_pos();
+
+	atomic_store_int(&c->readers, c->readers + delta);
+
+	thread_unmask_exceptions(exceptions);
+}
+
+static int count_readers(struct rwlock *rw)
+{
+	int count = 0;
+	size_t n = 0;
+
+	for (n = 0; n < ARRAY_SIZE(rw->cpu); n++)
+		count += atomic_load_int(&rw->cpu[n].readers);
+
+	return count;
+}
+
+static bool read_fast_lock(struct rwlock *rw)
+{
+	add_reader(rw, 1);
+	rwlock_barrier();
+	if (!atomic_load_uint(&rw->writer))
+		return true;
+
+	/* A writer is pending or active, back off */
+	add_reader(rw, -1);
+	return false;
+}
+
+static void wake_writer(struct rwlock *rw)
+{
+	uint32_t old_itr_status = 0;
+
+	/* Make the counter update visible before @writer is sampled */
+	rwlock_barrier();
+	if (!atomic_load_uint(&rw->writer))
+		return;
+
+	/*
+	 * Taking the spinlock guarantees that a writer which has sampled
+	 * the counters before our update has also added itself to
+	 * @writer_wq, so the wakeup below cannot be lost.
+	 */
+	old_itr_status = cpu_spin_lock_xsave(&rw->spin_lock);
+	cpu_spin_unlock_xrestore(&rw->spin_lock, old_itr_status);
+
+	wq_wake_next(&rw->writer_wq, rw, NULL, -1);
+}
+
+void rwlock_init(struct rwlock *rw)
+{
+	*rw = (struct rwlock)RWLOCK_INITIALIZER;
+}
+
+void rwlock_destroy(struct rwlock *rw)
+{
+	/*
+	 * Caller guarantees that no one will try to take the lock so
+	 * there's no need to take the spinlock before accessing it.
+	 */
+	if (rw->writer || count_readers(rw))
+		panic();
+	if (!wq_is_empty(&rw->writer_wq) || !wq_is_empty(&rw->reader_wq))
+		panic("waitqueue not empty");
+	mutex_destroy(&rw->writer_mutex);
+}
+
+void rwlock_read_lock(struct rwlock *rw)
+{
+	assert_have_no_spinlock();
+	assert(thread_get_id_may_fail() != THREAD_ID_INVALID);
+	assert(thread_is_in_normal_mode());
+
+	while (!read_fast_lock(rw)) {
+		uint32_t old_itr_status = 0;
+		struct wait_queue_elem wqe = { };
+		bool wait = false;
+
+		/* The writer may have seen our transient reader count */
+		wake_writer(rw);
+
+		old_itr_status = cpu_spin_lock_xsave(&rw->spin_lock);
+
+		wait = atomic_load_uint(&rw->writer);
+		if (wait)
+			wq_wait_init(&rw->reader_wq, &wqe,
+				     true /* wait_read */);
+
+		cpu_spin_unlock_xrestore(&rw->spin_lock, old_itr_status);
+
+		if (wait)
+			wq_wait_final(&rw->reader_wq, &wqe, rw, NULL, -1);
+	}
+}
+
+bool rwlock_read_trylock(struct rwlock *rw)
+{
+	assert_have_no_spinlock();
+	assert(thread_get_id_may_fail() != THREAD_ID_INVALID);
+
+	if (read_fast_lock(rw))
+		return true;
+
+	wake_writer(rw);
+	return false;
+}
+
+void rwlock_read_unlock(struct rwlock *rw)
+{
+	assert_have_no_spinlock();
+	assert(thread_get_id_may_fail() != THREAD_ID_INVALID);
+
+	/* Complete the read side critical section before leaving it */
+	rwlock_barrier();
+	add_reader(rw, -1);
+	wake_writer(rw);
+}
+
+void rwlock_write_lock(struct rwlock *rw)
+{
+	assert_have_no_spinlock();
+	assert(thread_get_id_may_fail() != THREAD_ID_INVALID);
+	assert(thread_is_in_normal_mode());
+
+	mutex_lock(&rw->writer_mutex);
+
+	/* Hold back new readers */
+	atomic_store_uint(&rw->writer, 1);
+	rwlock_barrier();
+
+	while (true) {
+		uint32_t old_itr_status = 0;
+		struct wait_queue_elem wqe = { };
+		bool have_readers = false;
+
+		old_itr_status = cpu_spin_lock_xsave(&rw->spin_lock);
+
+		have_readers = count_readers(rw);
+		if (have_readers)
+			wq_wait_init(&rw->writer_wq, &wqe,
+				     false /* wait_read */);
+
+		cpu_spin_unlock_xrestore(&rw->spin_lock, old_itr_status);
+
+		if (!have_readers)
+			break;
+
+		/* Wait for the last reader to leave */
+		wq_wait_final(&rw->writer_wq, &wqe, rw, NULL, -1);
+	}
+
+	/* Don't let the critical section start before the readers are gone */
+	rwlock_barrier();
+}
+
+void rwlock_write_unlock(struct rwlock *rw)
+{
+	uint32_t old_itr_status = 0;
+
+	assert_have_no_spinlock();
+	assert(thread_get_id_may_fail() != THREAD_ID_INVALID);
+
+	if (!atomic_load_uint(&rw->writer))
+		panic();
+
+	old_itr_status = cpu_spin_lock_xsave(&rw->spin_lock);
+	atomic_store_uint(&rw->writer, 0);
+	cpu_spin_unlock_xrestore(&rw->spin_lock, old_itr_status);
+
+	/* Let all readers held back by this writer in */
+	wq_wake_next(&rw->reader_wq, rw, NULL, -1);
+
+	mutex_unlock(&rw->writer_mutex);
+}
@@ -3,48 +3,106 @@
  * Copyright (c) 2017, Linaro Limited
  */
 
+#include <config.h>
 #include <tee/tadb.h>
+#include <kernel/ts_decomp.h>
 #include <kernel/ts_store.h>
 #include <kernel/user_ta.h>
 #include <initcall.h>
+#include <stdlib.h>
+
+/*
+ * struct secstor_ta_handle - handle of a TA in the TA database
+ * @ta:		Opened TA
+ * @chdr:	Compression header, from the custom data of the TA
+ * @decomp:	Non-NULL if the TA is stored compressed
+ */
+struct secstor_ta_handle {
+	struct tee_tadb_ta_read *ta;
+	struct shdr_compressed_ta chdr;
+	struct ts_decomp *decomp;
+};
+
+static TEE_Result read_stored(void *ctx, void *data, size_t len)
+{
+	struct secstor_ta_handle *h = ctx;
+	size_t l = len;
+	TEE_Result res = tee_tadb_ta_read(h->ta, data, &l);
+
+	if (res)
+		return res;
+	if (l != len)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	return TEE_SUCCESS;
+}
 
 static TEE_Result secstor_ta_open(const TEE_UUID *uuid,
 				  struct ts_store_handle **handle)
 {
 	TEE_Result res;
-	struct tee_tadb_ta_read *ta;
+	struct secstor_ta_handle *h = NULL;
 	size_t l;
 	const struct tee_tadb_property *prop;
 
-	res = tee_tadb_ta_open(uuid, &ta);
-	if (res)
-		return res;
-	prop = tee_tadb_ta_get_property(ta);
+	h = calloc(1, sizeof(*h));
+	if (!h)
+		return TEE_ERROR_OUT_OF_MEMORY;
 
-	l = prop->custom_size;
-	res = tee_tadb_ta_read(ta, NULL, &l);
+	res = tee_tadb_ta_open(uuid, &h->ta);
 	if (res)
-		goto err;
-	if (l != prop->custom_size) {
-		res = TEE_ERROR_CORRUPT_OBJECT;
-		goto err;
+		goto err_free;
+	prop = tee_tadb_ta_get_property(h->ta);
+
+	if (prop->custom_size & TEE_TADB_CUSTOM_COMPRESSED) {
+		if (!IS_ENABLED(CFG_TA_COMPRESSION)) {
+			res = TEE_ERROR_NOT_SUPPORTED;
+			goto err;
+		}
+		if (tee_tadb_custom_size(prop) != sizeof(h->chdr)) {
+			res = TEE_ERROR_CORRUPT_OBJECT;
+			goto err;
+		}
+		res = read_stored(h, &h->chdr, sizeof(h->chdr));
+		if (res)
+			goto err;
+		res = ts_decomp_alloc(&h->chdr, prop->bin_size, read_stored,
+				      h, &h->decomp);
+		if (res)
+			goto err;
+	} else {
+		l = tee_tadb_custom_size(prop);
+		res = tee_tadb_ta_read(h->ta, NULL, &l);
+		if (res)
+			goto err;
+		if (l != tee_tadb_custom_size(prop)) {
+			res = TEE_ERROR_CORRUPT_OBJECT;
+			goto err;
+		}
 	}
 
-	*handle = (struct ts_store_handle *)ta;
+	*handle = (struct ts_store_handle *)h;
 
 	return TEE_SUCCESS;
 err:
-	tee_tadb_ta_close(ta);
+	tee_tadb_ta_close(h->ta);
+err_free:
+	free(h);
 	return res;
 }
 
 static TEE_Result secstor_ta_get_size(const struct ts_store_handle *h,
 				      size_t *size)
 {
-	struct tee_tadb_ta_read *ta = (struct tee_tadb_ta_read *)h;
-	const struct tee_tadb_property *prop = tee_tadb_ta_get_property(ta);
-
-	*size = prop->bin_size;
+	const struct secstor_ta_handle *sh = (const void *)h;
+	const struct tee_tadb_property *prop = NULL;
+
+	if (sh->decomp) {
+		*size = sh->chdr.uncompressed_size;
+	} else {
+		prop = tee_tadb_ta_get_property(sh->ta);
+		*size = prop->bin_size;
+	}
 
 	return TEE_SUCCESS;
 }
@@ -52,29 +110,28 @@ static TEE_Result secstor_ta_get_size(const struct ts_store_handle *h,
 static TEE_Result secstor_ta_get_tag(const struct ts_store_handle *h,
 				     uint8_t *tag, unsigned int *tag_len)
 {
-	return tee_tadb_get_tag((struct tee_tadb_ta_read *)h, tag, tag_len);
+	const struct secstor_ta_handle *sh = (const void *)h;
+
+	return tee_tadb_get_tag(sh->ta, tag, tag_len);
 }
 
 static TEE_Result secstor_ta_read(struct ts_store_handle *h, void *data,
 				  size_t len)
 {
-	struct tee_tadb_ta_read *ta = (struct tee_tadb_ta_read *)h;
-	size_t l = len;
-	TEE_Result res = tee_tadb_ta_read(ta, data, &l);
+	struct secstor_ta_handle *sh = (struct secstor_ta_handle *)h;
 
-	if (res)
-		return res;
-	if (l != len)
-		return TEE_ERROR_BAD_PARAMETERS;
-
-	return TEE_SUCCESS;
+	if (sh->decomp)
+		return ts_decomp_read(sh->decomp, data, len);
+	return read_stored(sh, data, len);
 }
 
 static void secstor_ta_close(struct ts_store_handle *h)
 {
-	struct tee_tadb_ta_read *ta = (struct tee_tadb_ta_read *)h;
+	struct secstor_ta_handle *sh = (struct secstor_ta_handle *)h;
 
-	tee_tadb_ta_close(ta);
+	ts_decomp_free(sh->decomp);
+	tee_tadb_ta_close(sh->ta);
+	free(sh);
 }
 
 REGISTER_TA_STORE(4) = {
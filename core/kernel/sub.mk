@@ -26,6 +26,7 @@ srcs-$(CFG_CORE_TPM_EVENT_LOG) += tpm.c
 srcs-y += initcall.c
 srcs-$(CFG_WITH_USER_TA) += user_access.c
 srcs-y += mutex.c
+srcs-y += rwlock.c
 srcs-$(CFG_LOCKDEP) += mutex_lockdep.c
 srcs-y += wait_queue.c
 srcs-y += notif.c
@@ -35,6 +36,7 @@ srcs-y += user_ta.c
 srcs-$(CFG_REE_FS_TA) += ree_fs_ta.c
 srcs-$(CFG_EARLY_TA) += early_ta.c
 srcs-$(CFG_SECSTOR_TA) += secstor_ta.c
+srcs-$(CFG_TA_COMPRESSION) += ts_decomp.c
 endif
 
 srcs-$(CFG_EMBEDDED_TS) += embedded_ts.c
@@ -0,0 +1,327 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2022, Microchip
+ */
+
+#include <io.h>
+#include <kernel/ts_decomp.h>
+#include <lz4.h>
+#include <stdlib.h>
+#include <string.h>
+#include <trace.h>
+#include <util.h>
+#include <zlib.h>
+
+/* Compressed data is read and skipped data is discarded in such chunks */
+#define DECOMP_CHUNK_SIZE	4096
+
+/* Largest LZ4 block encoding @n bytes, see LZ4_COMPRESSBOUND() */
+#define LZ4_BOUND(n)		((n) + (n) / 255 + 16)
+
+/*
+ * struct ts_decomp - decompression context
+ * @algo:	Compression algorithm, enum shdr_comp_algo
+ * @read_in:	Callback reading compressed data
+ * @ctx:	Context of @read_in
+ * @in_left:	Compressed bytes not read yet
+ * @out_left:	Decompressed bytes not returned yet
+ * @in_buf:	Compressed data
+ * @out_buf:	LZ4: the current block, zlib: discarded data
+ * @blk_len:	LZ4: number of bytes in @out_buf
+ * @blk_pos:	LZ4: number of bytes of @out_buf returned
+ * @dec_left:	LZ4: bytes left to decompress
+ * @strm:	zlib: inflate state
+ * @strm_end:	zlib: true once the end of the stream has been reached
+ */
+struct ts_decomp {
+	uint32_t algo;
+	ts_decomp_read_in_t read_in;
+	void *ctx;
+	size_t in_left;
+	size_t out_left;
+	uint8_t *in_buf;
+	uint8_t *out_buf;
+	size_t blk_len;
+	size_t blk_pos;
+	size_t dec_left;
+	z_stream strm;
+	bool strm_end;
+};
+
+static TEE_Result pull(struct ts_decomp *d, void *buf, size_t len)
+{
+	if (len > d->in_left)
+		return TEE_ERROR_BAD_FORMAT;
+	d->in_left -= len;
+
+	return d->read_in(d->ctx, buf, len);
+}
+
+static void *zalloc(void *opaque __unused, unsigned int items,
+		    unsigned int size)
+{
+	size_t sz = 0;
+
+	if (MUL_OVERFLOW(items, size, &sz))
+		return NULL;
+	return malloc(sz);
+}
+
+static void zfree(void *opaque __unused, void *address)
+{
+	free(address);
+}
+
+/* Runs inflate() once, fetching more compressed data first if needed */
+static TEE_Result zlib_inflate(struct ts_decomp *d)
+{
+	z_stream *strm = &d->strm;
+	TEE_Result res = TEE_SUCCESS;
+	size_t l = 0;
+	int st = Z_OK;
+
+	if (!strm->avail_in && d->in_left) {
+		l = MIN(d->in_left, (size_t)DECOMP_CHUNK_SIZE);
+		res = pull(d, d->in_buf, l);
+		if (res)
+			return res;
+		strm->next_in = d->in_buf;
+		strm->avail_in = l;
+	}
+
+	st = inflate(strm, Z_NO_FLUSH);
+	if (st == Z_STREAM_END) {
+		d->strm_end = true;
+		return TEE_SUCCESS;
+	}
+	/* No progress and no more input, the stream is truncated */
+	if (st == Z_BUF_ERROR && !strm->avail_in && !d->in_left)
+		return TEE_ERROR_BAD_FORMAT;
+	if (st != Z_OK && st != Z_BUF_ERROR) {
+		EMSG("Decompression error (%d)", st);
+		return TEE_ERROR_BAD_FORMAT;
+	}
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result zlib_read(struct ts_decomp *d, uint8_t *data, size_t len)
+{
+	z_stream *strm = &d->strm;
+	TEE_Result res = TEE_SUCCESS;
+	size_t n = 0;
+
+	while (len) {
+		n = MIN(len, (size_t)DECOMP_CHUNK_SIZE);
+		if (data)
+			strm->next_out = data;
+		else
+			strm->next_out = d->out_buf;
+		strm->avail_out = n;
+
+		while (strm->avail_out) {
+			/* The stream ends before the image does */
+			if (d->strm_end)
+				return TEE_ERROR_BAD_FORMAT;
+			res = zlib_inflate(d);
+			if (res)
+				return res;
+		}
+
+		if (data)
+			data += n;
+		len -= n;
+	}
+
+	return TEE_SUCCESS;
+}
+
+/* Checks that the stream ends right after the last decompressed byte */
+static TEE_Result zlib_finish(struct ts_decomp *d)
+{
+	z_stream *strm = &d->strm;
+	TEE_Result res = TEE_SUCCESS;
+	uint8_t b = 0;
+
+	while (!d->strm_end) {
+		strm->next_out = &b;
+		strm->avail_out = 1;
+		res = zlib_inflate(d);
+		if (res)
+			return res;
+		if (!strm->avail_out)
+			return TEE_ERROR_BAD_FORMAT;
+	}
+
+	if (strm->avail_in || d->in_left)
+		return TEE_ERROR_BAD_FORMAT;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result lz4_read_block(struct ts_decomp *d, uint8_t *dst,
+				 size_t blk_len)
+{
+	TEE_Result res = TEE_SUCCESS;
+	uint8_t hdr[sizeof(uint32_t)] = { };
+	size_t sz = 0;
+	size_t l = 0;
+
+	res = pull(d, hdr, sizeof(hdr));
+	if (res)
+		return res;
+	sz = get_le32(hdr) & ~SHDR_LZ4_BLOCK_STORED;
+
+	if (get_le32(hdr) & SHDR_LZ4_BLOCK_STORED) {
+		if (sz != blk_len)
+			return TEE_ERROR_BAD_FORMAT;
+		res = pull(d, dst, sz);
+	} else {
+		if (sz > LZ4_BOUND(blk_len))
+			return TEE_ERROR_BAD_FORMAT;
+		res = pull(d, d->in_buf, sz);
+		if (res)
+			return res;
+		l = blk_len;
+		res = lz4_decompress_block(d->in_buf, sz, dst, &l);
+		if (!res && l != blk_len)
+			res = TEE_ERROR_BAD_FORMAT;
+	}
+	if (res)
+		return res;
+
+	d->dec_left -= blk_len;
+	return TEE_SUCCESS;
+}
+
+static TEE_Result lz4_read(struct ts_decomp *d, uint8_t *data, size_t len)
+{
+	TEE_Result res = TEE_SUCCESS;
+	size_t blk_len = 0;
+	size_t n = 0;
+
+	while (len) {
+		if (d->blk_pos == d->blk_len) {
+			blk_len = MIN(d->dec_left, (size_t)SHDR_LZ4_BLOCK_SIZE);
+
+			/* Whole blocks go straight to the caller's buffer */
+			if (data && len >= blk_len) {
+				res = lz4_read_block(d, data, blk_len);
+				if (res)
+					return res;
+				data += blk_len;
+				len -= blk_len;
+				continue;
+			}
+
+			res = lz4_read_block(d, d->out_buf, blk_len);
+			if (res)
+				return res;
+			d->blk_len = blk_len;
+			d->blk_pos = 0;
+		}
+
+		n = MIN(len, d->blk_len - d->blk_pos);
+		if (data) {
+			memcpy(data, d->out_buf + d->blk_pos, n);
+			data += n;
+		}
+		d->blk_pos += n;
+		len -= n;
+	}
+
+	return TEE_SUCCESS;
+}
+
+TEE_Result ts_decomp_alloc(const struct shdr_compressed_ta *chdr,
+			   size_t in_size, ts_decomp_read_in_t read_in,
+			   void *ctx, struct ts_decomp **decomp)
+{
+	struct ts_decomp *d = NULL;
+	size_t in_buf_size = 0;
+	size_t out_buf_size = 0;
+	int st = Z_OK;
+
+	switch (chdr->algo) {
+	case SHDR_COMP_ZLIB:
+		in_buf_size = DECOMP_CHUNK_SIZE;
+		out_buf_size = DECOMP_CHUNK_SIZE;
+		break;
+	case SHDR_COMP_LZ4:
+		in_buf_size = LZ4_BOUND(SHDR_LZ4_BLOCK_SIZE);
+		out_buf_size = SHDR_LZ4_BLOCK_SIZE;
+		break;
+	default:
+		return TEE_ERROR_NOT_SUPPORTED;
+	}
+
+	d = calloc(1, sizeof(*d));
+	if (!d)
+		return TEE_ERROR_OUT_OF_MEMORY;
+	d->algo = chdr->algo;
+	d->read_in = read_in;
+	d->ctx = ctx;
+	d->in_left = in_size;
+	d->out_left = chdr->uncompressed_size;
+	d->dec_left = chdr->uncompressed_size;
+
+	d->in_buf = malloc(in_buf_size);
+	d->out_buf = malloc(out_buf_size);
+	if (!d->in_buf || !d->out_buf)
+		goto err;
+
+	if (d->algo == SHDR_COMP_ZLIB) {
+		d->strm.zalloc = zalloc;
+		d->strm.zfree = zfree;
+		st = inflateInit(&d->strm);
+		if (st != Z_OK) {
+			EMSG("Decompression initialization error (%d)", st);
+			goto err;
+		}
+	}
+
+	*decomp = d;
+	return TEE_SUCCESS;
+err:
+	free(d->in_buf);
+	free(d->out_buf);
+	free(d);
+	return TEE_ERROR_OUT_OF_MEMORY;
+}
+
+TEE_Result ts_decomp_read(struct ts_decomp *decomp, void *data, size_t len)
+{
+	TEE_Result res = TEE_SUCCESS;
+
+	if (len > decomp->out_left)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if (decomp->algo == SHDR_COMP_ZLIB)
+		res = zlib_read(decomp, data, len);
+	else
+		res = lz4_read(decomp, data, len);
+	if (res)
+		return res;
+
+	decomp->out_left -= len;
+	if (decomp->out_left)
+		return TEE_SUCCESS;
+
+	if (decomp->algo == SHDR_COMP_ZLIB)
+		return zlib_finish(decomp);
+	if (decomp->in_left)
+		return TEE_ERROR_BAD_FORMAT;
+	return TEE_SUCCESS;
+}
+
+void ts_decomp_free(struct ts_decomp *decomp)
+{
+	if (!decomp)
+		return;
+
+	if (decomp->algo == SHDR_COMP_ZLIB)
+		inflateEnd(&decomp->strm);
+	free(decomp->in_buf);
+	free(decomp->out_buf);
+	free(decomp);
+}
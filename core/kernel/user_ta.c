@@ -424,6 +424,7 @@ TEE_Result tee_ta_init_user_ta_session(const TEE_UUID *uuid,
 	utc->uctx.is_initializing = true;
 	TAILQ_INIT(&utc->open_sessions);
 	TAILQ_INIT(&utc->cryp_states);
+	TAILQ_INIT(&utc->cryp_ctx_pool);
 	TAILQ_INIT(&utc->objects);
 	TAILQ_INIT(&utc->storage_enums);
 	condvar_init(&utc->ta_ctx.busy_cv);
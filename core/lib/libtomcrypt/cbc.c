@@ -92,12 +92,24 @@ static void ltc_cbc_copy_state(struct crypto_cipher_ctx *dst_ctx,
 	dst->state = src->state;
 }
 
+static TEE_Result ltc_cbc_set_iv(struct crypto_cipher_ctx *ctx,
+				 const uint8_t *iv, size_t iv_len)
+{
+	struct ltc_cbc_ctx *c = to_cbc_ctx(ctx);
+
+	if (cbc_setiv(iv, iv_len, &c->state) == CRYPT_OK)
+		return TEE_SUCCESS;
+	else
+		return TEE_ERROR_BAD_PARAMETERS;
+}
+
 static const struct crypto_cipher_ops ltc_cbc_ops = {
 	.init = ltc_cbc_init,
 	.update = ltc_cbc_update,
 	.final = ltc_cbc_final,
 	.free_ctx = ltc_cbc_free_ctx,
 	.copy_state = ltc_cbc_copy_state,
+	.set_iv = ltc_cbc_set_iv,
 };
 
 static TEE_Result ltc_cbc_alloc_ctx(struct crypto_cipher_ctx **ctx_ret,
@@ -85,12 +85,24 @@ static void ltc_ctr_copy_state(struct crypto_cipher_ctx *dst_ctx,
 	dst->state = src->state;
 }
 
+static TEE_Result ltc_ctr_set_iv(struct crypto_cipher_ctx *ctx,
+				 const uint8_t *iv, size_t iv_len)
+{
+	struct ltc_ctr_ctx *c = to_ctr_ctx(ctx);
+
+	if (ctr_setiv(iv, iv_len, &c->state) == CRYPT_OK)
+		return TEE_SUCCESS;
+	else
+		return TEE_ERROR_BAD_PARAMETERS;
+}
+
 static const struct crypto_cipher_ops ltc_ctr_ops = {
 	.init = ltc_ctr_init,
 	.update = ltc_ctr_update,
 	.final = ltc_ctr_final,
 	.free_ctx = ltc_ctr_free_ctx,
 	.copy_state = ltc_ctr_copy_state,
+	.set_iv = ltc_ctr_set_iv,
 };
 
 TEE_Result crypto_aes_ctr_alloc_ctx(struct crypto_cipher_ctx **ctx_ret)
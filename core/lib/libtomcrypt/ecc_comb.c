@@ -0,0 +1,462 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2022, Microchip
+ */
+
+/*
+ * Fixed-base comb point multiplication for the generator of the curves
+ * used the most, speeding up ECDSA and SM2 signing as well as key
+ * generation where the scalar is multiplied with the generator.
+ *
+ * The scalar k is split into COMB_W rows of d bits, column i of the rows
+ * forms the digit x[i] and
+ *
+ *   k * G = sum(2^i * x[i] * G'), i = 0..d - 1, G' = (G, 2^d G, 2^2d G, ...)
+ *
+ * The digits are recoded into odd signed digits as done by
+ * ecp_comb_recode_core() in mbed TLS, so the table only needs to hold
+ * the 2^(COMB_W - 1) combinations including G and each of the d
+ * doublings is followed by exactly one addition of a table point
+ * without any special case. Even scalars are replaced with n - k and
+ * the result negated by negating all digits.
+ *
+ * The table is computed at boot and holds affine points in Montgomery
+ * form. The table point added is selected by scanning the whole table
+ * so there are no memory accesses depending on the scalar.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <string_ext.h>
+#include <trace.h>
+#include <types_ext.h>
+#include <util.h>
+
+#include "acipher_helpers.h"
+#include "tomcrypt_mp.h"
+
+#define COMB_W		5
+#define COMB_POINTS	BIT(COMB_W - 1)
+#define COMB_MAX_BYTES	48
+#define COMB_MAX_DIGITS	(DIV_ROUND_UP(COMB_MAX_BYTES * 8, COMB_W) + 1)
+
+/*
+ * struct ecc_comb - comb for the generator of a curve
+ * @name:	LTC name of the curve
+ * @size:	size in bytes of the field elements and of the order
+ * @d:		number of bits in each row of the scalar
+ * @prime:	the prime of the field
+ * @order:	the order of the generator
+ * @gx:		x coordinate of the generator
+ * @gy:		y coordinate of the generator
+ * @one:	1 in Montgomery form
+ * @table:	COMB_POINTS points as x followed by y in Montgomery form,
+ *		NULL if the comb isn't available
+ *
+ * All numbers are big endian of @size bytes.
+ */
+struct ecc_comb {
+	const char *name;
+	size_t size;
+	size_t d;
+	uint8_t prime[COMB_MAX_BYTES];
+	uint8_t order[COMB_MAX_BYTES];
+	uint8_t gx[COMB_MAX_BYTES];
+	uint8_t gy[COMB_MAX_BYTES];
+	uint8_t one[COMB_MAX_BYTES];
+	uint8_t *table;
+};
+
+static struct ecc_comb ecc_combs[] = {
+	{ .name = "NISTP256" },
+	{ .name = "NISTP384" },
+#ifdef LTC_ECC_SM2
+	{ .name = "SM2" },
+#endif
+};
+
+static int get_bytes(void *a, uint8_t *buf, size_t size)
+{
+	if ((size_t)mp_unsigned_bin_size(a) > size)
+		return CRYPT_BUFFER_OVERFLOW;
+
+	memset(buf, 0, size);
+	mp_to_unsigned_bin2(a, buf, size);
+
+	return CRYPT_OK;
+}
+
+static int comb_build_table(struct ecc_comb *c, ecc_key *key, void *mp,
+			    void *mu)
+{
+	ecc_point *t[COMB_POINTS] = { };
+	ecc_point *p = NULL;
+	size_t len = 2 * c->size;
+	size_t n = 0;
+	size_t m = 0;
+	int err = CRYPT_MEM;
+
+	p = ltc_ecc_new_point();
+	if (!p)
+		goto out;
+	for (n = 0; n < COMB_POINTS; n++) {
+		t[n] = ltc_ecc_new_point();
+		if (!t[n])
+			goto out;
+	}
+
+	/* p = G in Montgomery form */
+	err = mp_mulmod(key->dp.base.x, mu, key->dp.prime, p->x);
+	if (err)
+		goto out;
+	err = mp_mulmod(key->dp.base.y, mu, key->dp.prime, p->y);
+	if (err)
+		goto out;
+	err = mp_copy(mu, p->z);
+	if (err)
+		goto out;
+
+	/* t[j] = G + sum(bit b of j * 2^((b + 1) * d) * G) */
+	err = ltc_ecc_copy_point(p, t[0]);
+	if (err)
+		goto out;
+	for (n = 1; n < COMB_W; n++) {
+		for (m = 0; m < c->d; m++) {
+			err = ltc_mp.ecc_ptdbl(p, p, NULL, key->dp.prime, mp);
+			if (err)
+				goto out;
+		}
+		for (m = 0; m < BIT(n - 1); m++) {
+			err = ltc_mp.ecc_ptadd(t[m], p, t[m + BIT(n - 1)], NULL,
+					       key->dp.prime, mp);
+			if (err)
+				goto out;
+		}
+	}
+
+	c->table = calloc(COMB_POINTS, len);
+	if (!c->table) {
+		err = CRYPT_MEM;
+		goto out;
+	}
+
+	for (n = 0; n < COMB_POINTS; n++) {
+		err = ltc_ecc_map(t[n], key->dp.prime, mp);
+		if (err)
+			goto out;
+		err = mp_mulmod(t[n]->x, mu, key->dp.prime, t[n]->x);
+		if (err)
+			goto out;
+		err = mp_mulmod(t[n]->y, mu, key->dp.prime, t[n]->y);
+		if (err)
+			goto out;
+		err = get_bytes(t[n]->x, c->table + n * len, c->size);
+		if (err)
+			goto out;
+		err = get_bytes(t[n]->y, c->table + n * len + c->size,
+				c->size);
+		if (err)
+			goto out;
+	}
+out:
+	if (err) {
+		free(c->table);
+		c->table = NULL;
+	}
+	for (n = 0; n < COMB_POINTS; n++)
+		ltc_ecc_del_point(t[n]);
+	ltc_ecc_del_point(p);
+	return err;
+}
+
+static int comb_build(struct ecc_comb *c)
+{
+	const ltc_ecc_curve *cu = NULL;
+	ecc_key key = { };
+	void *mp = NULL;
+	void *mu = NULL;
+	int err = CRYPT_OK;
+
+	err = ecc_find_curve(c->name, &cu);
+	if (err)
+		return err;
+	err = ecc_set_curve(cu, &key);
+	if (err)
+		return err;
+
+	err = mp_init(&mu);
+	if (err)
+		goto out;
+
+	c->size = mp_unsigned_bin_size(key.dp.prime);
+	c->d = DIV_ROUND_UP(mp_count_bits(key.dp.order), COMB_W);
+	if (c->size > COMB_MAX_BYTES) {
+		err = CRYPT_INVALID_ARG;
+		goto out;
+	}
+
+	/* Only a = -3 is handled, that's the case for all curves above */
+	err = mp_add_d(key.dp.A, 3, mu);
+	if (err)
+		goto out;
+	if (mp_cmp(mu, key.dp.prime) != LTC_MP_EQ) {
+		err = CRYPT_INVALID_ARG;
+		goto out;
+	}
+
+	err = mp_montgomery_setup(key.dp.prime, &mp);
+	if (err)
+		goto out;
+	err = mp_montgomery_normalization(mu, key.dp.prime);
+	if (err)
+		goto out;
+
+	err = get_bytes(key.dp.prime, c->prime, c->size);
+	if (!err)
+		err = get_bytes(key.dp.order, c->order, c->size);
+	if (!err)
+		err = get_bytes(key.dp.base.x, c->gx, c->size);
+	if (!err)
+		err = get_bytes(key.dp.base.y, c->gy, c->size);
+	if (!err)
+		err = get_bytes(mu, c->one, c->size);
+	if (!err)
+		err = comb_build_table(c, &key, mp, mu);
+out:
+	if (mp)
+		mp_montgomery_free(mp);
+	if (mu)
+		mp_clear(mu);
+	ecc_free(&key);
+	return err;
+}
+
+void ecc_comb_init(void)
+{
+	size_t n = 0;
+	int err = CRYPT_OK;
+
+	for (n = 0; n < ARRAY_SIZE(ecc_combs); n++) {
+		err = comb_build(ecc_combs + n);
+		if (err)
+			EMSG("Comb for %s not available: %d",
+			     ecc_combs[n].name, err);
+	}
+}
+
+static bool is_equal(void *a, const uint8_t *b, size_t size)
+{
+	uint8_t buf[COMB_MAX_BYTES] = { };
+
+	if (get_bytes(a, buf, size))
+		return false;
+
+	return !memcmp(buf, b, size);
+}
+
+static struct ecc_comb *find_comb(const ecc_point *G, void *modulus)
+{
+	struct ecc_comb *c = NULL;
+	size_t n = 0;
+
+	if (mp_cmp_d(G->z, 1) != LTC_MP_EQ)
+		return NULL;
+
+	for (n = 0; n < ARRAY_SIZE(ecc_combs); n++) {
+		c = ecc_combs + n;
+		if (c->table && is_equal(modulus, c->prime, c->size) &&
+		    is_equal(G->x, c->gx, c->size) &&
+		    is_equal(G->y, c->gy, c->size))
+			return c;
+	}
+
+	return NULL;
+}
+
+/* Returns 0xff if @a == @b, else 0 */
+static uint8_t ct_eq_mask(size_t a, size_t b)
+{
+	return -(uint8_t)(((a ^ b) - 1) >> (sizeof(size_t) * 8 - 1));
+}
+
+/* r = a - b, returns the borrow */
+static unsigned int ct_sub(uint8_t *r, const uint8_t *a, const uint8_t *b,
+			   size_t size)
+{
+	unsigned int borrow = 0;
+	unsigned int t = 0;
+	size_t n = size;
+
+	while (n--) {
+		t = a[n] - b[n] - borrow;
+		r[n] = t;
+		borrow = (t >> 8) & 1;
+	}
+
+	return borrow;
+}
+
+/* r = @mask ? a : r */
+static void ct_select(uint8_t *r, const uint8_t *a, uint8_t mask, size_t size)
+{
+	size_t n = 0;
+
+	for (n = 0; n < size; n++)
+		r[n] = (r[n] & ~mask) | (a[n] & mask);
+}
+
+static unsigned int get_bit(const uint8_t *k, size_t size, size_t bit)
+{
+	if (bit >= size * 8)
+		return 0;
+
+	return (k[size - 1 - bit / 8] >> (bit % 8)) & 1;
+}
+
+/*
+ * Recodes the odd scalar @k into the d + 1 odd digits in @x. Bit 7 of a
+ * digit is set if the digit is negative.
+ */
+static void comb_recode(const struct ecc_comb *c, const uint8_t *k,
+			uint8_t *x)
+{
+	uint8_t adjust = 0;
+	uint8_t cc = 0;
+	uint8_t cy = 0;
+	size_t i = 0;
+	size_t j = 0;
+
+	memset(x, 0, c->d + 1);
+	for (i = 0; i < c->d; i++)
+		for (j = 0; j < COMB_W; j++)
+			x[i] |= get_bit(k, c->size, i + c->d * j) << j;
+
+	for (i = 1; i <= c->d; i++) {
+		cc = x[i] & cy;
+		x[i] ^= cy;
+		cy = cc;
+		adjust = 1 - (x[i] & 1);
+		cy |= x[i] & (x[i - 1] * adjust);
+		x[i] ^= x[i - 1] * adjust;
+		x[i - 1] |= adjust << 7;
+	}
+}
+
+/* Loads the table point of @digit into @Q without secret dependent access */
+static int comb_select(const struct ecc_comb *c, uint8_t digit, ecc_point *Q)
+{
+	size_t idx = (digit & 0x7f) >> 1;
+	uint8_t neg = -(uint8_t)(digit >> 7);
+	uint8_t ny[COMB_MAX_BYTES] = { };
+	uint8_t x[COMB_MAX_BYTES] = { };
+	uint8_t y[COMB_MAX_BYTES] = { };
+	const uint8_t *p = c->table;
+	size_t n = 0;
+	int err = CRYPT_OK;
+
+	for (n = 0; n < COMB_POINTS; n++, p += 2 * c->size) {
+		ct_select(x, p, ct_eq_mask(n, idx), c->size);
+		ct_select(y, p + c->size, ct_eq_mask(n, idx), c->size);
+	}
+	ct_sub(ny, c->prime, y, c->size);
+	ct_select(y, ny, neg, c->size);
+
+	err = mp_read_unsigned_bin(Q->x, x, c->size);
+	if (!err)
+		err = mp_read_unsigned_bin(Q->y, y, c->size);
+	if (!err)
+		err = mp_read_unsigned_bin(Q->z, (uint8_t *)c->one,
+					   c->size);
+
+	memzero_explicit(x, sizeof(x));
+	memzero_explicit(y, sizeof(y));
+	memzero_explicit(ny, sizeof(ny));
+	return err;
+}
+
+static int comb_mulmod(const struct ecc_comb *c, void *k, ecc_point *R,
+		       void *modulus, int map)
+{
+	uint8_t x[COMB_MAX_DIGITS] = { };
+	uint8_t kb[COMB_MAX_BYTES] = { };
+	uint8_t nk[COMB_MAX_BYTES] = { };
+	uint8_t even = 0;
+	ecc_point *Q = NULL;
+	void *mp = NULL;
+	size_t i = 0;
+	int err = CRYPT_OK;
+
+	err = get_bytes(k, kb, c->size);
+	if (err)
+		return err;
+
+	/* Make the scalar odd, n - k is odd if k is even */
+	even = -(uint8_t)(1 - (kb[c->size - 1] & 1));
+	ct_sub(nk, c->order, kb, c->size);
+	ct_select(kb, nk, even, c->size);
+	comb_recode(c, kb, x);
+	for (i = 0; i <= c->d; i++)
+		x[i] ^= even & 0x80;
+
+	Q = ltc_ecc_new_point();
+	if (!Q) {
+		err = CRYPT_MEM;
+		goto out;
+	}
+	err = mp_montgomery_setup(modulus, &mp);
+	if (err)
+		goto out;
+
+	err = comb_select(c, x[c->d], R);
+	if (err)
+		goto out;
+	for (i = c->d; i; i--) {
+		err = ltc_mp.ecc_ptdbl(R, R, NULL, modulus, mp);
+		if (err)
+			goto out;
+		err = comb_select(c, x[i - 1], Q);
+		if (err)
+			goto out;
+		err = ltc_mp.ecc_ptadd(R, Q, R, NULL, modulus, mp);
+		if (err)
+			goto out;
+	}
+
+	if (map)
+		err = ltc_ecc_map(R, modulus, mp);
+out:
+	if (mp)
+		mp_montgomery_free(mp);
+	ltc_ecc_del_point(Q);
+	memzero_explicit(x, sizeof(x));
+	memzero_explicit(kb, sizeof(kb));
+	memzero_explicit(nk, sizeof(nk));
+	return err;
+}
+
+/* Returns true if 0 < @k < n */
+static bool is_valid_scalar(const struct ecc_comb *c, void *k)
+{
+	uint8_t kb[COMB_MAX_BYTES] = { };
+	bool res = false;
+
+	if (mp_cmp_d(k, 0) != LTC_MP_GT || get_bytes(k, kb, c->size))
+		return false;
+
+	res = memcmp(kb, c->order, c->size) < 0;
+	memzero_explicit(kb, sizeof(kb));
+
+	return res;
+}
+
+int ecc_comb_mulmod(void *k, const ecc_point *G, ecc_point *R, void *a,
+		    void *modulus, int map)
+{
+	struct ecc_comb *c = find_comb(G, modulus);
+
+	/* Other points and out of range scalars are left to the ladder */
+	if (c && is_valid_scalar(c, k))
+		return comb_mulmod(c, k, R, modulus, map);
+
+	return ltc_ecc_mulmod(k, G, R, a, modulus, map);
+}
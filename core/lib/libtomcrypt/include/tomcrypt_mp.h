@@ -6,10 +6,39 @@
 #ifndef TOMCRYPT_MP_H_
 #define TOMCRYPT_MP_H_
 
+#include <stddef.h>
+
 #if defined(_CFG_CORE_LTC_ACIPHER)
 void init_mp_tomcrypt(void);
 #else
 static inline void init_mp_tomcrypt(void) { }
 #endif
 
+#define MPI_MONT_CACHE_MAX_MODS	3
+
+/*
+ * Precomputed Montgomery values for up to MPI_MONT_CACHE_MAX_MODS moduli,
+ * NULL or zero moduli in @mod are skipped. Once set with
+ * mpi_mont_cache_set() mp_exptmod() in the current thread skips the
+ * setup for these moduli. Returns NULL on failure.
+ */
+struct mpi_mont_cache;
+struct mpi_mont_cache *mpi_mont_cache_alloc(void *mod[], size_t count);
+void mpi_mont_cache_free(struct mpi_mont_cache *c);
+/* Sets the cache used by the current thread, NULL to stop using it */
+void mpi_mont_cache_set(struct mpi_mont_cache *c);
+
+#if defined(_CFG_CORE_LTC_ECC_COMB)
+/* Computes the comb of the supported curves, called once at boot */
+void ecc_comb_init(void);
+/*
+ * Same as ltc_ecc_mulmod() but uses the precomputed comb if @G is the
+ * generator of a supported curve.
+ */
+int ecc_comb_mulmod(void *k, const ecc_point *G, ecc_point *R, void *a,
+		    void *modulus, int map);
+#else
+static inline void ecc_comb_init(void) { }
+#endif
+
 #endif /* TOMCRYPT_MP_H_ */
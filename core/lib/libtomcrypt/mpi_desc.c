@@ -5,9 +5,11 @@
 
 #include <crypto/crypto.h>
 #include <kernel/panic.h>
+#include <kernel/thread.h>
 #include <mbedtls/bignum.h>
 #include <mempool.h>
 #include <stdlib.h>
+#include <stdlib_ext.h>
 #include <string.h>
 #include <tomcrypt_private.h>
 #include <tomcrypt_mp.h>
@@ -564,6 +566,115 @@ static void montgomery_deinit(void *a)
 	free(a);
 }
 
+/*
+ * struct mpi_mont_ent - Montgomery values of a modulus
+ * @mod:	modulus as passed to exptmod()
+ * @limbs:	number of limbs of @mod when @rr was computed
+ * @val:	copy of the modulus when @rr was computed
+ * @rr:		R^2 mod @val as computed by mbedtls_mpi_exp_mod()
+ *
+ * The numbers are allocated from the heap, not from the mempool, since
+ * they outlive the current operation.
+ */
+struct mpi_mont_ent {
+	const mbedtls_mpi *mod;
+	size_t limbs;
+	mbedtls_mpi val;
+	mbedtls_mpi rr;
+};
+
+struct mpi_mont_cache {
+	size_t count;
+	struct mpi_mont_ent ent[MPI_MONT_CACHE_MAX_MODS];
+};
+
+/* The cache used by exptmod(), per thread as the mempool */
+static struct mpi_mont_cache *mont_cache[CFG_NUM_THREADS];
+
+struct mpi_mont_cache *mpi_mont_cache_alloc(void *mod[], size_t count)
+{
+	struct mpi_mont_cache *c = NULL;
+	struct mpi_mont_ent *e = NULL;
+	const mbedtls_mpi *m = NULL;
+	size_t n = 0;
+
+	if (count > MPI_MONT_CACHE_MAX_MODS)
+		return NULL;
+
+	c = calloc(1, sizeof(*c));
+	if (!c)
+		return NULL;
+
+	for (n = 0; n < count; n++) {
+		m = mod[n];
+		if (!m || mbedtls_mpi_cmp_int(m, 0) <= 0)
+			continue;
+
+		e = c->ent + c->count;
+		e->mod = m;
+		e->limbs = m->n;
+		mbedtls_mpi_init(&e->val);
+		mbedtls_mpi_init(&e->rr);
+		c->count++;
+
+		/* Same as in mbedtls_mpi_exp_mod(), depends on m->n */
+		if (mbedtls_mpi_copy(&e->val, m) ||
+		    mbedtls_mpi_lset(&e->rr, 1) ||
+		    mbedtls_mpi_shift_l(&e->rr, m->n * 2 * biL) ||
+		    mbedtls_mpi_mod_mpi(&e->rr, &e->rr, m)) {
+			mpi_mont_cache_free(c);
+			return NULL;
+		}
+	}
+
+	return c;
+}
+
+void mpi_mont_cache_free(struct mpi_mont_cache *c)
+{
+	size_t n = 0;
+
+	if (!c)
+		return;
+
+	for (n = 0; n < c->count; n++) {
+		mbedtls_mpi_free(&c->ent[n].val);
+		mbedtls_mpi_free(&c->ent[n].rr);
+	}
+	free_wipe(c);
+}
+
+void mpi_mont_cache_set(struct mpi_mont_cache *c)
+{
+	short int id = thread_get_id_may_fail();
+
+	if (id >= 0)
+		mont_cache[id] = c;
+}
+
+/*
+ * Returns the cached R^2 for @mod or NULL. The value of @mod is checked
+ * too so a stale cache is never used even if the key was updated in
+ * place.
+ */
+static mbedtls_mpi *mont_cache_get_rr(const mbedtls_mpi *mod)
+{
+	short int id = thread_get_id_may_fail();
+	struct mpi_mont_cache *c = NULL;
+	struct mpi_mont_ent *e = NULL;
+
+	if (id < 0 || !mont_cache[id])
+		return NULL;
+
+	c = mont_cache[id];
+	for (e = c->ent; e < c->ent + c->count; e++)
+		if (e->mod == mod && e->limbs == mod->n &&
+		    !mbedtls_mpi_cmp_mpi(&e->val, mod))
+			return &e->rr;
+
+	return NULL;
+}
+
 /*
  * This function calculates:
  *  d = a^b mod c
@@ -575,18 +686,19 @@ static void montgomery_deinit(void *a)
  */
 static int exptmod(void *a, void *b, void *c, void *d)
 {
+	mbedtls_mpi *rr = mont_cache_get_rr(c);
 	int res;
 
 	if (d == a || d == b || d == c) {
 		mbedtls_mpi dest;
 
 		mbedtls_mpi_init_mempool(&dest);
-		res = mbedtls_mpi_exp_mod(&dest, a, b, c, NULL);
+		res = mbedtls_mpi_exp_mod(&dest, a, b, c, rr);
 		if (!res)
 			res = mbedtls_mpi_copy(d, &dest);
 		mbedtls_mpi_free(&dest);
 	} else {
-		res = mbedtls_mpi_exp_mod(d, a, b, c, NULL);
+		res = mbedtls_mpi_exp_mod(d, a, b, c, rr);
 	}
 
 	if (res)
@@ -679,8 +791,10 @@ ltc_math_descriptor ltc_mp = {
 	.isprime = isprime,
 
 #ifdef LTC_MECC
-#ifdef LTC_MECC_FP
+#if defined(LTC_MECC_FP)
 	.ecc_ptmul = ltc_ecc_fp_mulmod,
+#elif defined(_CFG_CORE_LTC_ECC_COMB)
+	.ecc_ptmul = ecc_comb_mulmod,
 #else
 	.ecc_ptmul = ltc_ecc_mulmod,
 #endif /* LTC_MECC_FP */
@@ -9,8 +9,10 @@
 #include <tee_api_types.h>
 #include <tee_api_defines_extensions.h>
 #include <tee/tee_cryp_utl.h>
+#include <tomcrypt_mp.h>
 #include <trace.h>
 #include <utee_defines.h>
+#include <util.h>
 
 #include "acipher_helpers.h"
 
@@ -131,10 +133,17 @@ void crypto_acipher_free_rsa_public_key(struct rsa_public_key *s)
 	crypto_bignum_free(s->e);
 }
 
+void crypto_acipher_flush_rsa_keypair_cache(struct rsa_keypair *s)
+{
+	mpi_mont_cache_free(s->cache);
+	s->cache = NULL;
+}
+
 void crypto_acipher_free_rsa_keypair(struct rsa_keypair *s)
 {
 	if (!s)
 		return;
+	crypto_acipher_flush_rsa_keypair_cache(s);
 	crypto_bignum_free(s->e);
 	crypto_bignum_free(s->d);
 	crypto_bignum_free(s->n);
@@ -161,6 +170,7 @@ TEE_Result crypto_acipher_gen_rsa_key(struct rsa_keypair *key, size_t key_size)
 		res = TEE_ERROR_BAD_PARAMETERS;
 	} else {
 		/* Copy the key */
+		crypto_acipher_flush_rsa_keypair_cache(key);
 		ltc_mp.copy(ltc_tmp_key.d,  key->d);
 		ltc_mp.copy(ltc_tmp_key.N,  key->n);
 		ltc_mp.copy(ltc_tmp_key.p,  key->p);
@@ -238,6 +248,27 @@ out:
 	return res;
 }
 
+/*
+ * The Montgomery values of the modulus and of the primes are computed on
+ * first use of the private key and kept with @key so repeated operations
+ * with the same key skip that setup. Blinding and CRT hardening use the
+ * modulus too.
+ */
+static void private_key_cache_enter(struct rsa_keypair *key,
+				    const rsa_key *ltc_key)
+{
+	void *mod[] = { ltc_key->N, ltc_key->p, ltc_key->q };
+
+	if (!key->cache)
+		key->cache = mpi_mont_cache_alloc(mod, ARRAY_SIZE(mod));
+	mpi_mont_cache_set(key->cache);
+}
+
+static void private_key_cache_exit(void)
+{
+	mpi_mont_cache_set(NULL);
+}
+
 TEE_Result crypto_acipher_rsanopad_encrypt(struct rsa_public_key *key,
 					   const uint8_t *src, size_t src_len,
 					   uint8_t *dst, size_t *dst_len)
@@ -272,7 +303,9 @@ TEE_Result crypto_acipher_rsanopad_decrypt(struct rsa_keypair *key,
 		ltc_key.dQ = key->dq;
 	}
 
+	private_key_cache_enter(key, &ltc_key);
 	res = rsadorep(&ltc_key, src, src_len, dst, dst_len);
+	private_key_cache_exit();
 	return res;
 }
 
@@ -328,10 +361,12 @@ TEE_Result crypto_acipher_rsaes_decrypt(uint32_t algo, struct rsa_keypair *key,
 		goto out;
 	}
 
+	private_key_cache_enter(key, &ltc_key);
 	ltc_res = rsa_decrypt_key_ex(src, src_len, buf, &blen,
 				     ((label_len == 0) ? 0 : label), label_len,
 				     ltc_hashindex, ltc_rsa_algo, &ltc_stat,
 				     &ltc_key);
+	private_key_cache_exit();
 	switch (ltc_res) {
 	case CRYPT_PK_INVALID_PADDING:
 	case CRYPT_INVALID_PACKET:
@@ -504,9 +539,11 @@ TEE_Result crypto_acipher_rsassa_sign(uint32_t algo, struct rsa_keypair *key,
 
 	ltc_sig_len = mod_size;
 
+	private_key_cache_enter(key, &ltc_key);
 	ltc_res = rsa_sign_hash_ex(msg, msg_len, sig, &ltc_sig_len,
 				   ltc_rsa_algo, NULL, find_prng("prng_crypto"),
 				   ltc_hashindex, salt_len, &ltc_key);
+	private_key_cache_exit();
 
 	*sig_len = ltc_sig_len;
 
@@ -68,8 +68,8 @@ A3:
 
 	/* Step A4: compute (x1, y1) = [k]G */
 
-	ltc_res = ltc_ecc_mulmod(k, &ltc_key.dp.base, x1y1p, ltc_key.dp.A,
-				 ltc_key.dp.prime, 1);
+	ltc_res = ltc_mp.ecc_ptmul(k, &ltc_key.dp.base, x1y1p, ltc_key.dp.A,
+				  ltc_key.dp.prime, 1);
 	if (ltc_res != CRYPT_OK) {
 		res = TEE_ERROR_BAD_STATE;
 		goto out;
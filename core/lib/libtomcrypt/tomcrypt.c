@@ -128,6 +128,7 @@ static void ltc_init(void)
 	init_mp_tomcrypt();
 #endif
 	tee_ltc_reg_algs();
+	ecc_comb_init();
 }
 
 #if defined(CFG_CRYPTOLIB_NAME_tomcrypt)
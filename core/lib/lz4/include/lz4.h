@@ -0,0 +1,29 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2022, Microchip
+ */
+#ifndef __LZ4_H
+#define __LZ4_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <tee_api_types.h>
+
+/*
+ * lz4_decompress_block() - Decompress one block in the LZ4 block format
+ * @src:	Compressed block
+ * @src_len:	Length of @src
+ * @dst:	Output buffer
+ * @dst_len:	In: size of @dst, out: number of bytes written to @dst
+ *
+ * The block must be self-contained, matches can't refer to data before
+ * @dst. Malformed input never makes the decoder read or write out of the
+ * two buffers.
+ *
+ * Returns TEE_SUCCESS on success or TEE_ERROR_BAD_FORMAT if @src isn't a
+ * valid block or doesn't fit in @dst.
+ */
+TEE_Result lz4_decompress_block(const uint8_t *src, size_t src_len,
+				uint8_t *dst, size_t *dst_len);
+
+#endif /*__LZ4_H*/
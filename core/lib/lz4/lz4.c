@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2022, Microchip
+ */
+
+/*
+ * Decoder of the LZ4 block format
+ *
+ * A block is a sequence of sequences. Each one starts with a token byte,
+ * the high nibble is the number of literals and the low nibble the match
+ * length minus 4. A nibble of 15 is followed by bytes adding to it, up to
+ * and including the first byte that isn't 255. Then come the literals and
+ * a 16-bit little endian offset back into the output where the match is
+ * copied from. The last sequence has literals only.
+ */
+
+#include <lz4.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define LZ4_MIN_MATCH	4
+
+static bool read_len(const uint8_t **ip, const uint8_t *iend, size_t *len)
+{
+	uint8_t b = 0;
+
+	do {
+		if (*ip == iend)
+			return false;
+		b = *(*ip)++;
+		if (*len > SIZE_MAX - b)
+			return false;
+		*len += b;
+	} while (b == 255);
+
+	return true;
+}
+
+TEE_Result lz4_decompress_block(const uint8_t *src, size_t src_len,
+				uint8_t *dst, size_t *dst_len)
+{
+	const uint8_t *ip = src;
+	const uint8_t *iend = src + src_len;
+	uint8_t *op = dst;
+	uint8_t *oend = dst + *dst_len;
+	const uint8_t *match = NULL;
+	size_t offset = 0;
+	size_t len = 0;
+	uint8_t token = 0;
+
+	while (ip < iend) {
+		token = *ip++;
+
+		len = token >> 4;
+		if (len == 15 && !read_len(&ip, iend, &len))
+			return TEE_ERROR_BAD_FORMAT;
+		if (len > (size_t)(iend - ip) || len > (size_t)(oend - op))
+			return TEE_ERROR_BAD_FORMAT;
+		memcpy(op, ip, len);
+		ip += len;
+		op += len;
+
+		if (ip == iend)
+			break;
+
+		if (iend - ip < 2)
+			return TEE_ERROR_BAD_FORMAT;
+		offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if (!offset || offset > (size_t)(op - dst))
+			return TEE_ERROR_BAD_FORMAT;
+
+		len = token & 15;
+		if (len == 15 && !read_len(&ip, iend, &len))
+			return TEE_ERROR_BAD_FORMAT;
+		len += LZ4_MIN_MATCH;
+		if (len > (size_t)(oend - op))
+			return TEE_ERROR_BAD_FORMAT;
+
+		match = op - offset;
+		if (offset >= len) {
+			memcpy(op, match, len);
+			op += len;
+		} else {
+			/* Overlapping match, repeats the last @offset bytes */
+			while (len--)
+				*op++ = *match++;
+		}
+	}
+
+	*dst_len = op - dst;
+	return TEE_SUCCESS;
+}
@@ -10,6 +10,9 @@
 
 local uLong adler32_combine_ OF((uLong adler1, uLong adler2, z_off64_t len2));
 
+/* adler32_neon() is worth it from a few blocks of 32 bytes */
+#define NEON_MIN_LEN 64
+
 #define BASE 65521U     /* largest prime smaller than 65536 */
 #define NMAX 5552
 /* NMAX is the largest n such that 255n(n+1)/2 + (n+1)(BASE-1) <= 2^32-1 */
@@ -88,6 +91,11 @@ uLong ZEXPORT adler32_z(adler, buf, len)
     if (buf == Z_NULL)
         return 1L;
 
+#ifdef CFG_ZLIB_ARM_NEON
+    if (len >= NEON_MIN_LEN)
+        return adler32_neon(adler | (sum2 << 16), buf, len);
+#endif
+
     /* in case short lengths are provided, keep it somewhat fast */
     if (len < 16) {
         while (len--) {
@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2022, Microchip
+ */
+
+/*
+ * Adler-32 with NEON, glue code built general-regs-only around the kernel
+ * in adler32_neon_core.c
+ */
+
+#include <kernel/thread.h>
+#include <types_ext.h>
+#include <util.h>
+#include "adler32_neon.h"
+#include "zutil.h"
+
+#define BASE		65521U
+
+uLong ZLIB_INTERNAL adler32_neon(uLong adler, const Bytef *buf, z_size_t len)
+{
+	uint32_t s1 = adler & 0xffff;
+	uint32_t s2 = (adler >> 16) & 0xffff;
+	uint32_t vfp_state = 0;
+	size_t count = 0;
+
+	while (len >= ADLER32_NEON_BLOCK_SIZE) {
+		count = MIN(len / ADLER32_NEON_BLOCK_SIZE,
+			    (size_t)ADLER32_NEON_NMAX_BLOCKS);
+
+		/* Foreign interrupts are masked while the VFP is in use */
+		vfp_state = thread_kernel_enable_vfp();
+		adler32_neon_blocks(&s1, &s2, buf, count);
+		thread_kernel_disable_vfp(vfp_state);
+
+		buf += count * ADLER32_NEON_BLOCK_SIZE;
+		len -= count * ADLER32_NEON_BLOCK_SIZE;
+	}
+
+	while (len--) {
+		s1 += *buf++;
+		s2 += s1;
+	}
+
+	return (s1 % BASE) | ((s2 % BASE) << 16);
+}
@@ -0,0 +1,26 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2022, Microchip
+ */
+
+#ifndef __ADLER32_NEON_H
+#define __ADLER32_NEON_H
+
+#include <types_ext.h>
+
+#define ADLER32_NEON_BLOCK_SIZE	32
+/*
+ * Largest number of blocks processed before the sums must be reduced
+ * modulo 65521, see NMAX in adler32.c
+ */
+#define ADLER32_NEON_NMAX_BLOCKS	(5552 / ADLER32_NEON_BLOCK_SIZE)
+
+/*
+ * Adds @count <= ADLER32_NEON_NMAX_BLOCKS blocks from @buf to the sums
+ * @s1 and @s2 and reduces them, see adler32_neon_core.c. Must be called
+ * with VFP enabled.
+ */
+void adler32_neon_blocks(uint32_t *s1, uint32_t *s2, const uint8_t *buf,
+			 size_t count);
+
+#endif /*__ADLER32_NEON_H*/
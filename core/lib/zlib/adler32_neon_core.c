@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2022, Microchip
+ */
+
+/*
+ * Adler-32 with NEON
+ *
+ * inflate() updates the Adler-32 checksum of a zlib stream with each
+ * chunk of output right after producing it, while it's still in the data
+ * cache. This computes the two sums 32 bytes at a time instead of one
+ * byte at a time: the byte sums are accumulated per lane and the weighted
+ * sum is obtained from per-column totals with a multiply-accumulate.
+ */
+
+#include <arm_neon.h>
+#include <types_ext.h>
+
+#include "adler32_neon.h"
+
+#define BASE		65521U
+
+/* Weight of each byte of a block in the second sum */
+static const uint16_t weights[ADLER32_NEON_BLOCK_SIZE] = {
+	32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17,
+	16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1,
+};
+
+static uint32_t sum_lanes(uint32x4_t v)
+{
+	uint32x2_t t = vadd_u32(vget_low_u32(v), vget_high_u32(v));
+
+	return vget_lane_u32(vpadd_u32(t, t), 0);
+}
+
+void adler32_neon_blocks(uint32_t *s1, uint32_t *s2, const uint8_t *buf,
+			 size_t count)
+{
+	uint32x4_t v_s1 = { };
+	uint32x4_t v_s2 = { };
+	uint16x8_t col0 = { };
+	uint16x8_t col1 = { };
+	uint16x8_t col2 = { };
+	uint16x8_t col3 = { };
+	uint8x16_t b0 = { };
+	uint8x16_t b1 = { };
+
+	/* Each byte of the blocks adds the current first sum to the second */
+	v_s2 = vsetq_lane_u32(*s1 * count, v_s2, 0);
+
+	do {
+		b0 = vld1q_u8(buf);
+		b1 = vld1q_u8(buf + 16);
+		/* Previous blocks count once more for each byte of this one */
+		v_s2 = vaddq_u32(v_s2, v_s1);
+		v_s1 = vpadalq_u16(v_s1, vpadalq_u8(vpaddlq_u8(b0), b1));
+		col0 = vaddw_u8(col0, vget_low_u8(b0));
+		col1 = vaddw_u8(col1, vget_high_u8(b0));
+		col2 = vaddw_u8(col2, vget_low_u8(b1));
+		col3 = vaddw_u8(col3, vget_high_u8(b1));
+		buf += ADLER32_NEON_BLOCK_SIZE;
+	} while (--count);
+
+	v_s2 = vshlq_n_u32(v_s2, 5);
+	v_s2 = vmlal_u16(v_s2, vget_low_u16(col0), vld1_u16(weights));
+	v_s2 = vmlal_u16(v_s2, vget_high_u16(col0), vld1_u16(weights + 4));
+	v_s2 = vmlal_u16(v_s2, vget_low_u16(col1), vld1_u16(weights + 8));
+	v_s2 = vmlal_u16(v_s2, vget_high_u16(col1), vld1_u16(weights + 12));
+	v_s2 = vmlal_u16(v_s2, vget_low_u16(col2), vld1_u16(weights + 16));
+	v_s2 = vmlal_u16(v_s2, vget_high_u16(col2), vld1_u16(weights + 20));
+	v_s2 = vmlal_u16(v_s2, vget_low_u16(col3), vld1_u16(weights + 24));
+	v_s2 = vmlal_u16(v_s2, vget_high_u16(col3), vld1_u16(weights + 28));
+
+	*s1 = (*s1 + sum_lanes(v_s1)) % BASE;
+	*s2 = (*s2 + sum_lanes(v_s2)) % BASE;
+}
@@ -8,11 +8,81 @@
 #include "inftrees.h"
 #include "inflate.h"
 #include "inffast.h"
+#include <string.h>
 
 #ifdef ASMINF
 #  pragma message("Assembler code may have bugs -- use at your own risk")
 #else
 
+#ifdef INFLATE_FAST_REFILL64
+/* Unaligned little-endian load of 8 bytes of input */
+local unsigned long load_le64(const unsigned char FAR *p)
+{
+    unsigned long v;
+
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+#endif
+
+#ifdef INFLATE_FAST_REFILL32
+/* Unaligned little-endian load of 4 bytes of input */
+local unsigned long load_le32(const unsigned char FAR *p)
+{
+    unsigned long v;
+
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+#endif
+
+/*
+   Copy a match of len bytes starting dist bytes back from out, where all
+   the bytes are in the output buffer, and return the new out. With a
+   distance of at least 8 or 16 bytes the source and destination of each
+   8 or 16 byte chunk don't overlap, so they are copied with wide unaligned
+   loads and stores. This may write up to INFLATE_FAST_CHUNK - 1 bytes past
+   the end of the match, which inflate_fast() has room for.
+ */
+local unsigned char FAR *copy_match(unsigned char FAR *out, unsigned dist,
+                                    unsigned len)
+{
+    unsigned char FAR *from = out - dist;
+    unsigned char FAR *end = out + len;
+
+    if (dist >= 16) {
+        do {
+            memcpy(out, from, 16);
+            out += 16;
+            from += 16;
+        } while (out < end);
+    }
+    else if (dist >= 8) {
+        do {
+            memcpy(out, from, 8);
+            out += 8;
+            from += 8;
+        } while (out < end);
+    }
+    else if (dist == 1) {
+        memset(out, *from, len);
+    }
+    else {
+        do {                        /* minimum length is three */
+            *out++ = *from++;
+            *out++ = *from++;
+            *out++ = *from++;
+            len -= 3;
+        } while (len > 2);
+        if (len) {
+            *out++ = *from++;
+            if (len > 1)
+                *out++ = *from++;
+        }
+    }
+    return end;
+}
+
 /*
    Decode literal, length, and distance codes and write out the resulting
    literal and match bytes until either not enough input or output is
@@ -24,8 +94,8 @@
    Entry assumptions:
 
         state->mode == LEN
-        strm->avail_in >= 6
-        strm->avail_out >= 258
+        strm->avail_in >= INFLATE_FAST_MIN_INPUT
+        strm->avail_out >= INFLATE_FAST_MIN_OUTPUT
         start >= strm->avail_out
         state->bits < 8
 
@@ -43,10 +113,23 @@
       Therefore if strm->avail_in >= 6, then there is enough input to avoid
       checking for available input while decoding.
 
+    - With INFLATE_FAST_REFILL64, the bit buffer is topped up to at least 56
+      bits with a single 8-byte load at the start of each loop, which is
+      enough for a whole length/distance pair. strm->avail_in >= 8 makes
+      that load safe.
+
+    - With INFLATE_FAST_REFILL32, the bit buffer is topped up to at least 24
+      bits with a single 4-byte load at the start of each loop, the rest of
+      the length/distance pair is read a byte at a time as before. Since the
+      bits above bits in hold may then be the next input bits rather than
+      zero, the bytes are or'ed into hold. That load and the bytes after it
+      stay within the six bytes above.
+
     - The maximum bytes that a single length/distance pair can output is 258
       bytes, which is the maximum length that can be coded.  inflate_fast()
       requires strm->avail_out >= 258 for each loop to avoid checking for
-      output space.
+      output space, plus the INFLATE_FAST_CHUNK bytes copy_match() may write
+      past the end of a match.
  */
 void ZLIB_INTERNAL inflate_fast(strm, start)
 z_streamp strm;
@@ -81,10 +164,10 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
     /* copy state to local variables */
     state = (struct inflate_state FAR *)strm->state;
     in = strm->next_in;
-    last = in + (strm->avail_in - 5);
+    last = in + (strm->avail_in - (INFLATE_FAST_MIN_INPUT - 1));
     out = strm->next_out;
     beg = out - (start - strm->avail_out);
-    end = out + (strm->avail_out - 257);
+    end = out + (strm->avail_out - (INFLATE_FAST_MIN_OUTPUT - 1));
 #ifdef INFLATE_STRICT
     dmax = state->dmax;
 #endif
@@ -102,12 +185,24 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
     /* decode literals and length/distances until end-of-block or not enough
        input data or output space */
     do {
+#ifdef INFLATE_FAST_REFILL64
+        /* the bits above bits in hold are the next input bits, so they
+           are the same in the loaded word */
+        hold |= load_le64(in) << bits;
+        in += (63 - bits) >> 3;
+        bits |= 56;
+#elif defined(INFLATE_FAST_REFILL32)
+        hold |= load_le32(in) << bits;
+        in += (31 - bits) >> 3;
+        bits |= 24;
+#else
         if (bits < 15) {
             hold += (unsigned long)(*in++) << bits;
             bits += 8;
             hold += (unsigned long)(*in++) << bits;
             bits += 8;
         }
+#endif
         here = lcode[hold & lmask];
       dolen:
         op = (unsigned)(here.bits);
@@ -125,7 +220,7 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
             op &= 15;                           /* number of extra bits */
             if (op) {
                 if (bits < op) {
-                    hold += (unsigned long)(*in++) << bits;
+                    hold |= (unsigned long)(*in++) << bits;
                     bits += 8;
                 }
                 len += (unsigned)hold & ((1U << op) - 1);
@@ -133,12 +228,14 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
                 bits -= op;
             }
             Tracevv((stderr, "inflate:         length %u\n", len));
+#ifndef INFLATE_FAST_REFILL64
             if (bits < 15) {
-                hold += (unsigned long)(*in++) << bits;
+                hold |= (unsigned long)(*in++) << bits;
                 bits += 8;
-                hold += (unsigned long)(*in++) << bits;
+                hold |= (unsigned long)(*in++) << bits;
                 bits += 8;
             }
+#endif
             here = dcode[hold & dmask];
           dodist:
             op = (unsigned)(here.bits);
@@ -149,10 +246,10 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
                 dist = (unsigned)(here.val);
                 op &= 15;                       /* number of extra bits */
                 if (bits < op) {
-                    hold += (unsigned long)(*in++) << bits;
+                    hold |= (unsigned long)(*in++) << bits;
                     bits += 8;
                     if (bits < op) {
-                        hold += (unsigned long)(*in++) << bits;
+                        hold |= (unsigned long)(*in++) << bits;
                         bits += 8;
                     }
                 }
@@ -249,19 +346,8 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
                             *out++ = *from++;
                     }
                 }
-                else {
-                    from = out - dist;          /* copy direct from output */
-                    do {                        /* minimum length is three */
-                        *out++ = *from++;
-                        *out++ = *from++;
-                        *out++ = *from++;
-                        len -= 3;
-                    } while (len > 2);
-                    if (len) {
-                        *out++ = *from++;
-                        if (len > 1)
-                            *out++ = *from++;
-                    }
+                else {                          /* copy direct from output */
+                    out = copy_match(out, dist, len);
                 }
             }
             else if ((op & 64) == 0) {          /* 2nd level distance code */
@@ -299,9 +385,12 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
     /* update state and return */
     strm->next_in = in;
     strm->next_out = out;
-    strm->avail_in = (unsigned)(in < last ? 5 + (last - in) : 5 - (in - last));
+    strm->avail_in = (unsigned)(in < last ?
+                                (INFLATE_FAST_MIN_INPUT - 1) + (last - in) :
+                                (INFLATE_FAST_MIN_INPUT - 1) - (in - last));
     strm->avail_out = (unsigned)(out < end ?
-                                 257 + (end - out) : 257 - (out - end));
+                                 (INFLATE_FAST_MIN_OUTPUT - 1) + (end - out) :
+                                 (INFLATE_FAST_MIN_OUTPUT - 1) - (out - end));
     state->hold = hold;
     state->bits = bits;
     return;
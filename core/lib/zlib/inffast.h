@@ -10,3 +10,26 @@
  */
 
 void ZLIB_INTERNAL inflate_fast OF((z_streamp strm, unsigned start));
+
+/* inflate_fast() refills the bit buffer with a single unaligned load of
+   input instead of one byte at a time: 8 bytes with a 64-bit bit buffer,
+   4 bytes with a 32-bit one. */
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#  ifdef __LP64__
+#    define INFLATE_FAST_REFILL64
+#  else
+#    define INFLATE_FAST_REFILL32
+#  endif
+#endif
+
+/* Input and output space inflate_fast() needs on entry. Beyond the 258
+   bytes of the longest match, matches are copied in chunks of up to
+   INFLATE_FAST_CHUNK bytes which may write that many bytes past the end
+   of the match. */
+#define INFLATE_FAST_CHUNK 16
+#ifdef INFLATE_FAST_REFILL64
+#  define INFLATE_FAST_MIN_INPUT 8
+#else
+#  define INFLATE_FAST_MIN_INPUT 6
+#endif
+#define INFLATE_FAST_MIN_OUTPUT (258 + INFLATE_FAST_CHUNK)
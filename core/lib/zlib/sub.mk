@@ -6,3 +6,18 @@ srcs-y += inftrees.c
 srcs-y += zutil.c
 cflags-remove-y += -Wold-style-definition
 cflags-remove-y += -Wswitch-default
+
+ifeq ($(CFG_ZLIB_ARM_NEON),y)
+srcs-y += adler32_neon.c
+srcs-y += adler32_neon_core.c
+cflags-adler32_neon_core.c-y += $(core-neon-cflags)
+cflags-remove-adler32_neon_core.c-y += $(core-neon-cflags-remove)
+endif
+
+# inflate_fast() loads input and copies matches with unaligned accesses,
+# which are allowed unless CFG_SCTLR_ALIGNMENT_CHECK=y. Nothing is inflated
+# before the MMU is enabled.
+ifneq ($(CFG_SCTLR_ALIGNMENT_CHECK),y)
+cflags-remove-inffast.c-$(CFG_ARM64_core) += -mstrict-align
+cflags-remove-inffast.c-$(CFG_ARM32_core) += -mno-unaligned-access
+endif
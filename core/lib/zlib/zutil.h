@@ -269,4 +269,10 @@ extern z_const char * const z_errmsg[10]; /* indexed by 2-zlib_error */
 #define ZSWAP32(q) ((((q) >> 24) & 0xff) + (((q) >> 8) & 0xff00) + \
                     (((q) & 0xff00) << 8) + (((q) & 0xff) << 24))
 
+#ifdef CFG_ZLIB_ARM_NEON
+/* Adler-32 with NEON, see adler32_neon.c */
+uLong ZLIB_INTERNAL adler32_neon OF((uLong adler, const Bytef *buf,
+                                     z_size_t len));
+#endif
+
 #endif /* ZUTIL_H */
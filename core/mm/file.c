@@ -24,6 +24,8 @@ struct file_slice_elem {
  * @taglen:	Byte length of @tag
  * @refc:	Reference counter
  * @link:	Linked list element
+ * @cache_link:	Linked list element in the cache of released files
+ * @cached:	True if @f is in the cache of released files
  * @num_slices:	Number of elements in the @slices array below
  * @slices:	Array of file slices holding the fobjs of this file
  *
@@ -36,6 +38,8 @@ struct file {
 	unsigned int taglen;
 	struct refcount refc;
 	TAILQ_ENTRY(file) link;
+	TAILQ_ENTRY(file) cache_link;
+	bool cached;
 	struct mutex mu;
 	SLIST_HEAD(, file_slice_elem) slice_head;
 };
@@ -43,6 +47,15 @@ struct file {
 static struct mutex file_mu = MUTEX_INITIALIZER;
 static TAILQ_HEAD(, file) file_head = TAILQ_HEAD_INITIALIZER(file_head);
 
+/*
+ * Files retained with file_cache_retain(), most recently used first. Each
+ * file in the cache holds one reference of its own, protected by
+ * @file_mu.
+ */
+static TAILQ_HEAD(file_cache_head, file) file_cache =
+	TAILQ_HEAD_INITIALIZER(file_cache);
+static size_t file_cache_count;
+
 static int file_tag_cmp(const struct file *f, const uint8_t *tag,
 			unsigned int taglen)
 {
@@ -176,6 +189,84 @@ void file_put(struct file *f)
 
 }
 
+void file_cache_retain(struct file *f)
+{
+	struct file *evicted = NULL;
+
+	if (!CFG_TA_BIN_CACHE_COUNT)
+		return;
+
+	mutex_lock(&file_mu);
+
+	if (f->cached) {
+		TAILQ_REMOVE(&file_cache, f, cache_link);
+	} else {
+		file_get(f);
+		f->cached = true;
+		file_cache_count++;
+	}
+	TAILQ_INSERT_HEAD(&file_cache, f, cache_link);
+
+	if (file_cache_count > CFG_TA_BIN_CACHE_COUNT) {
+		evicted = TAILQ_LAST(&file_cache, file_cache_head);
+		TAILQ_REMOVE(&file_cache, evicted, cache_link);
+		evicted->cached = false;
+		file_cache_count--;
+	}
+
+	mutex_unlock(&file_mu);
+
+	/* file_put() may need file_mu to free the file */
+	file_put(evicted);
+}
+
+void file_cache_release(struct file *f)
+{
+	bool cached = false;
+
+	mutex_lock(&file_mu);
+	cached = f->cached;
+	if (cached) {
+		TAILQ_REMOVE(&file_cache, f, cache_link);
+		f->cached = false;
+		file_cache_count--;
+	}
+	mutex_unlock(&file_mu);
+
+	if (cached)
+		file_put(f);
+}
+
+static struct file *file_cache_pop(void)
+{
+	struct file *f = NULL;
+
+	mutex_lock(&file_mu);
+	f = TAILQ_FIRST(&file_cache);
+	if (f) {
+		TAILQ_REMOVE(&file_cache, f, cache_link);
+		f->cached = false;
+		file_cache_count--;
+	}
+	mutex_unlock(&file_mu);
+
+	return f;
+}
+
+bool file_cache_flush(void)
+{
+	struct file *f = file_cache_pop();
+	bool flushed = false;
+
+	while (f) {
+		file_put(f);
+		flushed = true;
+		f = file_cache_pop();
+	}
+
+	return flushed;
+}
+
 struct file_slice *file_find_slice(struct file *f, unsigned int page_offset)
 {
 	struct file_slice_elem *fse = NULL;
@@ -11,6 +11,7 @@
 #include <kernel/panic.h>
 #include <mm/core_memprot.h>
 #include <mm/core_mmu.h>
+#include <mm/file.h>
 #include <mm/fobj.h>
 #include <mm/tee_mm.h>
 #include <stdlib.h>
@@ -19,6 +20,10 @@
 #include <types_ext.h>
 #include <util.h>
 
+#ifdef CFG_EARLY_TA_PAGED
+#include <lz4.h>
+#endif
+
 #ifdef CFG_WITH_PAGER
 
 #define RWP_AE_KEY_BITS		256
@@ -678,6 +683,110 @@ __weak __rodata_unpaged("ops_ro_reloc_paged") = {
 };
 #endif /*CFG_CORE_ASLR*/
 
+#ifdef CFG_EARLY_TA_PAGED
+/*
+ * Read-only pages which are compressed one by one with LZ4. The
+ * compressed page @page_idx is found at @store + @offs[@page_idx] and
+ * ends at @store + @offs[@page_idx + 1]. A page which didn't shrink when
+ * compressed is stored as is and has a length of SMALL_PAGE_SIZE.
+ *
+ * @hashes, @offs and @store are owned by the caller and must outlive the
+ * fobj.
+ */
+struct fobj_ro_lz4_paged {
+	const uint8_t *hashes;
+	const uint32_t *offs;
+	const uint8_t *store;
+	size_t store_size;
+	struct fobj fobj;
+};
+
+const struct fobj_ops ops_ro_lz4_paged;
+
+struct fobj *fobj_ro_lz4_paged_alloc(unsigned int num_pages,
+				     const void *hashes, const uint32_t *offs,
+				     const void *store, size_t store_size)
+{
+	struct fobj_ro_lz4_paged *rlp = NULL;
+
+	assert(num_pages && hashes && offs && store);
+
+	rlp = calloc(1, sizeof(*rlp));
+	if (!rlp)
+		return NULL;
+
+	rlp->hashes = hashes;
+	rlp->offs = offs;
+	rlp->store = store;
+	rlp->store_size = store_size;
+	fobj_init(&rlp->fobj, &ops_ro_lz4_paged, num_pages);
+
+	return &rlp->fobj;
+}
+
+static struct fobj_ro_lz4_paged *to_rlp(struct fobj *fobj)
+{
+	assert(fobj->ops == &ops_ro_lz4_paged);
+
+	return container_of(fobj, struct fobj_ro_lz4_paged, fobj);
+}
+
+static void rlp_free(struct fobj *fobj)
+{
+	struct fobj_ro_lz4_paged *rlp = to_rlp(fobj);
+
+	fobj_uninit(fobj);
+	free(rlp);
+}
+
+static TEE_Result rlp_load_page(struct fobj *fobj, unsigned int page_idx,
+				void *va)
+{
+	struct fobj_ro_lz4_paged *rlp = to_rlp(fobj);
+	const uint8_t *hash = rlp->hashes + page_idx * TEE_SHA256_HASH_SIZE;
+	uint32_t start = rlp->offs[page_idx];
+	uint32_t end = rlp->offs[page_idx + 1];
+	const uint8_t *src = NULL;
+	size_t src_len = 0;
+	size_t len = SMALL_PAGE_SIZE;
+	TEE_Result res = TEE_SUCCESS;
+
+	assert(refcount_val(&fobj->refc));
+	assert(page_idx < fobj->num_pages);
+
+	if (end <= start || end > rlp->store_size)
+		return TEE_ERROR_BAD_FORMAT;
+	src = rlp->store + start;
+	src_len = end - start;
+	if (src_len > SMALL_PAGE_SIZE)
+		return TEE_ERROR_BAD_FORMAT;
+
+	if (src_len == SMALL_PAGE_SIZE) {
+		memcpy(va, src, SMALL_PAGE_SIZE);
+	} else {
+		res = lz4_decompress_block(src, src_len, va, &len);
+		if (res)
+			return res;
+		if (len != SMALL_PAGE_SIZE)
+			return TEE_ERROR_BAD_FORMAT;
+	}
+
+	return hash_sha256_check(hash, va, SMALL_PAGE_SIZE);
+}
+DECLARE_KEEP_PAGER(rlp_load_page);
+
+/*
+ * Note: this variable is weak just to ease breaking its dependency chain
+ * when added to the unpaged area.
+ */
+const struct fobj_ops ops_ro_lz4_paged
+__weak __rodata_unpaged("ops_ro_lz4_paged") = {
+	.free = rlp_free,
+	.load_page = rlp_load_page,
+	.save_page = rop_save_page, /* Direct reuse */
+};
+#endif /*CFG_EARLY_TA_PAGED*/
+
 const struct fobj_ops ops_locked_paged;
 
 struct fobj *fobj_locked_paged_alloc(unsigned int num_pages)
@@ -814,3 +923,23 @@ const struct fobj_ops ops_sec_mem __weak __rodata_unpaged("ops_sec_mem") = {
 };
 
 #endif /*PAGED_USER_TA*/
+
+static struct fobj *ta_mem_alloc(unsigned int num_pages)
+{
+#ifdef CFG_PAGED_USER_TA
+	return fobj_rw_paged_alloc(num_pages);
+#else
+	return fobj_sec_mem_alloc(num_pages);
+#endif
+}
+
+struct fobj *fobj_ta_mem_alloc(unsigned int num_pages)
+{
+	struct fobj *f = ta_mem_alloc(num_pages);
+
+	/* Cached TA binaries are the first to go when memory runs out */
+	if (!f && file_cache_flush())
+		f = ta_mem_alloc(num_pages);
+
+	return f;
+}
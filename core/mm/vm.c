@@ -36,6 +36,12 @@
 #include <kernel/tee_l2cc_mutex.h>
 #endif
 
+/*
+ * Above this size it's cheaper to invalidate all TLB entries of the ASID
+ * than to invalidate the parameter mappings one page at a time.
+ */
+#define PARAM_TLBI_MAX_SIZE	(64 * SMALL_PAGE_SIZE)
+
 #define TEE_MMU_UDATA_ATTR		(TEE_MATTR_VALID_BLOCK | \
 					 TEE_MATTR_PRW | TEE_MATTR_URW | \
 					 TEE_MATTR_SECURE)
@@ -163,25 +169,35 @@ static TEE_Result alloc_pgt(struct user_mode_ctx *uctx)
 	return TEE_SUCCESS;
 }
 
-static void rem_um_region(struct user_mode_ctx *uctx, struct vm_region *r)
+static struct pgt_cache *get_pgt_cache(struct user_mode_ctx *uctx)
 {
 	struct thread_specific_data *tsd = thread_get_tsd();
-	struct pgt_cache *pgt_cache = NULL;
-	vaddr_t begin = ROUNDDOWN(r->va, CORE_MMU_PGDIR_SIZE);
-	vaddr_t last = ROUNDUP(r->va + r->size, CORE_MMU_PGDIR_SIZE);
-	struct vm_region *r2 = NULL;
 
 	if (uctx->ts_ctx == tsd->ctx)
-		pgt_cache = &tsd->pgt_cache;
+		return &tsd->pgt_cache;
+	return NULL;
+}
 
-	if (mobj_is_paged(r->mobj)) {
+/*
+ * Clears the translation table entries of a region, the caller is
+ * responsible for the TLB invalidation unless the region is paged.
+ */
+static void clear_um_region(struct user_mode_ctx *uctx, struct vm_region *r)
+{
+	if (mobj_is_paged(r->mobj))
 		tee_pager_rem_um_region(uctx, r->va, r->size);
-	} else {
-		pgt_clear_ctx_range(pgt_cache, uctx->ts_ctx, r->va,
+	else
+		pgt_clear_ctx_range(get_pgt_cache(uctx), uctx->ts_ctx, r->va,
 				    r->va + r->size);
-		tlbi_mva_range_asid(r->va, r->size, SMALL_PAGE_SIZE,
-				    uctx->vm_info.asid);
-	}
+}
+
+/* Releases translation tables no longer used once @r is removed */
+static void flush_um_region_pgt(struct user_mode_ctx *uctx,
+				struct vm_region *r)
+{
+	vaddr_t begin = ROUNDDOWN(r->va, CORE_MMU_PGDIR_SIZE);
+	vaddr_t last = ROUNDUP(r->va + r->size, CORE_MMU_PGDIR_SIZE);
+	struct vm_region *r2 = NULL;
 
 	r2 = TAILQ_NEXT(r, link);
 	if (r2)
@@ -196,7 +212,17 @@ static void rem_um_region(struct user_mode_ctx *uctx, struct vm_region *r)
 	if (begin >= last)
 		return;
 
-	pgt_flush_ctx_range(pgt_cache, uctx->ts_ctx, r->va, r->va + r->size);
+	pgt_flush_ctx_range(get_pgt_cache(uctx), uctx->ts_ctx, r->va,
+			    r->va + r->size);
+}
+
+static void rem_um_region(struct user_mode_ctx *uctx, struct vm_region *r)
+{
+	clear_um_region(uctx, r);
+	if (!mobj_is_paged(r->mobj))
+		tlbi_mva_range_asid(r->va, r->size, SMALL_PAGE_SIZE,
+				    uctx->vm_info.asid);
+	flush_um_region_pgt(uctx, r);
 }
 
 static TEE_Result umap_add_region(struct vm_info *vmi, struct vm_region *reg,
@@ -843,17 +869,61 @@ TEE_Result vm_info_init(struct user_mode_ctx *uctx)
 
 void vm_clean_param(struct user_mode_ctx *uctx)
 {
-	struct vm_region *next_r;
-	struct vm_region *r;
+	struct vm_region *next_r = NULL;
+	struct vm_region *r = NULL;
+	vaddr_t begin = 0;
+	vaddr_t end = 0;
+
+	/*
+	 * Clear all parameter mappings first so the TLB can be invalidated
+	 * with a single range operation covering all of them.
+	 */
+	TAILQ_FOREACH(r, &uctx->vm_info.regions, link) {
+		if (!(r->flags & VM_FLAG_EPHEMERAL))
+			continue;
+		clear_um_region(uctx, r);
+		if (mobj_is_paged(r->mobj))
+			continue;
+		if (!end)
+			begin = r->va;
+		end = r->va + r->size;
+	}
+
+	if (end - begin > PARAM_TLBI_MAX_SIZE)
+		tlbi_asid(uctx->vm_info.asid);
+	else if (end)
+		tlbi_mva_range_asid(begin, end - begin, SMALL_PAGE_SIZE,
+				    uctx->vm_info.asid);
 
 	TAILQ_FOREACH_SAFE(r, &uctx->vm_info.regions, link, next_r) {
 		if (r->flags & VM_FLAG_EPHEMERAL) {
-			rem_um_region(uctx, r);
+			flush_um_region_pgt(uctx, r);
 			umap_remove_region(&uctx->vm_info, r);
 		}
 	}
 }
 
+/*
+ * Find where @mem was mapped by the previous invoke. Mapping it at the
+ * same address again keeps the address stable for the TA and lets it use
+ * the translation tables still cached for the context.
+ */
+static vaddr_t get_param_hint(struct user_mode_ctx *uctx,
+			      const struct param_mem *mem)
+{
+	const struct vm_param_hint *h = NULL;
+	size_t n = 0;
+
+	for (n = 0; n < ARRAY_SIZE(uctx->vm_info.param_hint); n++) {
+		h = uctx->vm_info.param_hint + n;
+		if (h->mobj == mem->mobj && h->offs == mem->offs &&
+		    h->size == mem->size)
+			return h->va;
+	}
+
+	return 0;
+}
+
 static void check_param_map_empty(struct user_mode_ctx *uctx __maybe_unused)
 {
 	struct vm_region *r = NULL;
@@ -985,15 +1055,30 @@ TEE_Result vm_map_param(struct user_mode_ctx *uctx, struct tee_ta_param *param,
 	check_param_map_empty(uctx);
 
 	for (n = 0; n < m; n++) {
-		vaddr_t va = 0;
+		const uint32_t prot = TEE_MATTR_PRW | TEE_MATTR_URW;
+		const uint32_t flags = VM_FLAG_EPHEMERAL | VM_FLAG_SHAREABLE;
+		vaddr_t va = get_param_hint(uctx, mem + n);
 
-		res = vm_map(uctx, &va, mem[n].size,
-			     TEE_MATTR_PRW | TEE_MATTR_URW,
-			     VM_FLAG_EPHEMERAL | VM_FLAG_SHAREABLE,
+		res = vm_map(uctx, &va, mem[n].size, prot, flags,
 			     mem[n].mobj, mem[n].offs);
+		if (res == TEE_ERROR_ACCESS_CONFLICT && va) {
+			/* The previous address is taken, pick another one */
+			va = 0;
+			res = vm_map(uctx, &va, mem[n].size, prot, flags,
+				     mem[n].mobj, mem[n].offs);
+		}
 		if (res)
 			goto out;
+
+		uctx->vm_info.param_hint[n] = (struct vm_param_hint){
+			.mobj = mem[n].mobj,
+			.offs = mem[n].offs,
+			.size = mem[n].size,
+			.va = va,
+		};
 	}
+	for (; n < TEE_NUM_PARAMS; n++)
+		uctx->vm_info.param_hint[n] = (struct vm_param_hint){ };
 
 	for (n = 0; n < TEE_NUM_PARAMS; n++) {
 		uint32_t param_type = TEE_PARAM_TYPE_GET(param->types, n);
@@ -1236,10 +1321,11 @@ void *vm_pa2va(const struct user_mode_ctx *uctx, paddr_t pa, size_t pa_size)
 TEE_Result vm_check_access_rights(const struct user_mode_ctx *uctx,
 				  uint32_t flags, uaddr_t uaddr, size_t len)
 {
-	uaddr_t a = 0;
+	struct vm_region *r = NULL;
 	uaddr_t end_addr = 0;
 	size_t addr_incr = MIN(CORE_MMU_USER_CODE_SIZE,
 			       CORE_MMU_USER_PARAM_SIZE);
+	uaddr_t a = 0;
 
 	if (ADD_OVERFLOW(uaddr, len, &end_addr))
 		return TEE_ERROR_ACCESS_DENIED;
@@ -1256,28 +1342,45 @@ TEE_Result vm_check_access_rights(const struct user_mode_ctx *uctx,
 	   !vm_buf_is_inside_um_private(uctx, (void *)uaddr, len))
 		return TEE_ERROR_ACCESS_DENIED;
 
-	for (a = ROUNDDOWN(uaddr, addr_incr); a < end_addr; a += addr_incr) {
-		uint32_t attr;
-		TEE_Result res;
-
-		res = tee_mmu_user_va2pa_attr(uctx, (void *)a, NULL, &attr);
-		if (res != TEE_SUCCESS)
-			return res;
+	/*
+	 * All pages of a region share the same attributes and the regions
+	 * are sorted by address, so each region covering the range is
+	 * checked once instead of each page of the range. Large buffers
+	 * passed to the crypto syscalls are checked in a single pass over
+	 * the regions and then used in place: no pinning is needed since
+	 * the TA, blocked in the syscall, can't change its mappings.
+	 */
+	a = ROUNDDOWN(uaddr, addr_incr);
+	TAILQ_FOREACH(r, &uctx->vm_info.regions, link) {
+		if (a >= end_addr)
+			break;
+		if (r->va + r->size <= a)
+			continue;
+		/* Hole in the range */
+		if (r->va > a)
+			return TEE_ERROR_ACCESS_DENIED;
 
 		if ((flags & TEE_MEMORY_ACCESS_NONSECURE) &&
-		    (attr & TEE_MATTR_SECURE))
+		    (r->attr & TEE_MATTR_SECURE))
 			return TEE_ERROR_ACCESS_DENIED;
 
 		if ((flags & TEE_MEMORY_ACCESS_SECURE) &&
-		    !(attr & TEE_MATTR_SECURE))
+		    !(r->attr & TEE_MATTR_SECURE))
 			return TEE_ERROR_ACCESS_DENIED;
 
-		if ((flags & TEE_MEMORY_ACCESS_WRITE) && !(attr & TEE_MATTR_UW))
+		if ((flags & TEE_MEMORY_ACCESS_WRITE) &&
+		    !(r->attr & TEE_MATTR_UW))
 			return TEE_ERROR_ACCESS_DENIED;
-		if ((flags & TEE_MEMORY_ACCESS_READ) && !(attr & TEE_MATTR_UR))
+		if ((flags & TEE_MEMORY_ACCESS_READ) &&
+		    !(r->attr & TEE_MATTR_UR))
 			return TEE_ERROR_ACCESS_DENIED;
+
+		a = r->va + r->size;
 	}
 
+	if (a < end_addr)
+		return TEE_ERROR_ACCESS_DENIED;
+
 	return TEE_SUCCESS;
 }
 
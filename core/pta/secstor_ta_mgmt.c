@@ -3,6 +3,7 @@
  * Copyright (c) 2017, Linaro Limited
  */
 
+#include <config.h>
 #include <kernel/pseudo_ta.h>
 #include <tee/tadb.h>
 #include <pta_secstor_ta_mgmt.h>
@@ -48,11 +49,22 @@ static TEE_Result install_ta(struct shdr *shdr, const uint8_t *nw,
 	void *buf;
 	struct tee_tadb_property property;
 	struct shdr_bootstrap_ta bs_ta;
+	struct shdr_compressed_ta chdr = { };
+	size_t hdr_size = sizeof(bs_ta) + SHDR_GET_SIZE(shdr);
+	bool compressed = false;
 
-	if (shdr->img_type != SHDR_BOOTSTRAP_TA)
+	/*
+	 * A compressed TA is stored compressed, the compression header
+	 * goes in the custom data of the TA in the database.
+	 */
+	compressed = IS_ENABLED(CFG_TA_COMPRESSION) &&
+		     shdr->img_type == SHDR_COMPRESSED_TA;
+	if (shdr->img_type != SHDR_BOOTSTRAP_TA && !compressed)
 		return TEE_ERROR_SECURITY;
+	if (compressed)
+		hdr_size += sizeof(chdr);
 
-	if (nw_size < (sizeof(struct shdr_bootstrap_ta) + SHDR_GET_SIZE(shdr)))
+	if (nw_size < hdr_size)
 		return TEE_ERROR_SECURITY;
 
 	if (shdr->hash_size > buf_size)
@@ -90,11 +102,23 @@ static TEE_Result install_ta(struct shdr *shdr, const uint8_t *nw,
 		goto err_free_hash_ctx;
 	offs += sizeof(bs_ta);
 
+	if (compressed) {
+		memcpy(&chdr, nw + offs, sizeof(chdr));
+		res = crypto_hash_update(hash_ctx, (uint8_t *)&chdr,
+					 sizeof(chdr));
+		if (res)
+			goto err_free_hash_ctx;
+		offs += sizeof(chdr);
+	}
+
 	memset(&property, 0, sizeof(property));
 	COMPILE_TIME_ASSERT(sizeof(property.uuid) == sizeof(bs_ta.uuid));
 	tee_uuid_from_octets(&property.uuid, bs_ta.uuid);
 	property.version = bs_ta.ta_version;
 	property.custom_size = 0;
+	if (compressed)
+		property.custom_size = sizeof(chdr) |
+				       TEE_TADB_CUSTOM_COMPRESSED;
 	property.bin_size = nw_size - offs;
 	DMSG("Installing %pUl", (void *)&property.uuid);
 
@@ -102,6 +126,12 @@ static TEE_Result install_ta(struct shdr *shdr, const uint8_t *nw,
 	if (res)
 		goto err_free_hash_ctx;
 
+	if (compressed) {
+		res = tee_tadb_ta_write(ta, &chdr, sizeof(chdr));
+		if (res)
+			goto err_ta_finalize;
+	}
+
 	while (offs < nw_size) {
 		size_t l = MIN(buf_size, nw_size - offs);
 
@@ -3,14 +3,24 @@
  * Copyright (c) 2015, Linaro Limited
  */
 #include <compiler.h>
+#ifdef CFG_CRYPTO_DRV_DISPATCH
+#include <drvcrypt_dispatch.h>
+#endif
 #include <stdio.h>
 #include <trace.h>
+#include <kernel/embedded_ts.h>
+#include <kernel/fast_smc.h>
 #include <kernel/pseudo_ta.h>
+#include <kernel/ree_fs_ta.h>
+#include <mm/mobj.h>
 #include <mm/tee_pager.h>
 #include <mm/tee_mm.h>
 #include <string.h>
 #include <string_ext.h>
 #include <malloc.h>
+#ifdef CFG_WITH_USER_TA
+#include <tee/tee_svc_cryp.h>
+#endif
 
 #define TA_NAME		"stats.ta"
 
@@ -21,6 +31,12 @@
 #define STATS_CMD_PAGER_STATS		0
 #define STATS_CMD_ALLOC_STATS		1
 #define STATS_CMD_MEMLEAK_STATS		2
+#define STATS_CMD_FAST_SMC_STATS	3
+#define STATS_CMD_REG_SHM_STATS		4
+#define STATS_CMD_CRYPTO_DISPATCH_STATS	5
+#define STATS_CMD_CRYP_CACHE_STATS	6
+#define STATS_CMD_TA_LOAD_STATS		7
+#define STATS_CMD_TA_INFLATE_STATS	8
 
 #define STATS_NB_POOLS			4
 
@@ -137,6 +153,228 @@ static TEE_Result get_memleak_stats(uint32_t type,
 	return TEE_SUCCESS;
 }
 
+#ifdef CFG_FAST_SMC_STATS
+static TEE_Result get_fast_smc_stats(uint32_t type,
+				     TEE_Param p[TEE_NUM_PARAMS])
+{
+	TEE_Result res = TEE_SUCCESS;
+	size_t count = 0;
+
+	/*
+	 * p[0].value.a = 0 if no reset of the stats
+	 * p[1].memref.buffer = output buffer to array of
+	 *			struct fast_smc_report
+	 */
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+			    TEE_PARAM_TYPE_MEMREF_OUTPUT,
+			    TEE_PARAM_TYPE_NONE,
+			    TEE_PARAM_TYPE_NONE) != type)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	count = p[1].memref.size / sizeof(struct fast_smc_report);
+	if (!IS_ALIGNED_WITH_TYPE(p[1].memref.buffer, struct fast_smc_report))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	res = fast_smc_get_stats(p[1].memref.buffer, &count, p[0].value.a);
+	p[1].memref.size = count * sizeof(struct fast_smc_report);
+
+	return res;
+}
+#else
+static TEE_Result get_fast_smc_stats(uint32_t type __unused,
+				     TEE_Param p[TEE_NUM_PARAMS] __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+#endif
+
+#if defined(CFG_CORE_DYN_SHM) && !defined(CFG_CORE_FFA)
+static TEE_Result get_reg_shm_stats(uint32_t type,
+				    TEE_Param p[TEE_NUM_PARAMS])
+{
+	struct mobj_reg_shm_stats stats = { };
+
+	/*
+	 * p[0].value.a = 0 if no reset of the stats
+	 * p[1].value.a = number of mappings, p[1].value.b = number of unmappings
+	 * p[2].value.a = number of mappings reused
+	 * p[2].value.b = number of mappings evicted
+	 * p[3].value.a = virtual address space held by unused mappings
+	 */
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT) != type)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	mobj_reg_shm_get_stats(&stats, p[0].value.a);
+	p[1].value.a = stats.maps;
+	p[1].value.b = stats.unmaps;
+	p[2].value.a = stats.reuses;
+	p[2].value.b = stats.evictions;
+	p[3].value.a = stats.idle_va_size;
+	p[3].value.b = 0;
+
+	return TEE_SUCCESS;
+}
+#else
+static TEE_Result get_reg_shm_stats(uint32_t type __unused,
+				    TEE_Param p[TEE_NUM_PARAMS] __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+#endif
+
+#ifdef CFG_CRYPTO_DRV_DISPATCH
+static TEE_Result get_crypto_dispatch_stats(uint32_t type,
+					    TEE_Param p[TEE_NUM_PARAMS])
+{
+	struct drvcrypt_dispatch_report *reports = NULL;
+	TEE_Result res = TEE_SUCCESS;
+	size_t count = 0;
+
+	/*
+	 * p[0].value.a = 0 if no reset of the requests counters
+	 * p[1].memref.buffer = output buffer to array of
+	 *			struct drvcrypt_dispatch_report
+	 */
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+			    TEE_PARAM_TYPE_MEMREF_OUTPUT,
+			    TEE_PARAM_TYPE_NONE,
+			    TEE_PARAM_TYPE_NONE) != type)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	reports = p[1].memref.buffer;
+	count = p[1].memref.size / sizeof(*reports);
+	if (!IS_ALIGNED_WITH_TYPE(reports, struct drvcrypt_dispatch_report))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	res = drvcrypt_dispatch_get_stats(reports, &count, p[0].value.a);
+	p[1].memref.size = count * sizeof(*reports);
+
+	return res;
+}
+#else
+static TEE_Result get_crypto_dispatch_stats(uint32_t type __unused,
+					    TEE_Param p[TEE_NUM_PARAMS] __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+#endif
+
+#ifdef CFG_WITH_USER_TA
+static TEE_Result get_cryp_cache_stats(uint32_t type,
+				       TEE_Param p[TEE_NUM_PARAMS])
+{
+	struct tee_cryp_cache_stats stats = { };
+
+	/*
+	 * p[0].value.a = 0 if no reset of the stats
+	 * p[1].value.a = number of MAC and cipher initializations done from
+	 *		  the context cached with the key object
+	 * p[1].value.b = number of MAC and cipher initializations done from
+	 *		  the key
+	 * p[2].value.a = number of digest contexts reused
+	 * p[2].value.b = number of digest contexts allocated
+	 */
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_NONE) != type)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	tee_svc_cryp_get_cache_stats(&stats, p[0].value.a);
+	p[1].value.a = stats.ks_hits;
+	p[1].value.b = stats.ks_misses;
+	p[2].value.a = stats.ctx_hits;
+	p[2].value.b = stats.ctx_misses;
+
+	return TEE_SUCCESS;
+}
+#else
+static TEE_Result get_cryp_cache_stats(uint32_t type __unused,
+				       TEE_Param p[TEE_NUM_PARAMS] __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+#endif
+
+#ifdef CFG_TA_LOAD_STATS
+static TEE_Result get_ta_load_stats(uint32_t type, TEE_Param p[TEE_NUM_PARAMS])
+{
+	struct ree_fs_ta_load_stats stats = { };
+
+	/*
+	 * p[0].value.a = 0 if no reset of the stats
+	 * p[1].value.a = number of TA binaries loaded from REE FS
+	 * p[1].value.b = usecs fetching the binaries from tee-supplicant
+	 * p[2].value.a = usecs verifying the signed headers
+	 * p[2].value.b = usecs decrypting encrypted binaries
+	 * p[3].value.a = usecs copying plain binaries from shared memory
+	 * p[3].value.b = usecs hashing the binaries
+	 */
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT) != type)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	ree_fs_ta_get_load_stats(&stats, p[0].value.a);
+	p[1].value.a = stats.count;
+	p[1].value.b = stats.rpc;
+	p[2].value.a = stats.verify;
+	p[2].value.b = stats.decrypt;
+	p[3].value.a = stats.copy;
+	p[3].value.b = stats.hash;
+
+	return TEE_SUCCESS;
+}
+#else
+static TEE_Result get_ta_load_stats(uint32_t type __unused,
+				    TEE_Param p[TEE_NUM_PARAMS] __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+#endif
+
+#ifdef CFG_TA_LOAD_STATS
+static TEE_Result get_ta_inflate_stats(uint32_t type,
+				       TEE_Param p[TEE_NUM_PARAMS])
+{
+	struct emb_ts_inflate_stats stats = { };
+
+	/*
+	 * p[0].value.a = 0 if no reset of the stats
+	 * p[1].value.a = number of compressed early TAs and SPs loaded
+	 * p[1].value.b = number of bytes inflated
+	 * p[2].value.a = usecs spent inflating
+	 * p[2].value.b = inflate throughput in KiB/s
+	 */
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_NONE) != type)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	emb_ts_get_inflate_stats(&stats, p[0].value.a);
+	p[1].value.a = stats.count;
+	p[1].value.b = stats.bytes;
+	p[2].value.a = stats.usecs;
+	if (stats.usecs)
+		p[2].value.b = stats.bytes * 1000000 / stats.usecs / 1024;
+	else
+		p[2].value.b = 0;
+
+	return TEE_SUCCESS;
+}
+#else
+static TEE_Result get_ta_inflate_stats(uint32_t type __unused,
+				       TEE_Param p[TEE_NUM_PARAMS] __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+#endif
+
 /*
  * Trusted Application Entry Points
  */
@@ -152,6 +390,18 @@ static TEE_Result invoke_command(void *psess __unused,
 		return get_alloc_stats(ptypes, params);
 	case STATS_CMD_MEMLEAK_STATS:
 		return get_memleak_stats(ptypes, params);
+	case STATS_CMD_FAST_SMC_STATS:
+		return get_fast_smc_stats(ptypes, params);
+	case STATS_CMD_REG_SHM_STATS:
+		return get_reg_shm_stats(ptypes, params);
+	case STATS_CMD_CRYPTO_DISPATCH_STATS:
+		return get_crypto_dispatch_stats(ptypes, params);
+	case STATS_CMD_CRYP_CACHE_STATS:
+		return get_cryp_cache_stats(ptypes, params);
+	case STATS_CMD_TA_LOAD_STATS:
+		return get_ta_load_stats(ptypes, params);
+	case STATS_CMD_TA_INFLATE_STATS:
+		return get_ta_inflate_stats(ptypes, params);
 	default:
 		break;
 	}
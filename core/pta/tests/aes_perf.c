@@ -7,11 +7,13 @@
 #include <crypto/crypto.h>
 #include <kernel/tee_time.h>
 #include <pta_invoke_tests.h>
+#include <stdio.h>
 #include <tee_api_defines.h>
 #include <tee_api_types.h>
 #include <trace.h>
 #include <types_ext.h>
 #include <utee_defines.h>
+#include <util.h>
 
 #include "misc.h"
 
@@ -158,6 +160,54 @@ static TEE_Result do_update(void *ctx, uint32_t algo, TEE_OperationMode mode,
 	return res;
 }
 
+uint64_t perf_get_time_us(void)
+{
+	TEE_Time t = { };
+
+	if (tee_time_get_sys_time(&t))
+		return 0;
+
+	return (uint64_t)t.seconds * 1000000 + t.millis * 1000;
+}
+
+void perf_report_throughput(const char *desc, uint64_t bytes, uint64_t us,
+			    TEE_Param *param)
+{
+	uint64_t mbps = 0;
+
+	if (!us)
+		us = 1;
+	/* One byte per microsecond is one MB/s */
+	mbps = bytes / us;
+
+	DMSG("%s: %"PRIu64" bytes in %"PRIu64" us, %"PRIu64".%02"PRIu64" GB/s",
+	     desc, bytes, us, mbps / 1000, (mbps % 1000) / 10);
+
+	if (param) {
+		param->value.a = MIN(us, (uint64_t)UINT32_MAX);
+		param->value.b = MIN(mbps, (uint64_t)UINT32_MAX);
+	}
+}
+
+static void report_throughput(uint32_t algo, TEE_OperationMode mode,
+			      size_t key_size_bits, uint64_t bytes,
+			      uint64_t us, TEE_Param *param)
+{
+	static const char * const names[] = {
+		[PTA_INVOKE_TESTS_AES_ECB] = "ECB",
+		[PTA_INVOKE_TESTS_AES_CBC] = "CBC",
+		[PTA_INVOKE_TESTS_AES_CTR] = "CTR",
+		[PTA_INVOKE_TESTS_AES_XTS] = "XTS",
+		[PTA_INVOKE_TESTS_AES_GCM] = "GCM",
+	};
+	char desc[32] = { };
+
+	snprintf(desc, sizeof(desc), "AES-%s-%zu %s", names[algo],
+		 key_size_bits,
+		 mode == TEE_MODE_ENCRYPT ? "encrypt" : "decrypt");
+	perf_report_throughput(desc, bytes, us, param);
+}
+
 TEE_Result core_aes_perf_tests(uint32_t param_types,
 			       TEE_Param params[TEE_NUM_PARAMS])
 {
@@ -165,15 +215,22 @@ TEE_Result core_aes_perf_tests(uint32_t param_types,
 						   TEE_PARAM_TYPE_VALUE_INPUT,
 						   TEE_PARAM_TYPE_MEMREF_INOUT,
 						   TEE_PARAM_TYPE_MEMREF_INOUT);
+	uint32_t exp_param_types_inout =
+		TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+				TEE_PARAM_TYPE_VALUE_INOUT,
+				TEE_PARAM_TYPE_MEMREF_INOUT,
+				TEE_PARAM_TYPE_MEMREF_INOUT);
 	TEE_Result res = TEE_SUCCESS;
 	TEE_OperationMode mode = 0;
 	unsigned int rep_count = 0;
 	unsigned int unit_size = 0;
 	size_t key_size_bits = 0;
+	uint64_t t = 0;
 	uint32_t algo = 0;
 	void *ctx = NULL;
 
-	if (param_types != exp_param_types)
+	if (param_types != exp_param_types &&
+	    param_types != exp_param_types_inout)
 		return TEE_ERROR_BAD_PARAMETERS;
 
 	switch (params[0].value.b) {
@@ -213,10 +270,18 @@ TEE_Result core_aes_perf_tests(uint32_t param_types,
 	if (res)
 		return res;
 
+	t = perf_get_time_us();
 	res = do_update(ctx, algo, mode, rep_count, unit_size,
 			params[2].memref.buffer, params[2].memref.size,
 			params[3].memref.buffer);
+	t = perf_get_time_us() - t;
 
 	free_ctx(&ctx, algo);
+
+	if (!res)
+		report_throughput(params[0].value.b, mode, key_size_bits,
+				  (uint64_t)rep_count * params[2].memref.size,
+				  t, param_types == exp_param_types_inout ?
+				  params + 1 : NULL);
 	return res;
 }
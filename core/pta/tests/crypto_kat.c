@@ -0,0 +1,515 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2022, Microchip
+ */
+
+/*
+ * Known answer tests run by core_self_tests(). They are mainly intended
+ * to check the accelerated implementations selected by the configuration,
+ * so the payloads span more blocks than any implementation processes in
+ * parallel and are passed in two updates of different size. Algorithms
+ * not available in the configuration are skipped.
+ */
+
+#include <crypto/crypto.h>
+#include <stdlib.h>
+#include <string.h>
+#include <tee_api_defines.h>
+#include <tee_api_types.h>
+#include <trace.h>
+#include <types_ext.h>
+#include <utee_defines.h>
+#include <util.h>
+
+#include "misc.h"
+
+/* Size of the first update, the remaining data is passed in a second one */
+#define KAT_FIRST_UPDATE	48
+
+/*
+ * The first block of kat_ptx and the first bytes of kat_key match the
+ * AES vectors of FIPS-197 Appendix C. The other expected results were
+ * computed with the Python cryptography package.
+ */
+
+static const uint8_t kat_ptx[] = {
+	0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+	0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+	0x05, 0x22, 0x3f, 0x5c, 0x79, 0x96, 0xb3, 0xd0,
+	0xed, 0x0a, 0x27, 0x44, 0x61, 0x7e, 0x9b, 0xb8,
+	0xd5, 0xf2, 0x0f, 0x2c, 0x49, 0x66, 0x83, 0xa0,
+	0xbd, 0xda, 0xf7, 0x14, 0x31, 0x4e, 0x6b, 0x88,
+	0xa5, 0xc2, 0xdf, 0xfc, 0x19, 0x36, 0x53, 0x70,
+	0x8d, 0xaa, 0xc7, 0xe4, 0x01, 0x1e, 0x3b, 0x58,
+	0x75, 0x92, 0xaf, 0xcc, 0xe9, 0x06, 0x23, 0x40,
+	0x5d, 0x7a, 0x97, 0xb4, 0xd1, 0xee, 0x0b, 0x28,
+	0x45, 0x62, 0x7f, 0x9c, 0xb9, 0xd6, 0xf3, 0x10,
+	0x2d, 0x4a, 0x67, 0x84, 0xa1, 0xbe, 0xdb, 0xf8,
+	0x15, 0x32, 0x4f, 0x6c, 0x89, 0xa6, 0xc3, 0xe0,
+	0xfd, 0x1a, 0x37, 0x54, 0x71, 0x8e, 0xab, 0xc8,
+	0xe5, 0x02, 0x1f, 0x3c, 0x59, 0x76, 0x93, 0xb0,
+	0xcd, 0xea, 0x07, 0x24, 0x41, 0x5e, 0x7b, 0x98,
+	0xb5, 0xd2, 0xef, 0x0c, 0x29, 0x46, 0x63, 0x80,
+	0x9d, 0xba, 0xd7, 0xf4, 0x11, 0x2e, 0x4b, 0x68,
+};
+
+static const uint8_t kat_key[] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+	0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+	0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+	0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+};
+
+static const uint8_t aes128_ecb_ctx[] = {
+	0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+	0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a,
+	0xed, 0x85, 0x87, 0x08, 0x8a, 0x84, 0xbd, 0x87,
+	0xa3, 0x21, 0x58, 0xed, 0xec, 0x30, 0x2c, 0xb4,
+	0x58, 0x78, 0xad, 0x0a, 0x7f, 0x4c, 0x48, 0xae,
+	0x10, 0xd4, 0x73, 0xb3, 0x9f, 0xe1, 0x75, 0x69,
+	0xf2, 0xdc, 0x6d, 0xb8, 0xff, 0xc1, 0x69, 0x4c,
+	0x45, 0x9b, 0x41, 0x47, 0xd0, 0x84, 0x58, 0x4b,
+	0x67, 0xf5, 0x92, 0x36, 0x42, 0x1c, 0x7b, 0x3f,
+	0x39, 0x3a, 0xa1, 0xf4, 0x19, 0x51, 0x23, 0x6e,
+	0xf0, 0x60, 0x25, 0xbf, 0x4e, 0x76, 0xab, 0x42,
+	0xbf, 0x68, 0x6b, 0x7d, 0x4f, 0x62, 0x39, 0x23,
+	0xd1, 0xc3, 0x70, 0x72, 0x97, 0x98, 0x59, 0x0f,
+	0xe4, 0x22, 0x92, 0xab, 0x90, 0x71, 0xce, 0xd0,
+	0x58, 0xd2, 0x12, 0x0f, 0x18, 0x31, 0xd4, 0x33,
+	0xa5, 0xcf, 0xa3, 0x3d, 0x5b, 0xff, 0xad, 0xef,
+	0x64, 0xd8, 0xca, 0xc7, 0xe8, 0x22, 0xa0, 0xbf,
+	0xcf, 0x2d, 0xaf, 0xf3, 0xc4, 0xe1, 0x1e, 0xa0,
+};
+
+static const uint8_t aes192_ecb_ctx[] = {
+	0xdd, 0xa9, 0x7c, 0xa4, 0x86, 0x4c, 0xdf, 0xe0,
+	0x6e, 0xaf, 0x70, 0xa0, 0xec, 0x0d, 0x71, 0x91,
+};
+
+static const uint8_t aes256_ecb_ctx[] = {
+	0x8e, 0xa2, 0xb7, 0xca, 0x51, 0x67, 0x45, 0xbf,
+	0xea, 0xfc, 0x49, 0x90, 0x4b, 0x49, 0x60, 0x89,
+};
+
+static const uint8_t kat_iv[] = {
+	0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+	0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff,
+};
+
+static const uint8_t aes128_cbc_ctx[] = {
+	0x77, 0x02, 0xfc, 0x9b, 0x71, 0xc6, 0x3d, 0x26,
+	0xa2, 0xf0, 0x9d, 0xf5, 0xc4, 0x45, 0x10, 0x2a,
+	0x73, 0x6e, 0x5d, 0xde, 0xfa, 0x8d, 0x43, 0xe6,
+	0xde, 0x59, 0x89, 0xf0, 0xb8, 0xc7, 0x6a, 0x9a,
+	0xd4, 0x0b, 0xd8, 0x3c, 0x94, 0xac, 0x16, 0x6c,
+	0xc3, 0xcf, 0x6d, 0x5c, 0xb3, 0xa9, 0x90, 0xc1,
+	0x2d, 0x95, 0x25, 0xb2, 0x2a, 0xd6, 0x1b, 0x33,
+	0x09, 0x10, 0x84, 0x37, 0xdf, 0x56, 0x0e, 0x68,
+	0x06, 0x2f, 0xdf, 0xa6, 0x3e, 0x49, 0x51, 0x98,
+	0x10, 0x32, 0xa8, 0x0a, 0xbf, 0xa3, 0xca, 0xe1,
+	0x16, 0x37, 0xf1, 0x8e, 0x94, 0x50, 0xef, 0x13,
+	0xc8, 0xdb, 0xad, 0x04, 0x6f, 0x2a, 0x13, 0xe1,
+	0x1c, 0xe6, 0x93, 0x3d, 0x5c, 0xa9, 0xe9, 0xdb,
+	0x5d, 0xd9, 0x58, 0x8b, 0xff, 0xee, 0xcf, 0x96,
+	0xf6, 0xc3, 0xa6, 0x15, 0x43, 0x9d, 0x38, 0x9a,
+	0x75, 0x54, 0x67, 0x41, 0xce, 0x0d, 0xf5, 0xe1,
+	0x70, 0x5a, 0xd6, 0x7b, 0x7a, 0x67, 0x9a, 0x13,
+	0xca, 0x57, 0x99, 0x7d, 0xc3, 0xcf, 0x43, 0xf1,
+};
+
+static const uint8_t aes_ctr_iv[] = {
+	0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfc,
+};
+
+static const uint8_t aes128_ctr_ctx[] = {
+	0xaf, 0x7e, 0xd0, 0x0f, 0xcf, 0x76, 0xee, 0x2b,
+	0x87, 0xe6, 0xd9, 0x2a, 0x08, 0x3a, 0x53, 0xb0,
+	0xfb, 0x65, 0xbf, 0xcc, 0xea, 0x04, 0xc3, 0x39,
+	0x01, 0xfa, 0x03, 0x2e, 0x82, 0xfb, 0x85, 0xeb,
+	0x0a, 0xc3, 0x1d, 0xd1, 0x8c, 0x71, 0xe7, 0xf1,
+	0x5c, 0xf1, 0xdb, 0x4c, 0x43, 0x0d, 0x5d, 0xca,
+	0x14, 0x09, 0x06, 0x99, 0xcc, 0x22, 0xc1, 0x54,
+	0x53, 0x77, 0xd6, 0x35, 0x89, 0x37, 0xe5, 0x3c,
+	0xb5, 0xa3, 0xd1, 0x6d, 0xea, 0x3a, 0x8e, 0x6a,
+	0xaf, 0x76, 0x1d, 0x06, 0x6a, 0xdc, 0xd8, 0x82,
+	0x84, 0xa1, 0x18, 0x21, 0x41, 0x72, 0x2d, 0x31,
+	0xdc, 0xbe, 0x90, 0x46, 0xe1, 0x46, 0x43, 0xfa,
+	0x47, 0x64, 0x72, 0xf7, 0x20, 0xcb, 0xc3, 0x08,
+	0x7d, 0xb2, 0x80, 0xbf, 0xa7, 0xb1, 0xb8, 0xa2,
+	0x00, 0x05, 0xf1, 0xb3, 0x5d, 0x59, 0xf1, 0xfd,
+	0x9c, 0xab, 0xdc, 0x81, 0xbf, 0x2b, 0x10, 0x05,
+	0x72, 0x08, 0x70, 0xda, 0x3b, 0x3e, 0x1e, 0x4c,
+	0x95, 0xb4, 0x96, 0xbe, 0xf7, 0x2a, 0x92, 0x7a,
+};
+
+static const uint8_t aes128_xts_ctx[] = {
+	0x8f, 0xca, 0x08, 0x41, 0x39, 0x8d, 0x8b, 0xb6,
+	0x72, 0xa7, 0x17, 0xaa, 0xbb, 0xdc, 0xc9, 0xf8,
+	0x7b, 0x0d, 0x51, 0x38, 0xf0, 0x9f, 0x0b, 0x8f,
+	0x1a, 0x76, 0x24, 0xa5, 0x2d, 0x3c, 0x99, 0x7b,
+	0xd6, 0x68, 0x5f, 0x08, 0x6e, 0x93, 0x65, 0xb8,
+	0x1a, 0xd1, 0x05, 0x69, 0xe8, 0x59, 0x34, 0x1f,
+	0xb7, 0xab, 0x5c, 0xe1, 0x34, 0x67, 0xc0, 0x03,
+	0xa9, 0x3e, 0x87, 0x9d, 0x2b, 0x31, 0xa8, 0xdf,
+	0x0f, 0xe5, 0x29, 0x56, 0x78, 0x08, 0xd7, 0x45,
+	0x18, 0x19, 0xec, 0x0f, 0x6e, 0xc3, 0x30, 0xe0,
+	0x92, 0x5a, 0x74, 0x26, 0xea, 0x6b, 0xca, 0x68,
+	0xf5, 0x75, 0x37, 0x22, 0xb1, 0x4f, 0x50, 0x58,
+	0xcb, 0x98, 0xeb, 0xa7, 0x47, 0x88, 0x4d, 0xcc,
+	0x9c, 0x49, 0x78, 0x72, 0xc7, 0xdd, 0x72, 0x24,
+	0xfc, 0xe7, 0xa4, 0x2f, 0x22, 0xda, 0xaa, 0xe1,
+	0x94, 0x1a, 0x2f, 0x8a, 0x45, 0xa1, 0xee, 0x39,
+	0x14, 0x07, 0x54, 0xe1, 0x14, 0xe7, 0x0e, 0x0c,
+	0x61, 0xac, 0x47, 0xd8, 0x3c, 0x09, 0x69, 0x73,
+};
+
+static const uint8_t aes128_gcm_ctx[] = {
+	0x11, 0x0b, 0xc4, 0x40, 0x7e, 0x8d, 0x03, 0x03,
+	0xbb, 0x65, 0x95, 0x0b, 0x1b, 0xdd, 0x43, 0x88,
+	0x40, 0xad, 0x1c, 0x68, 0x92, 0x5d, 0x44, 0x9d,
+	0x35, 0xbb, 0xf2, 0x0f, 0x05, 0xcf, 0x83, 0x1a,
+	0xc7, 0x94, 0xe2, 0x2d, 0x25, 0xfd, 0x7a, 0xc5,
+	0x2b, 0xc2, 0x87, 0x46, 0x85, 0x3b, 0x9a, 0x58,
+	0x9c, 0x84, 0x73, 0x78, 0x96, 0x21, 0x0a, 0x9e,
+	0x03, 0x32, 0x5f, 0xf2, 0xcc, 0x73, 0xa7, 0x89,
+	0x06, 0xfb, 0xad, 0xfa, 0xd5, 0x57, 0xba, 0x3f,
+	0x29, 0x9a, 0x28, 0x55, 0x48, 0xa5, 0xe6, 0x9b,
+	0x01, 0x6a, 0xb1, 0xe8, 0x08, 0x74, 0xa7, 0x48,
+	0x05, 0xad, 0xed, 0xab, 0xc3, 0x2e, 0xbb, 0xa9,
+	0xd4, 0x20, 0xa4, 0xee, 0x52, 0x78, 0xc2, 0x3c,
+	0x6b, 0x7c, 0x99, 0x42, 0x00, 0x39, 0x05, 0x7c,
+	0xa5, 0x44, 0x9d, 0x15, 0x7b, 0xd3, 0x24, 0x97,
+	0xd3, 0xef, 0xfe, 0x4f, 0xd1, 0x3e, 0xdc, 0x38,
+	0xdf, 0x65, 0xad, 0xf3, 0x20, 0x8a, 0xce, 0x9f,
+	0xe4, 0x97, 0xff, 0x80, 0x63, 0xfb, 0x49, 0x60,
+};
+
+static const uint8_t aes128_gcm_tag[] = {
+	0xdf, 0x73, 0xf5, 0xcd, 0x37, 0x86, 0x80, 0xdf,
+	0x0e, 0x84, 0x5c, 0xb4, 0x17, 0xe6, 0xd3, 0x2e,
+};
+
+static const uint8_t aes_gcm_aad[] = {
+	0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7,
+	0xa8, 0xa9, 0xaa, 0xab, 0xac, 0xad, 0xae, 0xaf,
+	0xb0, 0xb1, 0xb2, 0xb3,
+};
+
+static const uint8_t sm4_ecb_ctx[] = {
+	0x74, 0xc0, 0x46, 0x04, 0x81, 0x61, 0xbb, 0xf3,
+	0xd4, 0xce, 0xff, 0x33, 0xd3, 0xf4, 0x29, 0xbe,
+	0x79, 0x3e, 0xca, 0x3f, 0xcf, 0x5c, 0x74, 0xea,
+	0x7e, 0xd9, 0x10, 0x82, 0x52, 0xda, 0x0a, 0x33,
+	0xd5, 0x95, 0xea, 0x03, 0xc9, 0x17, 0xc0, 0x95,
+	0x36, 0x20, 0x8a, 0x17, 0xf2, 0x38, 0xf7, 0x97,
+	0xda, 0x9c, 0xaa, 0xaa, 0x83, 0xc0, 0x5c, 0x2e,
+	0xa6, 0x72, 0xa3, 0x18, 0xee, 0xd3, 0x14, 0x98,
+	0x6e, 0x87, 0x30, 0x49, 0x10, 0xc2, 0x71, 0x89,
+	0xf8, 0x69, 0x9d, 0x79, 0x70, 0xaf, 0xde, 0xe8,
+	0xf7, 0x94, 0x1b, 0x88, 0xd9, 0x4c, 0x87, 0xc1,
+	0xfb, 0x8a, 0x8b, 0x42, 0xc0, 0x75, 0xf9, 0xe8,
+	0x9c, 0x77, 0x5e, 0x59, 0x5a, 0xa2, 0x05, 0xe3,
+	0x78, 0x15, 0x50, 0x76, 0x9f, 0xc1, 0xfb, 0x03,
+	0x5e, 0x2f, 0x15, 0x1f, 0x85, 0xba, 0x21, 0x2c,
+	0x54, 0xc6, 0xa6, 0xd0, 0x46, 0xe3, 0x61, 0xa6,
+	0xb9, 0xb8, 0xec, 0x2b, 0x04, 0x39, 0xa6, 0x02,
+	0xcf, 0x7c, 0xe2, 0x8a, 0xb4, 0x51, 0xa5, 0x11,
+};
+
+static const uint8_t sm4_cbc_ctx[] = {
+	0x10, 0x12, 0xc2, 0x26, 0x36, 0x89, 0xe2, 0x23,
+	0xf1, 0xbc, 0x9f, 0xde, 0xcd, 0x03, 0xe5, 0xa8,
+	0x1e, 0x21, 0xde, 0x7c, 0x19, 0x0f, 0xc3, 0x11,
+	0x79, 0xf4, 0x00, 0x5a, 0x27, 0x5e, 0xc5, 0x76,
+	0x9e, 0x86, 0xea, 0x5e, 0x47, 0x41, 0x17, 0x44,
+	0xbb, 0x6e, 0xfb, 0x30, 0x61, 0x0d, 0x5f, 0xaa,
+	0x60, 0xd6, 0xf5, 0x04, 0xd9, 0x8d, 0x6e, 0xa4,
+	0xd8, 0xcc, 0x94, 0x02, 0x9a, 0x5e, 0xe1, 0x36,
+	0xa0, 0xae, 0x82, 0xc7, 0x68, 0xdc, 0x9f, 0x3e,
+	0x55, 0xc1, 0xfe, 0xa1, 0x16, 0x78, 0x0f, 0xfe,
+	0xd9, 0xb0, 0xe8, 0x0d, 0x16, 0x80, 0xec, 0xdf,
+	0x07, 0xd4, 0xf9, 0x31, 0x2b, 0xd7, 0x15, 0xa4,
+	0x5d, 0x66, 0x4f, 0xf2, 0xd6, 0xda, 0x52, 0xb8,
+	0x95, 0x37, 0xe8, 0x1c, 0xb0, 0x80, 0x65, 0xe8,
+	0xc7, 0xd0, 0xcc, 0xd3, 0xd5, 0xe3, 0x98, 0xd8,
+	0x14, 0xbe, 0x94, 0xc6, 0x63, 0x80, 0x39, 0xdc,
+	0x6c, 0x93, 0x39, 0x99, 0xda, 0x05, 0xe0, 0xf9,
+	0x0f, 0x9b, 0x7d, 0x0f, 0xb8, 0xa0, 0xbd, 0x29,
+};
+
+static const uint8_t sm4_ctr_ctx[] = {
+	0x56, 0x6e, 0x34, 0x5e, 0xff, 0xee, 0xf8, 0x56,
+	0x8d, 0x2c, 0x47, 0x6a, 0xe9, 0x36, 0x9b, 0xb2,
+	0x2f, 0x12, 0x8e, 0xe3, 0xe4, 0x1b, 0xa6, 0x10,
+	0xf0, 0xa0, 0xfd, 0x52, 0xbc, 0xe9, 0xea, 0x94,
+	0x4c, 0x07, 0x12, 0x03, 0xc4, 0x0d, 0x6e, 0xd8,
+	0x2e, 0xe3, 0xb8, 0x71, 0xc2, 0x70, 0xa9, 0x7e,
+	0x83, 0xb6, 0xd4, 0xf4, 0xed, 0x71, 0x5f, 0x3b,
+	0x4c, 0xec, 0xb2, 0x02, 0x76, 0x7a, 0x10, 0x36,
+	0x30, 0x43, 0x1f, 0xb0, 0xf9, 0xe0, 0xbc, 0x42,
+	0xee, 0x01, 0xbb, 0x04, 0x32, 0x31, 0x93, 0xaf,
+	0x40, 0xb5, 0x85, 0x7b, 0x44, 0x5b, 0x37, 0x12,
+	0xb5, 0xf3, 0x68, 0xe4, 0x00, 0x80, 0xa0, 0xe8,
+	0x6e, 0xef, 0x40, 0x1a, 0xb8, 0x4d, 0xdd, 0xf3,
+	0xcd, 0xeb, 0x29, 0x7f, 0x71, 0x95, 0xb0, 0x7d,
+	0xa1, 0x96, 0x6c, 0x00, 0xcd, 0x14, 0x8c, 0xaa,
+	0x67, 0xd9, 0x6a, 0xbf, 0x7a, 0x6f, 0xd5, 0x7d,
+	0x9c, 0xfa, 0x7c, 0x9f, 0xb3, 0x7f, 0x62, 0x7b,
+	0xcd, 0xdb, 0x82, 0x92, 0x59, 0x3c, 0xcf, 0x1e,
+};
+
+static const uint8_t sha384_digest[] = {
+	0x77, 0x90, 0x74, 0xf7, 0x07, 0x0d, 0xda, 0x10,
+	0xf6, 0xbe, 0xcc, 0xb1, 0x78, 0xab, 0x86, 0x17,
+	0xff, 0xe0, 0xc8, 0x99, 0x05, 0x96, 0xdd, 0x72,
+	0x3c, 0x12, 0x27, 0x0d, 0x95, 0x2d, 0x06, 0xcd,
+	0x8b, 0xde, 0x66, 0x36, 0xcd, 0xe3, 0x17, 0x30,
+	0x44, 0xc3, 0xa8, 0xf0, 0x66, 0x52, 0x7d, 0x8d,
+};
+
+static const uint8_t sha512_digest[] = {
+	0x1e, 0x29, 0xf6, 0x12, 0x8e, 0x0e, 0x9f, 0x57,
+	0x57, 0xa0, 0x21, 0xd9, 0x15, 0x25, 0xc9, 0x0e,
+	0xb6, 0x5b, 0x2b, 0x35, 0xc0, 0x3e, 0x56, 0xcf,
+	0x47, 0xbe, 0xd3, 0xba, 0x33, 0xde, 0x32, 0x8a,
+	0x91, 0x03, 0x01, 0xaf, 0x2c, 0xf0, 0xa9, 0x1a,
+	0x7c, 0xe5, 0x78, 0x32, 0x47, 0xda, 0x76, 0x9f,
+	0x3b, 0x9a, 0x77, 0x36, 0xdf, 0x0d, 0x55, 0x70,
+	0x9c, 0x59, 0x25, 0x81, 0x7c, 0x5d, 0x80, 0x20,
+};
+
+struct cipher_kat {
+	const char *name;
+	uint32_t algo;
+	const uint8_t *key1;
+	size_t key1_len;
+	const uint8_t *key2;
+	size_t key2_len;
+	const uint8_t *iv;
+	size_t iv_len;
+	const uint8_t *ctx;
+	size_t len;
+};
+
+#define CIPHER_KAT(_name, _algo, _key1_len, _key2_len, _iv, _iv_len, _ctx) { \
+		.name = (_name), .algo = (_algo), \
+		.key1 = kat_key, .key1_len = (_key1_len), \
+		.key2 = kat_key + (_key1_len), .key2_len = (_key2_len), \
+		.iv = (_iv), .iv_len = (_iv_len), \
+		.ctx = (_ctx), .len = sizeof(_ctx), \
+	}
+
+static const struct cipher_kat cipher_kats[] = {
+	CIPHER_KAT("AES-128-ECB", TEE_ALG_AES_ECB_NOPAD, 16, 0, NULL, 0,
+		   aes128_ecb_ctx),
+	CIPHER_KAT("AES-192-ECB", TEE_ALG_AES_ECB_NOPAD, 24, 0, NULL, 0,
+		   aes192_ecb_ctx),
+	CIPHER_KAT("AES-256-ECB", TEE_ALG_AES_ECB_NOPAD, 32, 0, NULL, 0,
+		   aes256_ecb_ctx),
+	CIPHER_KAT("AES-128-CBC", TEE_ALG_AES_CBC_NOPAD, 16, 0, kat_iv,
+		   sizeof(kat_iv), aes128_cbc_ctx),
+	CIPHER_KAT("AES-128-CTR", TEE_ALG_AES_CTR, 16, 0, aes_ctr_iv,
+		   sizeof(aes_ctr_iv), aes128_ctr_ctx),
+	CIPHER_KAT("AES-128-XTS", TEE_ALG_AES_XTS, 16, 16, kat_iv,
+		   sizeof(kat_iv), aes128_xts_ctx),
+	CIPHER_KAT("SM4-ECB", TEE_ALG_SM4_ECB_NOPAD, 16, 0, NULL, 0,
+		   sm4_ecb_ctx),
+	CIPHER_KAT("SM4-CBC", TEE_ALG_SM4_CBC_NOPAD, 16, 0, kat_iv,
+		   sizeof(kat_iv), sm4_cbc_ctx),
+	CIPHER_KAT("SM4-CTR", TEE_ALG_SM4_CTR, 16, 0, aes_ctr_iv,
+		   sizeof(aes_ctr_iv), sm4_ctr_ctx),
+};
+
+static TEE_Result cipher_run(const struct cipher_kat *kat,
+			     TEE_OperationMode mode, const uint8_t *src,
+			     uint8_t *dst)
+{
+	TEE_Result res = TEE_SUCCESS;
+	size_t l = MIN(kat->len, (size_t)KAT_FIRST_UPDATE);
+	void *ctx = NULL;
+
+	/* XTS is tested with the whole payload in a single update */
+	if (kat->algo == TEE_ALG_AES_XTS)
+		l = kat->len;
+
+	res = crypto_cipher_alloc_ctx(&ctx, kat->algo);
+	if (res)
+		return res;
+
+	res = crypto_cipher_init(ctx, mode, kat->key1, kat->key1_len,
+				 kat->key2, kat->key2_len, kat->iv,
+				 kat->iv_len);
+	if (!res)
+		res = crypto_cipher_update(ctx, mode, l == kat->len, src, l,
+					   dst);
+	if (!res && l < kat->len)
+		res = crypto_cipher_update(ctx, mode, true, src + l,
+					   kat->len - l, dst + l);
+	crypto_cipher_final(ctx);
+	crypto_cipher_free_ctx(ctx);
+
+	return res;
+}
+
+static int check_cipher(const struct cipher_kat *kat)
+{
+	TEE_Result res = TEE_SUCCESS;
+	uint8_t *buf = malloc(kat->len);
+	int ret = -1;
+
+	if (!buf)
+		return -1;
+
+	res = cipher_run(kat, TEE_MODE_ENCRYPT, kat_ptx, buf);
+	if (res == TEE_ERROR_NOT_IMPLEMENTED) {
+		ret = 0;
+		goto out;
+	}
+	if (res || memcmp(buf, kat->ctx, kat->len)) {
+		EMSG("%s encryption failed", kat->name);
+		goto out;
+	}
+
+	res = cipher_run(kat, TEE_MODE_DECRYPT, kat->ctx, buf);
+	if (res || memcmp(buf, kat_ptx, kat->len)) {
+		EMSG("%s decryption failed", kat->name);
+		goto out;
+	}
+
+	ret = 0;
+out:
+	free(buf);
+	return ret;
+}
+
+static TEE_Result gcm_run(TEE_OperationMode mode, const uint8_t *src,
+			  uint8_t *dst, uint8_t *tag)
+{
+	TEE_Result res = TEE_SUCCESS;
+	size_t len = sizeof(aes128_gcm_ctx);
+	size_t tag_len = sizeof(aes128_gcm_tag);
+	size_t l = KAT_FIRST_UPDATE;
+	size_t dst_len = l;
+	void *ctx = NULL;
+
+	res = crypto_authenc_alloc_ctx(&ctx, TEE_ALG_AES_GCM);
+	if (res)
+		return res;
+
+	res = crypto_authenc_init(ctx, mode, kat_key, 16, kat_iv, 12,
+				  tag_len, sizeof(aes_gcm_aad), len);
+	if (!res)
+		res = crypto_authenc_update_aad(ctx, mode, aes_gcm_aad,
+						sizeof(aes_gcm_aad));
+	if (!res)
+		res = crypto_authenc_update_payload(ctx, mode, src, l, dst,
+						    &dst_len);
+	if (!res) {
+		dst_len = len - l;
+		if (mode == TEE_MODE_ENCRYPT)
+			res = crypto_authenc_enc_final(ctx, src + l, len - l,
+						       dst + l, &dst_len, tag,
+						       &tag_len);
+		else
+			res = crypto_authenc_dec_final(ctx, src + l, len - l,
+						       dst + l, &dst_len, tag,
+						       tag_len);
+	}
+	crypto_authenc_final(ctx);
+	crypto_authenc_free_ctx(ctx);
+
+	return res;
+}
+
+static int check_gcm(void)
+{
+	uint8_t tag[sizeof(aes128_gcm_tag)] = { };
+	TEE_Result res = TEE_SUCCESS;
+	uint8_t *buf = malloc(sizeof(aes128_gcm_ctx));
+	int ret = -1;
+
+	if (!buf)
+		return -1;
+
+	res = gcm_run(TEE_MODE_ENCRYPT, kat_ptx, buf, tag);
+	if (res == TEE_ERROR_NOT_IMPLEMENTED) {
+		ret = 0;
+		goto out;
+	}
+	if (res || memcmp(buf, aes128_gcm_ctx, sizeof(aes128_gcm_ctx)) ||
+	    memcmp(tag, aes128_gcm_tag, sizeof(tag))) {
+		EMSG("AES-128-GCM encryption failed");
+		goto out;
+	}
+
+	memcpy(tag, aes128_gcm_tag, sizeof(tag));
+	res = gcm_run(TEE_MODE_DECRYPT, aes128_gcm_ctx, buf, tag);
+	if (res || memcmp(buf, kat_ptx, sizeof(aes128_gcm_ctx))) {
+		EMSG("AES-128-GCM decryption failed");
+		goto out;
+	}
+
+	ret = 0;
+out:
+	free(buf);
+	return ret;
+}
+
+struct hash_kat {
+	const char *name;
+	uint32_t algo;
+	const uint8_t *digest;
+	size_t digest_len;
+};
+
+static const struct hash_kat hash_kats[] = {
+	{ "SHA-384", TEE_ALG_SHA384, sha384_digest, sizeof(sha384_digest) },
+	{ "SHA-512", TEE_ALG_SHA512, sha512_digest, sizeof(sha512_digest) },
+};
+
+static int check_hash(const struct hash_kat *kat)
+{
+	TEE_Result res = TEE_SUCCESS;
+	uint8_t digest[TEE_MAX_HASH_SIZE] = { };
+	size_t l = KAT_FIRST_UPDATE;
+	void *ctx = NULL;
+
+	res = crypto_hash_alloc_ctx(&ctx, kat->algo);
+	if (res == TEE_ERROR_NOT_IMPLEMENTED)
+		return 0;
+	if (res)
+		return -1;
+
+	res = crypto_hash_init(ctx);
+	if (!res)
+		res = crypto_hash_update(ctx, kat_ptx, l);
+	if (!res)
+		res = crypto_hash_update(ctx, kat_ptx + l,
+					 sizeof(kat_ptx) - l);
+	if (!res)
+		res = crypto_hash_final(ctx, digest, kat->digest_len);
+	crypto_hash_free_ctx(ctx);
+
+	if (res || memcmp(digest, kat->digest, kat->digest_len)) {
+		EMSG("%s failed", kat->name);
+		return -1;
+	}
+
+	return 0;
+}
+
+int self_test_crypto(void)
+{
+	size_t n = 0;
+
+	for (n = 0; n < ARRAY_SIZE(cipher_kats); n++)
+		if (check_cipher(cipher_kats + n))
+			return -1;
+
+	for (n = 0; n < ARRAY_SIZE(hash_kats); n++)
+		if (check_hash(hash_kats + n))
+			return -1;
+
+	return check_gcm();
+}
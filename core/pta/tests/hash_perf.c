@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2022, Microchip
+ */
+
+#include <crypto/crypto.h>
+#include <pta_invoke_tests.h>
+#include <stdio.h>
+#include <tee_api_defines.h>
+#include <tee_api_types.h>
+#include <trace.h>
+#include <types_ext.h>
+#include <utee_defines.h>
+#include <util.h>
+
+#include "misc.h"
+
+static TEE_Result do_hash(void *ctx, unsigned int rep_count,
+			  unsigned int unit_size, const uint8_t *in, size_t sz,
+			  uint8_t *digest, size_t digest_len)
+{
+	TEE_Result res = TEE_SUCCESS;
+	unsigned int n = 0;
+	size_t m = 0;
+
+	for (n = 0; n < rep_count; n++) {
+		res = crypto_hash_init(ctx);
+		if (res)
+			return res;
+		for (m = 0; m < sz; m += unit_size) {
+			res = crypto_hash_update(ctx, in + m,
+						 MIN(unit_size, sz - m));
+			if (res)
+				return res;
+		}
+		res = crypto_hash_final(ctx, digest, digest_len);
+		if (res)
+			return res;
+	}
+
+	return TEE_SUCCESS;
+}
+
+TEE_Result core_hash_perf_tests(uint32_t param_types,
+				TEE_Param params[TEE_NUM_PARAMS])
+{
+	uint32_t exp_param_types = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+						   TEE_PARAM_TYPE_VALUE_INOUT,
+						   TEE_PARAM_TYPE_MEMREF_INPUT,
+						   TEE_PARAM_TYPE_NONE);
+	uint8_t digest[TEE_MAX_HASH_SIZE] = { };
+	TEE_Result res = TEE_SUCCESS;
+	unsigned int rep_count = 0;
+	unsigned int unit_size = 0;
+	char desc[32] = { };
+	uint32_t algo = 0;
+	void *ctx = NULL;
+	uint64_t t = 0;
+
+	if (param_types != exp_param_types)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	algo = params[0].value.a;
+	rep_count = params[1].value.a;
+	unit_size = params[1].value.b;
+
+	if (TEE_ALG_GET_CLASS(algo) != TEE_OPERATION_DIGEST || !unit_size)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	res = crypto_hash_alloc_ctx(&ctx, algo);
+	if (res)
+		return res;
+
+	t = perf_get_time_us();
+	res = do_hash(ctx, rep_count, unit_size, params[2].memref.buffer,
+		      params[2].memref.size, digest,
+		      TEE_ALG_GET_DIGEST_SIZE(algo));
+	t = perf_get_time_us() - t;
+
+	crypto_hash_free_ctx(ctx);
+
+	if (!res) {
+		snprintf(desc, sizeof(desc), "hash %#"PRIx32, algo);
+		perf_report_throughput(desc,
+				       (uint64_t)rep_count *
+				       params[2].memref.size,
+				       t, params + 1);
+	}
+
+	return res;
+}
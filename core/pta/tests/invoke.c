@@ -432,6 +432,10 @@ static TEE_Result invoke_command(void *pSessionContext __unused,
 		return core_lockdep_tests(nParamTypes, pParams);
 	case PTA_INVOKE_TEST_CMD_AES_PERF:
 		return core_aes_perf_tests(nParamTypes, pParams);
+	case PTA_INVOKE_TEST_CMD_HASH_PERF:
+		return core_hash_perf_tests(nParamTypes, pParams);
+	case PTA_INVOKE_TEST_CMD_RNG_PERF:
+		return core_rng_perf_tests(nParamTypes, pParams);
 	default:
 		break;
 	}
@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2022, Microchip
+ */
+
+/*
+ * Tests of the LZ4 block decoder run by core_self_tests(). The valid
+ * blocks are produced by the reference LZ4 compressor, the malformed
+ * ones must be refused without writing past the output buffer.
+ */
+
+#include <lz4.h>
+#include <string.h>
+#include <tee_api_defines.h>
+#include <tee_api_types.h>
+#include <trace.h>
+#include <types_ext.h>
+#include <util.h>
+
+#include "misc.h"
+
+#define LZ4_TEST_GUARD	0xa5
+
+/* "0123456789" x 20 "OP-TEE lz4 test": overlapping match, long literals */
+static const uint8_t lz4_blk1[] = {
+	0xaf, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39,
+	0x0a, 0x00, 0xab, 0xf0, 0x00, 0x4f, 0x50, 0x2d, 0x54, 0x45, 0x45,
+	0x20, 0x6c, 0x7a, 0x34, 0x20, 0x74, 0x65, 0x73, 0x74,
+};
+
+/* "Hello, world! xyzxyzxyzHello, world! .": distinct match */
+static const uint8_t lz4_blk2[] = {
+	0xf2, 0x02, 0x48, 0x65, 0x6c, 0x6c, 0x6f, 0x2c, 0x20, 0x77, 0x6f,
+	0x72, 0x6c, 0x64, 0x21, 0x20, 0x78, 0x79, 0x7a, 0x03, 0x00, 0x06,
+	0x17, 0x00, 0x50, 0x6c, 0x64, 0x21, 0x20, 0x2e,
+};
+
+/* Literal length extension running off the end of the block */
+static const uint8_t lz4_bad_lit_len[] = { 0xf0, 0xff, 0xff };
+/* Literals running off the end of the block */
+static const uint8_t lz4_bad_lit[] = { 0x40, 'a', 'b', 'c' };
+/* Offset truncated to one byte */
+static const uint8_t lz4_bad_offs_len[] = { 0x10, 'a', 0x01 };
+/* Offset 0 */
+static const uint8_t lz4_bad_offs_zero[] = { 0x10, 'a', 0x00, 0x00 };
+/* Offset before the start of the output */
+static const uint8_t lz4_bad_offs[] = { 0x10, 'a', 0x02, 0x00 };
+/* Match length extension running off the end of the block */
+static const uint8_t lz4_bad_match_len[] = { 0x1f, 'a', 0x01, 0x00, 0xff };
+
+struct lz4_bad_test {
+	const uint8_t *src;
+	size_t src_len;
+};
+
+#define LZ4_BAD(x) { .src = (x), .src_len = sizeof(x) }
+
+static const struct lz4_bad_test lz4_bad_tests[] = {
+	LZ4_BAD(lz4_bad_lit_len),
+	LZ4_BAD(lz4_bad_lit),
+	LZ4_BAD(lz4_bad_offs_len),
+	LZ4_BAD(lz4_bad_offs_zero),
+	LZ4_BAD(lz4_bad_offs),
+	LZ4_BAD(lz4_bad_match_len),
+};
+
+static void expect_blk1(uint8_t *buf)
+{
+	size_t n = 0;
+
+	for (n = 0; n < 20; n++)
+		memcpy(buf + n * 10, "0123456789", 10);
+	memcpy(buf + 200, "OP-TEE lz4 test", 15);
+}
+
+static void expect_blk2(uint8_t *buf)
+{
+	memcpy(buf, "Hello, world! xyzxyzxyzHello, world! .", 38);
+}
+
+static int check_valid(const char *name, const uint8_t *src, size_t src_len,
+		       void (*expect)(uint8_t *buf), size_t len)
+{
+	uint8_t ref[256] = { };
+	uint8_t out[256] = { };
+	size_t l = len;
+
+	expect(ref);
+	memset(out, LZ4_TEST_GUARD, sizeof(out));
+	if (lz4_decompress_block(src, src_len, out, &l) || l != len ||
+	    memcmp(out, ref, len) || out[len] != LZ4_TEST_GUARD) {
+		EMSG("LZ4 %s failed", name);
+		return -1;
+	}
+
+	/* One byte short of output must be refused within the buffer */
+	memset(out, LZ4_TEST_GUARD, sizeof(out));
+	l = len - 1;
+	if (!lz4_decompress_block(src, src_len, out, &l) ||
+	    out[len - 1] != LZ4_TEST_GUARD) {
+		EMSG("LZ4 %s short output failed", name);
+		return -1;
+	}
+
+	/* A truncated block must be refused */
+	l = len;
+	if (!lz4_decompress_block(src, src_len - 1, out, &l)) {
+		EMSG("LZ4 %s truncated input failed", name);
+		return -1;
+	}
+
+	return 0;
+}
+
+int self_test_lz4(void)
+{
+	uint8_t out[16] = { };
+	size_t l = 0;
+	size_t n = 0;
+
+	if (check_valid("block 1", lz4_blk1, sizeof(lz4_blk1), expect_blk1,
+			215) ||
+	    check_valid("block 2", lz4_blk2, sizeof(lz4_blk2), expect_blk2,
+			38))
+		return -1;
+
+	for (n = 0; n < ARRAY_SIZE(lz4_bad_tests); n++) {
+		l = sizeof(out);
+		if (lz4_decompress_block(lz4_bad_tests[n].src,
+					 lz4_bad_tests[n].src_len, out, &l) !=
+		    TEE_ERROR_BAD_FORMAT) {
+			EMSG("LZ4 malformed block %zu accepted", n);
+			return -1;
+		}
+	}
+
+	return 0;
+}
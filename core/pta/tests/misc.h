@@ -13,6 +13,19 @@
 TEE_Result core_self_tests(uint32_t nParamTypes,
 			   TEE_Param pParams[TEE_NUM_PARAMS]);
 
+/* Known answer tests of the crypto algorithms, returns 0 on success */
+int self_test_crypto(void);
+
+#if defined(CFG_TA_COMPRESSION) || defined(CFG_EARLY_TA_PAGED)
+/* Tests of the LZ4 decoder with valid and malformed blocks */
+int self_test_lz4(void);
+#else
+static inline int self_test_lz4(void)
+{
+	return 0;
+}
+#endif
+
 TEE_Result core_fs_htree_tests(uint32_t nParamTypes,
 			       TEE_Param pParams[TEE_NUM_PARAMS]);
 
@@ -34,4 +47,26 @@ static inline TEE_Result core_lockdep_tests(
 TEE_Result core_aes_perf_tests(uint32_t param_types,
 			       TEE_Param params[TEE_NUM_PARAMS]);
 
+TEE_Result core_hash_perf_tests(uint32_t param_types,
+				TEE_Param params[TEE_NUM_PARAMS]);
+
+TEE_Result core_rng_perf_tests(uint32_t param_types,
+			       TEE_Param params[TEE_NUM_PARAMS]);
+
+/*
+ * Returns the system time in microseconds as read with
+ * tee_time_get_sys_time(), which is available on all platforms but may
+ * only have a millisecond resolution. The tests are expected to run long
+ * enough for that not to matter.
+ */
+uint64_t perf_get_time_us(void);
+
+/*
+ * Logs the throughput of processing @bytes in @us microseconds as @desc.
+ * The elapsed time in microseconds and the throughput in MB/s are
+ * returned in the value of @param if supplied.
+ */
+void perf_report_throughput(const char *desc, uint64_t bytes, uint64_t us,
+			    TEE_Param *param);
+
 #endif /*CORE_PTA_TESTS_MISC_H*/
@@ -5,6 +5,7 @@
 
 #include <atomic.h>
 #include <kernel/mutex.h>
+#include <kernel/rwlock.h>
 #include <pta_invoke_tests.h>
 #include <trace.h>
 
@@ -19,6 +20,7 @@ static uint64_t val0;
 static uint64_t val1;
 
 struct mutex test_mutex = MUTEX_INITIALIZER;
+static struct rwlock test_rwlock = RWLOCK_INITIALIZER;
 
 static TEE_Result mutex_test_writer(TEE_Param params[TEE_NUM_PARAMS])
 {
@@ -68,6 +70,111 @@ static TEE_Result mutex_test_reader(TEE_Param params[TEE_NUM_PARAMS])
 	return res;
 }
 
+static TEE_Result rwlock_test_writer(TEE_Param params[TEE_NUM_PARAMS])
+{
+	size_t n;
+
+	params[1].value.a = atomic_inc32(&before_lock_writers);
+
+	rwlock_write_lock(&test_rwlock);
+
+	atomic_dec32(&before_lock_writers);
+
+	params[1].value.b = atomic_inc32(&during_lock_writers);
+
+	for (n = 0; n < params[0].value.b; n++) {
+		val0++;
+		val1++;
+		val1++;
+	}
+
+	atomic_dec32(&during_lock_writers);
+	rwlock_write_unlock(&test_rwlock);
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result rwlock_test_reader(TEE_Param params[TEE_NUM_PARAMS])
+{
+	TEE_Result res = TEE_SUCCESS;
+	size_t n;
+
+	params[1].value.a = atomic_inc32(&before_lock_readers);
+
+	rwlock_read_lock(&test_rwlock);
+
+	atomic_dec32(&before_lock_readers);
+
+	params[1].value.b = atomic_inc32(&during_lock_readers);
+
+	for (n = 0; n < params[0].value.b; n++) {
+		if (val0 * 2 != val1)
+			res = TEE_ERROR_BAD_STATE;
+	}
+
+	atomic_dec32(&during_lock_readers);
+	rwlock_read_unlock(&test_rwlock);
+
+	return res;
+}
+
+/*
+ * Read side scaling benchmark: takes and releases the read lock
+ * params[0].value.b times. The caller measures the time taken while
+ * running this concurrently on several cores, the largest number of
+ * readers seen inside the critical section is returned in
+ * params[1].value.b.
+ */
+static TEE_Result read_bench(TEE_Param params[TEE_NUM_PARAMS],
+			     void (*lock)(void *), void (*unlock)(void *),
+			     void *lock_obj)
+{
+	uint32_t max_readers = 0;
+	uint32_t readers = 0;
+	size_t n = 0;
+
+	params[1].value.a = 0;
+
+	for (n = 0; n < params[0].value.b; n++) {
+		lock(lock_obj);
+		readers = atomic_inc32(&during_lock_readers);
+		if (val0 * 2 != val1) {
+			atomic_dec32(&during_lock_readers);
+			unlock(lock_obj);
+			return TEE_ERROR_BAD_STATE;
+		}
+		atomic_dec32(&during_lock_readers);
+		unlock(lock_obj);
+
+		if (readers > max_readers)
+			max_readers = readers;
+	}
+
+	params[1].value.b = max_readers;
+
+	return TEE_SUCCESS;
+}
+
+static void bench_mutex_read_lock(void *m)
+{
+	mutex_read_lock(m);
+}
+
+static void bench_mutex_read_unlock(void *m)
+{
+	mutex_read_unlock(m);
+}
+
+static void bench_rwlock_read_lock(void *rw)
+{
+	rwlock_read_lock(rw);
+}
+
+static void bench_rwlock_read_unlock(void *rw)
+{
+	rwlock_read_unlock(rw);
+}
+
 TEE_Result core_mutex_tests(uint32_t param_types,
 			    TEE_Param params[TEE_NUM_PARAMS])
 {
@@ -86,6 +193,16 @@ TEE_Result core_mutex_tests(uint32_t param_types,
 		return mutex_test_writer(params);
 	case PTA_MUTEX_TEST_READER:
 		return mutex_test_reader(params);
+	case PTA_MUTEX_TEST_RWLOCK_WRITER:
+		return rwlock_test_writer(params);
+	case PTA_MUTEX_TEST_RWLOCK_READER:
+		return rwlock_test_reader(params);
+	case PTA_MUTEX_TEST_READER_BENCH:
+		return read_bench(params, bench_mutex_read_lock,
+				  bench_mutex_read_unlock, &test_mutex);
+	case PTA_MUTEX_TEST_RWLOCK_READER_BENCH:
+		return read_bench(params, bench_rwlock_read_lock,
+				  bench_rwlock_read_unlock, &test_rwlock);
 	default:
 		return TEE_ERROR_BAD_PARAMETERS;
 	}
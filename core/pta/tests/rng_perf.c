@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2022, Microchip
+ */
+
+#include <crypto/crypto.h>
+#include <malloc.h>
+#include <pta_invoke_tests.h>
+#include <tee_api_defines.h>
+#include <tee_api_types.h>
+#include <types_ext.h>
+
+#include "misc.h"
+
+TEE_Result core_rng_perf_tests(uint32_t param_types,
+			       TEE_Param params[TEE_NUM_PARAMS])
+{
+	uint32_t exp_param_types = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INOUT,
+						   TEE_PARAM_TYPE_VALUE_OUTPUT,
+						   TEE_PARAM_TYPE_NONE,
+						   TEE_PARAM_TYPE_NONE);
+	TEE_Result res = TEE_SUCCESS;
+	unsigned int rep_count = 0;
+	unsigned int unit_size = 0;
+	uint32_t contention = 0;
+	uint8_t *buf = NULL;
+	unsigned int n = 0;
+	uint64_t t = 0;
+
+	if (param_types != exp_param_types)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	rep_count = params[0].value.a;
+	unit_size = params[0].value.b;
+	if (!unit_size)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	buf = malloc(unit_size);
+	if (!buf)
+		return TEE_ERROR_OUT_OF_MEMORY;
+
+	contention = crypto_rng_get_contention();
+	t = perf_get_time_us();
+	for (n = 0; n < rep_count && !res; n++)
+		res = crypto_rng_read(buf, unit_size);
+	t = perf_get_time_us() - t;
+	contention = crypto_rng_get_contention() - contention;
+
+	free(buf);
+
+	if (!res) {
+		perf_report_throughput("rng", (uint64_t)rep_count * unit_size,
+				       t, params);
+		params[1].value.a = contention;
+		params[1].value.b = 0;
+	}
+
+	return res;
+}
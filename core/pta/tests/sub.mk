@@ -3,5 +3,9 @@ srcs-y += invoke.c
 srcs-$(CFG_LOCKDEP) += lockdep.c
 srcs-y += misc.c
 cflags-misc.c-y += -fno-builtin
+srcs-y += crypto_kat.c
+srcs-$(call cfg-one-enabled,CFG_TA_COMPRESSION CFG_EARLY_TA_PAGED) += lz4.c
 srcs-y += mutex.c
 srcs-y += aes_perf.c
+srcs-y += hash_perf.c
+srcs-y += rng_perf.c
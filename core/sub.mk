@@ -20,7 +20,9 @@ recipe-ldelf = $(PYTHON3) scripts/gen_ldelf_hex.py --input $(out-dir)/ldelf/ldel
 endif
 
 ifeq ($(CFG_WITH_USER_TA)-$(CFG_EARLY_TA),y-y)
-ifeq ($(CFG_EARLY_TA_COMPRESS),y)
+ifeq ($(CFG_EARLY_TA_PAGED),y)
+early-ta-compress = --paged
+else ifeq ($(CFG_EARLY_TA_COMPRESS),y)
 early-ta-compress = --compress
 endif
 define process_early_ta
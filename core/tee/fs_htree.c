@@ -4,6 +4,7 @@
  */
 
 #include <assert.h>
+#include <config.h>
 #include <crypto/crypto.h>
 #include <initcall.h>
 #include <kernel/tee_common_otp.h>
@@ -96,6 +97,41 @@ struct tee_fs_htree {
 	void *stor_aux;
 };
 
+/*
+ * Size of the largest message hashed for a node: the node image except
+ * the hash, the meta data of the root node and the hashes of the two
+ * children.
+ */
+#define NODE_HASH_MSG_MAX_SIZE	(sizeof(struct tee_fs_htree_node_image) - \
+				 TEE_FS_HTREE_HASH_SIZE + \
+				 sizeof(struct tee_fs_htree_meta) + \
+				 2 * TEE_FS_HTREE_HASH_SIZE)
+
+/* Number of nodes hashed together, see hash_batch() */
+#define NODE_HASH_BATCH		8
+
+/*
+ * struct node_hash_batch - independent nodes to be hashed together
+ * @ctx:	hash context, only used without multi-buffer SHA-256
+ * @count:	number of nodes in the batch
+ * @node:	the nodes
+ * @meta:	meta data hashed with each node, only for the root node
+ * @vers:	version of the node to write, only used when syncing
+ * @msg:	messages passed to hash_sha256_mb_compute()
+ * @buf:	message of each node, see get_node_hash_msg()
+ * @digest:	computed hash of each node
+ */
+struct node_hash_batch {
+	void *ctx;
+	size_t count;
+	struct htree_node *node[NODE_HASH_BATCH];
+	struct tee_fs_htree_meta *meta[NODE_HASH_BATCH];
+	uint8_t vers[NODE_HASH_BATCH];
+	struct hash_sha256_mb_msg msg[NODE_HASH_BATCH];
+	uint8_t buf[NODE_HASH_BATCH][NODE_HASH_MSG_MAX_SIZE];
+	uint8_t digest[NODE_HASH_BATCH][TEE_FS_HTREE_HASH_SIZE];
+};
+
 struct traverse_arg;
 typedef TEE_Result (*traverse_cb_t)(struct traverse_arg *targ,
 				    struct htree_node *node);
@@ -206,6 +242,25 @@ static TEE_Result htree_traverse_post_order(struct tee_fs_htree *ht,
 	return traverse_post_order(&targ, &ht->root);
 }
 
+/* Calls targ->cb() for each node @level levels below and including @node */
+static TEE_Result traverse_level(struct traverse_arg *targ,
+				 struct htree_node *node, size_t level)
+{
+	TEE_Result res;
+
+	if (!node)
+		return TEE_SUCCESS;
+
+	if (level == 1)
+		return targ->cb(targ, node);
+
+	res = traverse_level(targ, node->child[0], level - 1);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	return traverse_level(targ, node->child[1], level - 1);
+}
+
 static size_t node_id_to_level(size_t node_id)
 {
 	assert(node_id && node_id < UINT_MAX);
@@ -396,6 +451,39 @@ static TEE_Result init_tree_from_data(struct tee_fs_htree *ht)
 	return TEE_SUCCESS;
 }
 
+/*
+ * Assembles the message hashed for @node in @buf and returns its length.
+ * The message is the node image except the hash, followed by @meta if
+ * supplied and the hashes of the children.
+ */
+static size_t get_node_hash_msg(struct htree_node *node,
+				struct tee_fs_htree_meta *meta,
+				uint8_t buf[NODE_HASH_MSG_MAX_SIZE])
+{
+	uint8_t *ndata = (uint8_t *)&node->node + sizeof(node->node.hash);
+	size_t nsize = sizeof(node->node) - sizeof(node->node.hash);
+	size_t len = 0;
+	size_t n = 0;
+
+	memcpy(buf, ndata, nsize);
+	len += nsize;
+
+	if (meta) {
+		memcpy(buf + len, meta, sizeof(*meta));
+		len += sizeof(*meta);
+	}
+
+	for (n = 0; n < ARRAY_SIZE(node->child); n++) {
+		if (node->child[n]) {
+			memcpy(buf + len, node->child[n]->node.hash,
+			       sizeof(node->child[n]->node.hash));
+			len += sizeof(node->child[n]->node.hash);
+		}
+	}
+
+	return len;
+}
+
 static TEE_Result calc_node_hash(struct htree_node *node,
 				 struct tee_fs_htree_meta *meta, void *ctx,
 				 uint8_t *digest)
@@ -435,6 +523,73 @@ static TEE_Result calc_node_hash(struct htree_node *node,
 	return crypto_hash_final(ctx, digest, TEE_FS_HTREE_HASH_SIZE);
 }
 
+static struct node_hash_batch *alloc_batch(void)
+{
+	struct node_hash_batch *b = calloc(1, sizeof(*b));
+
+	if (!b)
+		return NULL;
+
+	if (!IS_ENABLED(CFG_CORE_CRYPTO_SHA256_MB_ACCEL) &&
+	    crypto_hash_alloc_ctx(&b->ctx, TEE_FS_HTREE_HASH_ALG)) {
+		free(b);
+		return NULL;
+	}
+
+	return b;
+}
+
+static void free_batch(struct node_hash_batch *b)
+{
+	if (b)
+		crypto_hash_free_ctx(b->ctx);
+	free(b);
+}
+
+static void add_node_to_batch(struct node_hash_batch *b,
+			      struct htree_node *node,
+			      struct tee_fs_htree_meta *meta)
+{
+	assert(b->count < NODE_HASH_BATCH);
+
+	b->node[b->count] = node;
+	b->meta[b->count] = meta;
+	b->count++;
+}
+
+/*
+ * Computes the hashes of the nodes in @b into @b->digest. With the
+ * multi-buffer SHA-256 the nodes are hashed in parallel, this requires
+ * TEE_FS_HTREE_HASH_ALG to be SHA-256. Otherwise they're hashed one by
+ * one with the hash context of the batch.
+ */
+static TEE_Result hash_batch(struct node_hash_batch *b)
+{
+	TEE_Result res = TEE_SUCCESS;
+	size_t n = 0;
+
+	if (IS_ENABLED(CFG_CORE_CRYPTO_SHA256_MB_ACCEL)) {
+		for (n = 0; n < b->count; n++) {
+			b->msg[n].data = b->buf[n];
+			b->msg[n].len = get_node_hash_msg(b->node[n],
+							  b->meta[n],
+							  b->buf[n]);
+			b->msg[n].digest = b->digest[n];
+		}
+
+		return hash_sha256_mb_compute(b->msg, b->count);
+	}
+
+	for (n = 0; n < b->count; n++) {
+		res = calc_node_hash(b->node[n], b->meta[n], b->ctx,
+				     b->digest[n]);
+		if (res != TEE_SUCCESS)
+			return res;
+	}
+
+	return TEE_SUCCESS;
+}
+
 static TEE_Result authenc_init(void **ctx_ret, TEE_OperationMode mode,
 			       struct tee_fs_htree *ht,
 			       struct tee_fs_htree_node_image *ni,
@@ -559,35 +714,56 @@ static TEE_Result verify_root(struct tee_fs_htree *ht)
 				     sizeof(ht->imeta), &ht->imeta);
 }
 
+static TEE_Result verify_batch(struct node_hash_batch *b)
+{
+	TEE_Result res;
+	size_t n;
+
+	res = hash_batch(b);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	for (n = 0; n < b->count; n++)
+		if (consttime_memcmp(b->digest[n], b->node[n]->node.hash,
+				     sizeof(b->digest[n])))
+			return TEE_ERROR_CORRUPT_OBJECT;
+
+	b->count = 0;
+	return TEE_SUCCESS;
+}
+
 static TEE_Result verify_node(struct traverse_arg *targ,
 			      struct htree_node *node)
 {
-	void *ctx = targ->arg;
-	TEE_Result res;
-	uint8_t digest[TEE_FS_HTREE_HASH_SIZE];
+	struct node_hash_batch *b = targ->arg;
 
+	/*
+	 * The stored hashes of the children are used, so all nodes are
+	 * independent of each other and can be verified in any order.
+	 */
 	if (node->parent)
-		res = calc_node_hash(node, NULL, ctx, digest);
+		add_node_to_batch(b, node, NULL);
 	else
-		res = calc_node_hash(node, &targ->ht->imeta.meta, ctx, digest);
-	if (res == TEE_SUCCESS &&
-	    consttime_memcmp(digest, node->node.hash, sizeof(digest)))
-		return TEE_ERROR_CORRUPT_OBJECT;
+		add_node_to_batch(b, node, &targ->ht->imeta.meta);
 
-	return res;
+	if (b->count < NODE_HASH_BATCH)
+		return TEE_SUCCESS;
+
+	return verify_batch(b);
 }
 
 static TEE_Result verify_tree(struct tee_fs_htree *ht)
 {
 	TEE_Result res;
-	void *ctx;
+	struct node_hash_batch *b = alloc_batch();
 
-	res = crypto_hash_alloc_ctx(&ctx, TEE_FS_HTREE_HASH_ALG);
-	if (res != TEE_SUCCESS)
-		return res;
+	if (!b)
+		return TEE_ERROR_OUT_OF_MEMORY;
 
-	res = htree_traverse_post_order(ht, verify_node, ctx);
-	crypto_hash_free_ctx(ctx);
+	res = htree_traverse_post_order(ht, verify_node, b);
+	if (res == TEE_SUCCESS && b->count)
+		res = verify_batch(b);
+	free_batch(b);
 
 	return res;
 }
@@ -697,10 +873,36 @@ void tee_fs_htree_close(struct tee_fs_htree **ht)
 	*ht = NULL;
 }
 
+static TEE_Result sync_batch(struct tee_fs_htree *ht,
+			     struct node_hash_batch *b)
+{
+	struct htree_node *node;
+	TEE_Result res;
+	size_t n;
+
+	res = hash_batch(b);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	for (n = 0; n < b->count; n++) {
+		node = b->node[n];
+		memcpy(node->node.hash, b->digest[n], sizeof(node->node.hash));
+		node->dirty = false;
+		node->block_updated = false;
+
+		res = rpc_write_node(ht, node->id, b->vers[n], &node->node);
+		if (res != TEE_SUCCESS)
+			return res;
+	}
+
+	b->count = 0;
+	return TEE_SUCCESS;
+}
+
 static TEE_Result htree_sync_node_to_storage(struct traverse_arg *targ,
 					     struct htree_node *node)
 {
-	TEE_Result res;
+	struct node_hash_batch *b = targ->arg;
 	uint8_t vers;
 	struct tee_fs_htree_meta *meta = NULL;
 
@@ -729,14 +931,40 @@ static TEE_Result htree_sync_node_to_storage(struct traverse_arg *targ,
 		meta = &targ->ht->imeta.meta;
 	}
 
-	res = calc_node_hash(node, meta, targ->arg, node->node.hash);
-	if (res != TEE_SUCCESS)
-		return res;
+	b->vers[b->count] = vers;
+	add_node_to_batch(b, node, meta);
+
+	if (b->count < NODE_HASH_BATCH)
+		return TEE_SUCCESS;
+
+	return sync_batch(targ->ht, b);
+}
 
-	node->dirty = false;
-	node->block_updated = false;
+/*
+ * The nodes are synced level by level starting with the leaves, a node
+ * is then hashed once the hashes of its children are up to date. The
+ * nodes of one level are independent of each other and can be hashed in
+ * batches.
+ */
+static TEE_Result htree_sync_nodes_to_storage(struct tee_fs_htree *ht,
+					      struct node_hash_batch *b)
+{
+	struct traverse_arg targ = { ht, htree_sync_node_to_storage, b };
+	TEE_Result res;
+	size_t level = 1;
+
+	if (ht->imeta.max_node_id)
+		level = node_id_to_level(ht->imeta.max_node_id);
+
+	for (; level; level--) {
+		res = traverse_level(&targ, &ht->root, level);
+		if (res == TEE_SUCCESS && b->count)
+			res = sync_batch(ht, b);
+		if (res != TEE_SUCCESS)
+			return res;
+	}
 
-	return rpc_write_node(targ->ht, node->id, vers, &node->node);
+	return TEE_SUCCESS;
 }
 
 static TEE_Result update_root(struct tee_fs_htree *ht)
@@ -759,7 +987,7 @@ TEE_Result tee_fs_htree_sync_to_storage(struct tee_fs_htree **ht_arg,
 {
 	TEE_Result res;
 	struct tee_fs_htree *ht = *ht_arg;
-	void *ctx;
+	struct node_hash_batch *b;
 
 	if (!ht)
 		return TEE_ERROR_CORRUPT_OBJECT;
@@ -767,11 +995,11 @@ TEE_Result tee_fs_htree_sync_to_storage(struct tee_fs_htree **ht_arg,
 	if (!ht->dirty)
 		return TEE_SUCCESS;
 
-	res = crypto_hash_alloc_ctx(&ctx, TEE_FS_HTREE_HASH_ALG);
-	if (res != TEE_SUCCESS)
-		return res;
+	b = alloc_batch();
+	if (!b)
+		return TEE_ERROR_OUT_OF_MEMORY;
 
-	res = htree_traverse_post_order(ht, htree_sync_node_to_storage, ctx);
+	res = htree_sync_nodes_to_storage(ht, b);
 	if (res != TEE_SUCCESS)
 		goto out;
 
@@ -788,7 +1016,7 @@ TEE_Result tee_fs_htree_sync_to_storage(struct tee_fs_htree **ht_arg,
 	if (hash)
 		memcpy(hash, ht->root.node.hash, sizeof(ht->root.node.hash));
 out:
-	crypto_hash_free_ctx(ctx);
+	free_batch(b);
 	if (res != TEE_SUCCESS)
 		tee_fs_htree_close(ht_arg);
 	return res;
@@ -281,7 +281,8 @@ static TEE_Result tadb_authenc_init(TEE_OperationMode mode,
 {
 	TEE_Result res;
 	void *ctx;
-	const size_t enc_size = entry->prop.custom_size + entry->prop.bin_size;
+	const size_t enc_size = tee_tadb_custom_size(&entry->prop) +
+				entry->prop.bin_size;
 
 	res = crypto_authenc_alloc_ctx(&ctx, TADB_AUTH_ENC_ALG);
 	if (res)
@@ -696,7 +697,8 @@ static TEE_Result ta_load(struct tee_tadb_ta_read *ta)
 {
 	struct thread_param params[2] = { };
 	TEE_Result res;
-	const size_t sz = ta->entry.prop.custom_size + ta->entry.prop.bin_size;
+	const size_t sz = tee_tadb_custom_size(&ta->entry.prop) +
+			  ta->entry.prop.bin_size;
 
 	if (ta->ta_mobj)
 		return TEE_SUCCESS;
@@ -722,7 +724,8 @@ static TEE_Result ta_load(struct tee_tadb_ta_read *ta)
 TEE_Result tee_tadb_ta_read(struct tee_tadb_ta_read *ta, void *buf, size_t *len)
 {
 	TEE_Result res;
-	const size_t sz = ta->entry.prop.custom_size + ta->entry.prop.bin_size;
+	const size_t sz = tee_tadb_custom_size(&ta->entry.prop) +
+			  ta->entry.prop.bin_size;
 	size_t l = MIN(*len, sz - ta->pos);
 
 	res = ta_load(ta);
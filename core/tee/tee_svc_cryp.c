@@ -5,6 +5,7 @@
  */
 
 #include <assert.h>
+#include <atomic.h>
 #include <bitstring.h>
 #include <compiler.h>
 #include <config.h>
@@ -52,6 +53,20 @@ struct tee_cryp_state {
 	enum cryp_state state;
 };
 
+/*
+ * struct tee_cryp_ks - MAC or cipher context initialized with the key of a
+ * key object, copied into the next state initialized with the same
+ * algorithm and mode instead of deriving the key schedule again. The IV
+ * of a cipher is applied to the copy.
+ */
+struct tee_cryp_ks {
+	uint32_t algo;
+	uint32_t mode;
+	void *ctx;
+};
+
+static struct tee_cryp_cache_stats cache_stats;
+
 struct tee_cryp_obj_secret {
 	uint32_t key_size;
 	uint32_t alloc_size;
@@ -1007,6 +1022,30 @@ TEE_Result syscall_cryp_obj_get_attr(unsigned long obj, unsigned long attr_id,
 	return ops->to_user(attr, sess, buffer, size);
 }
 
+static void tee_cryp_ks_free(struct tee_cryp_ks *ks)
+{
+	if (!ks)
+		return;
+
+	if (TEE_ALG_GET_CLASS(ks->algo) == TEE_OPERATION_CIPHER) {
+		crypto_cipher_final(ks->ctx);
+		crypto_cipher_free_ctx(ks->ctx);
+	} else {
+		crypto_mac_free_ctx(ks->ctx);
+	}
+	free_wipe(ks);
+}
+
+/* Drops what the crypto library has precomputed from the attributes */
+static void tee_obj_attr_changed(struct tee_obj *o)
+{
+	tee_cryp_ks_free(o->ks);
+	o->ks = NULL;
+
+	if (o->attr && o->info.objectType == TEE_TYPE_RSA_KEYPAIR)
+		crypto_acipher_flush_rsa_keypair_cache(o->attr);
+}
+
 void tee_obj_attr_free(struct tee_obj *o)
 {
 	const struct tee_cryp_obj_type_props *tp;
@@ -1014,6 +1053,7 @@ void tee_obj_attr_free(struct tee_obj *o)
 
 	if (!o->attr)
 		return;
+	tee_obj_attr_changed(o);
 	tp = tee_svc_find_type_props(o->info.objectType);
 	if (!tp)
 		return;
@@ -1032,6 +1072,7 @@ void tee_obj_attr_clear(struct tee_obj *o)
 
 	if (!o->attr)
 		return;
+	tee_obj_attr_changed(o);
 	tp = tee_svc_find_type_props(o->info.objectType);
 	if (!tp)
 		return;
@@ -1092,6 +1133,7 @@ TEE_Result tee_obj_attr_from_binary(struct tee_obj *o, const void *data,
 	tp = tee_svc_find_type_props(o->info.objectType);
 	if (!tp)
 		return TEE_ERROR_BAD_STATE;
+	tee_obj_attr_changed(o);
 
 	for (n = 0; n < tp->num_type_attrs; n++) {
 		const struct tee_cryp_obj_type_attrs *ta = tp->type_attrs + n;
@@ -1121,6 +1163,7 @@ TEE_Result tee_obj_attr_copy_from(struct tee_obj *o, const struct tee_obj *src)
 	tp = tee_svc_find_type_props(o->info.objectType);
 	if (!tp)
 		return TEE_ERROR_BAD_STATE;
+	tee_obj_attr_changed(o);
 
 	if (o->info.objectType == src->info.objectType) {
 		have_attrs = src->have_attrs;
@@ -1558,6 +1601,7 @@ static TEE_Result tee_svc_cryp_obj_populate_type(
 	const struct attr_ops *ops = NULL;
 	void *attr = NULL;
 
+	tee_obj_attr_changed(o);
 	for (n = 0; n < attr_count; n++) {
 		idx = tee_svc_cryp_obj_find_type_attr_idx(
 							attrs[n].attributeID,
@@ -2021,6 +2065,80 @@ static TEE_Result tee_svc_cryp_get_state(struct ts_session *sess,
 	return TEE_ERROR_BAD_PARAMETERS;
 }
 
+/* Reads @v and resets it to 0 if @reset, not losing concurrent updates */
+static uint32_t read_stat(uint32_t *v, bool reset)
+{
+	uint32_t val = atomic_load_u32(v);
+
+	if (reset)
+		while (!atomic_cas_u32(v, &val, 0))
+			;
+
+	return val;
+}
+
+void tee_svc_cryp_get_cache_stats(struct tee_cryp_cache_stats *stats,
+				  bool reset)
+{
+	stats->ks_hits = read_stat(&cache_stats.ks_hits, reset);
+	stats->ks_misses = read_stat(&cache_stats.ks_misses, reset);
+	stats->ctx_hits = read_stat(&cache_stats.ctx_hits, reset);
+	stats->ctx_misses = read_stat(&cache_stats.ctx_misses, reset);
+}
+
+/*
+ * Freed digest states are kept in a small pool of the TA. Their context
+ * holds no secret and is reset by the next crypto_hash_init().
+ */
+static bool cryp_ctx_pool_put(struct user_ta_ctx *utc,
+			      struct tee_cryp_state *cs)
+{
+	struct tee_cryp_state *p = NULL;
+	size_t n = 0;
+
+	if (TEE_ALG_GET_CLASS(cs->algo) != TEE_OPERATION_DIGEST || !cs->ctx)
+		return false;
+
+	TAILQ_FOREACH(p, &utc->cryp_ctx_pool, link)
+		n++;
+	if (n + 1 > CFG_CRYPTO_CTX_POOL_SIZE)
+		return false;
+
+	TAILQ_INSERT_HEAD(&utc->cryp_ctx_pool, cs, link);
+	return true;
+}
+
+static void *cryp_ctx_pool_get(struct user_ta_ctx *utc, uint32_t algo)
+{
+	struct tee_cryp_state *p = NULL;
+	void *ctx = NULL;
+
+	TAILQ_FOREACH(p, &utc->cryp_ctx_pool, link) {
+		if (p->algo == algo) {
+			TAILQ_REMOVE(&utc->cryp_ctx_pool, p, link);
+			ctx = p->ctx;
+			free(p);
+			atomic_inc32(&cache_stats.ctx_hits);
+			return ctx;
+		}
+	}
+
+	atomic_inc32(&cache_stats.ctx_misses);
+	return NULL;
+}
+
+static void cryp_ctx_pool_free(struct user_ta_ctx *utc)
+{
+	struct tee_cryp_state *p = NULL;
+
+	while (!TAILQ_EMPTY(&utc->cryp_ctx_pool)) {
+		p = TAILQ_FIRST(&utc->cryp_ctx_pool);
+		TAILQ_REMOVE(&utc->cryp_ctx_pool, p, link);
+		crypto_hash_free_ctx(p->ctx);
+		free(p);
+	}
+}
+
 static void cryp_state_free(struct user_ta_ctx *utc, struct tee_cryp_state *cs)
 {
 	struct tee_obj *o;
@@ -2034,6 +2152,9 @@ static void cryp_state_free(struct user_ta_ctx *utc, struct tee_cryp_state *cs)
 	if (cs->ctx_finalize != NULL)
 		cs->ctx_finalize(cs->ctx);
 
+	if (cryp_ctx_pool_put(utc, cs))
+		return;
+
 	switch (TEE_ALG_GET_CLASS(cs->algo)) {
 	case TEE_OPERATION_CIPHER:
 		crypto_cipher_free_ctx(cs->ctx);
@@ -2232,6 +2353,9 @@ TEE_Result syscall_cryp_state_alloc(unsigned long algo, unsigned long mode,
 		if (key1 != 0 || key2 != 0) {
 			res = TEE_ERROR_BAD_PARAMETERS;
 		} else {
+			cs->ctx = cryp_ctx_pool_get(utc, algo);
+			if (cs->ctx)
+				break;
 			res = crypto_hash_alloc_ctx(&cs->ctx, algo);
 			if (res != TEE_SUCCESS)
 				break;
@@ -2329,8 +2453,92 @@ void tee_svc_cryp_free_states(struct user_ta_ctx *utc)
 
 	while (!TAILQ_EMPTY(states))
 		cryp_state_free(utc, TAILQ_FIRST(states));
+	cryp_ctx_pool_free(utc);
 }
 
+#ifdef CFG_CRYPTO_KEY_CACHE
+/*
+ * Initializes @cs by copying the context cached with @o if it was
+ * initialized with the same algorithm and mode, then restarts it with @iv
+ * if supplied. Returns false if @cs must be initialized from the key.
+ */
+static bool cryp_ks_restore(struct tee_obj *o, struct tee_cryp_state *cs,
+			    const void *iv, size_t iv_len)
+{
+	struct tee_cryp_ks *ks = o->ks;
+
+	if (!ks || ks->algo != cs->algo || ks->mode != cs->mode)
+		goto miss;
+
+	if (TEE_ALG_GET_CLASS(cs->algo) == TEE_OPERATION_CIPHER) {
+		crypto_cipher_copy_state(cs->ctx, ks->ctx);
+		if (iv_len && crypto_cipher_set_iv(cs->ctx, iv, iv_len))
+			goto miss;
+	} else {
+		crypto_mac_copy_state(cs->ctx, ks->ctx);
+	}
+	atomic_inc32(&cache_stats.ks_hits);
+
+	return true;
+miss:
+	atomic_inc32(&cache_stats.ks_misses);
+	return false;
+}
+
+/*
+ * Caches with @o a copy of @cs just initialized from the key of @o with
+ * @iv. A cipher context which can't be restarted with another IV is not
+ * cached since it could only serve operations reusing the same IV.
+ */
+static void cryp_ks_save(struct tee_obj *o, struct tee_cryp_state *cs,
+			 const void *iv, size_t iv_len)
+{
+	struct tee_cryp_ks *ks = NULL;
+	TEE_Result res = TEE_SUCCESS;
+
+	ks = calloc(1, sizeof(*ks));
+	if (!ks)
+		return;
+
+	if (TEE_ALG_GET_CLASS(cs->algo) == TEE_OPERATION_CIPHER)
+		res = crypto_cipher_alloc_ctx(&ks->ctx, cs->algo);
+	else
+		res = crypto_mac_alloc_ctx(&ks->ctx, cs->algo);
+	if (res) {
+		free(ks);
+		return;
+	}
+	ks->algo = cs->algo;
+	ks->mode = cs->mode;
+
+	if (TEE_ALG_GET_CLASS(cs->algo) == TEE_OPERATION_CIPHER) {
+		crypto_cipher_copy_state(ks->ctx, cs->ctx);
+		if (iv_len && crypto_cipher_set_iv(ks->ctx, iv, iv_len)) {
+			tee_cryp_ks_free(ks);
+			return;
+		}
+	} else {
+		crypto_mac_copy_state(ks->ctx, cs->ctx);
+	}
+
+	tee_cryp_ks_free(o->ks);
+	o->ks = ks;
+}
+#else
+static bool cryp_ks_restore(struct tee_obj *o __unused,
+			    struct tee_cryp_state *cs __unused,
+			    const void *iv __unused, size_t iv_len __unused)
+{
+	return false;
+}
+
+static void cryp_ks_save(struct tee_obj *o __unused,
+			 struct tee_cryp_state *cs __unused,
+			 const void *iv __unused, size_t iv_len __unused)
+{
+}
+#endif
+
 TEE_Result syscall_cryp_state_free(unsigned long state)
 {
 	struct ts_session *sess = ts_get_current_session();
@@ -2375,11 +2583,15 @@ TEE_Result syscall_hash_init(unsigned long state,
 			     TEE_HANDLE_FLAG_INITIALIZED) == 0)
 				return TEE_ERROR_BAD_PARAMETERS;
 
+			if (cryp_ks_restore(o, cs, NULL, 0))
+				break;
+
 			key = (struct tee_cryp_obj_secret *)o->attr;
 			res = crypto_mac_init(cs->ctx, (void *)(key + 1),
 					      key->key_size);
 			if (res != TEE_SUCCESS)
 				return res;
+			cryp_ks_save(o, cs, NULL, 0);
 			break;
 		}
 	default:
@@ -2571,10 +2783,12 @@ TEE_Result syscall_cipher_init(unsigned long state, const void *iv,
 					 (uint8_t *)(key1 + 1), key1->key_size,
 					 (uint8_t *)(key2 + 1), key2->key_size,
 					 iv, iv_len);
-	} else {
+	} else if (!cryp_ks_restore(o, cs, iv, iv_len)) {
 		res = crypto_cipher_init(cs->ctx, cs->mode,
 					 (uint8_t *)(key1 + 1), key1->key_size,
 					 NULL, 0, iv, iv_len);
+		if (res == TEE_SUCCESS)
+			cryp_ks_save(o, cs, iv, iv_len);
 	}
 	if (res != TEE_SUCCESS)
 		return res;
@@ -3498,6 +3712,68 @@ out:
 	return res;
 }
 
+TEE_Result syscall_cryp_update_vec(struct utee_cryp_update *upd,
+				   unsigned long count)
+{
+	struct ts_session *sess = ts_get_current_session();
+	struct utee_cryp_update u = { };
+	struct tee_cryp_state *cs = NULL;
+	TEE_Result res = TEE_SUCCESS;
+	TEE_Result res2 = TEE_SUCCESS;
+	void *src = NULL;
+	void *dst = NULL;
+	size_t sz = 0;
+	size_t n = 0;
+
+	if (MUL_OVERFLOW(count, sizeof(*upd), &sz) ||
+	    ADD_OVERFLOW((vaddr_t)upd, sz, &sz))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	for (n = 0; n < count; n++) {
+		res = copy_from_user(&u, upd + n, sizeof(u));
+		if (res)
+			return res;
+
+		res = tee_svc_cryp_get_state(sess, uref_to_vaddr(u.state), &cs);
+		if (res)
+			return res;
+
+		src = (void *)(vaddr_t)u.src;
+		dst = (void *)(vaddr_t)u.dst;
+
+		/*
+		 * Each update goes through the syscall of a single update
+		 * so that all the checks are the same, only the kernel
+		 * entries and exits are saved.
+		 */
+		switch (TEE_ALG_GET_CLASS(cs->algo)) {
+		case TEE_OPERATION_CIPHER:
+			res = syscall_cipher_update(u.state, src, u.src_len,
+						    dst, &upd[n].dst_len);
+			break;
+		case TEE_OPERATION_AE:
+			res = syscall_authenc_update_payload(u.state, src,
+							     u.src_len, dst,
+							     &upd[n].dst_len);
+			break;
+		case TEE_OPERATION_MAC:
+			res = syscall_hash_update(u.state, src, u.src_len);
+			break;
+		default:
+			res = TEE_ERROR_BAD_STATE;
+			break;
+		}
+
+		res2 = copy_to_user(&upd[n].res, &res, sizeof(res));
+		if (res2)
+			return res2;
+		if (res)
+			return res;
+	}
+
+	return TEE_SUCCESS;
+}
+
 static int pkcs1_get_salt_len(const TEE_Attribute *params, uint32_t num_params,
 			      size_t default_len)
 {
@@ -215,10 +215,10 @@ static void save_hashtab_from_segment(struct ta_elf *elf, unsigned int type,
 
 	for (n = 0; n < num_dyns; n++) {
 		read_dyn(elf, addr, n, &tag, &val);
-		if (tag == DT_HASH) {
+		if (tag == DT_HASH)
 			elf->hashtab = (void *)(val + elf->load_addr);
-			break;
-		}
+		else if (tag == DT_GNU_HASH)
+			elf->gnu_hashtab = (void *)(val + elf->load_addr);
 	}
 }
 
@@ -262,6 +262,45 @@ static void check_hashtab(struct ta_elf *elf, void *ptr, size_t num_buckets,
 	check_range(elf, "DT_HASH", ptr, sz);
 }
 
+static void check_gnu_hashtab(struct ta_elf *elf, void *ptr)
+{
+	/*
+	 * The four first words hold num_buckets, sym_offset, bloom_size
+	 * and bloom_shift. They are followed by bloom_size words of the
+	 * bloom filter, 32-bit or 64-bit depending on the ELF class, then
+	 * num_buckets buckets and one chain word per symbol from sym_offset
+	 * to the end of the dynamic symbol table.
+	 */
+	size_t bloom_word_size = sizeof(uint64_t);
+	uint32_t *hashtab = ptr;
+	size_t num_words = 4;
+	size_t bloom_sz = 0;
+	size_t sz = 0;
+
+	if (elf->is_32bit)
+		bloom_word_size = sizeof(uint32_t);
+
+	if (!IS_ALIGNED((vaddr_t)ptr, bloom_word_size))
+		err(TEE_ERROR_BAD_FORMAT, "Bad alignment of DT_GNU_HASH %p",
+		    ptr);
+
+	check_range(elf, "DT_GNU_HASH", ptr, num_words * sizeof(uint32_t));
+
+	if (!hashtab[0] || hashtab[1] > elf->num_dynsyms ||
+	    !IS_POWER_OF_TWO(hashtab[2]) || hashtab[3] >= 32)
+		err(TEE_ERROR_BAD_FORMAT, "Bad DT_GNU_HASH header");
+
+	if (ADD_OVERFLOW(num_words, hashtab[0], &num_words) ||
+	    ADD_OVERFLOW(num_words, elf->num_dynsyms - hashtab[1],
+			 &num_words) ||
+	    MUL_OVERFLOW(num_words, sizeof(uint32_t), &sz) ||
+	    MUL_OVERFLOW(hashtab[2], bloom_word_size, &bloom_sz) ||
+	    ADD_OVERFLOW(sz, bloom_sz, &sz))
+		err(TEE_ERROR_BAD_FORMAT, "DT_GNU_HASH overflow");
+
+	check_range(elf, "DT_GNU_HASH", ptr, sz);
+}
+
 static void save_hashtab(struct ta_elf *elf)
 {
 	uint32_t *hashtab = NULL;
@@ -283,9 +322,15 @@ static void save_hashtab(struct ta_elf *elf)
 						  phdr[n].p_memsz);
 	}
 
-	check_hashtab(elf, elf->hashtab, 0, 0);
-	hashtab = elf->hashtab;
-	check_hashtab(elf, elf->hashtab, hashtab[0], hashtab[1]);
+	if (elf->gnu_hashtab)
+		check_gnu_hashtab(elf, elf->gnu_hashtab);
+
+	/* DT_HASH is mandatory unless there's a DT_GNU_HASH to use instead */
+	if (elf->hashtab || !elf->gnu_hashtab) {
+		check_hashtab(elf, elf->hashtab, 0, 0);
+		hashtab = elf->hashtab;
+		check_hashtab(elf, elf->hashtab, hashtab[0], hashtab[1]);
+	}
 }
 
 static void save_soname_from_segment(struct ta_elf *elf, unsigned int type,
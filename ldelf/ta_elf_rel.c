@@ -32,6 +32,39 @@ static uint32_t elf_hash(const char *name)
 	return h;
 }
 
+static uint32_t gnu_hash(const char *name)
+{
+	const unsigned char *p = (const unsigned char *)name;
+	uint32_t h = 5381;
+
+	while (*p)
+		h = (h << 5) + h + *p++;
+	return h;
+}
+
+struct sym_hash {
+	uint32_t sysv;
+	uint32_t gnu;
+};
+
+/*
+ * Symbols found when relocating a module, looked up first when relocating
+ * the next ones since the modules of a TA tend to import the same symbols.
+ * Modules are only ever added at the end of main_elf_queue so a symbol
+ * found once keeps resolving to the same module and value. @name points
+ * into the .dynstr of a loaded module which stays mapped.
+ */
+#define SYM_CACHE_SIZE	256
+
+struct sym_cache_entry {
+	const char *name;
+	uint32_t hash;
+	vaddr_t val;
+	struct ta_elf *elf;
+};
+
+static struct sym_cache_entry sym_cache[SYM_CACHE_SIZE];
+
 static bool __resolve_sym(struct ta_elf *elf, unsigned int st_bind,
 			  unsigned int st_type, size_t st_shndx,
 			  size_t st_name, size_t st_value, const char *name,
@@ -78,9 +111,39 @@ static bool __resolve_sym(struct ta_elf *elf, unsigned int st_bind,
 	return true;
 }
 
-static TEE_Result resolve_sym_helper(uint32_t hash, const char *name,
-				     vaddr_t *val, struct ta_elf *elf,
-				     bool weak_ok)
+static bool resolve_sym_idx(struct ta_elf *elf, size_t n, const char *name,
+			    vaddr_t *val, bool weak_ok)
+{
+	if (n >= elf->num_dynsyms)
+		err(TEE_ERROR_BAD_FORMAT, "Index out of range");
+	/*
+	 * We're loading values from sym[] which later will be used to
+	 * load something.
+	 * => Spectre V1 pattern, need to cap the index against
+	 * speculation.
+	 */
+	n = confine_array_index(n, elf->num_dynsyms);
+
+	if (elf->is_32bit) {
+		Elf32_Sym *sym = elf->dynsymtab;
+
+		return __resolve_sym(elf, ELF32_ST_BIND(sym[n].st_info),
+				     ELF32_ST_TYPE(sym[n].st_info),
+				     sym[n].st_shndx, sym[n].st_name,
+				     sym[n].st_value, name, val, weak_ok);
+	} else {
+		Elf64_Sym *sym = elf->dynsymtab;
+
+		return __resolve_sym(elf, ELF64_ST_BIND(sym[n].st_info),
+				     ELF64_ST_TYPE(sym[n].st_info),
+				     sym[n].st_shndx, sym[n].st_name,
+				     sym[n].st_value, name, val, weak_ok);
+	}
+}
+
+static TEE_Result resolve_sym_sysv(uint32_t hash, const char *name,
+				   vaddr_t *val, struct ta_elf *elf,
+				   bool weak_ok)
 {
 	/*
 	 * Using uint32_t here for convenience because both Elf64_Word
@@ -93,85 +156,112 @@ static TEE_Result resolve_sym_helper(uint32_t hash, const char *name,
 	uint32_t *chain = &bucket[nbuckets];
 	size_t n = 0;
 
-	if (elf->is_32bit) {
-		Elf32_Sym *sym = elf->dynsymtab;
+	for (n = bucket[hash % nbuckets]; n; n = chain[n]) {
+		if (n >= nchains)
+			err(TEE_ERROR_BAD_FORMAT, "Index out of range");
+		if (resolve_sym_idx(elf, n, name, val, weak_ok))
+			return TEE_SUCCESS;
+	}
 
-		for (n = bucket[hash % nbuckets]; n; n = chain[n]) {
-			if (n >= nchains || n >= elf->num_dynsyms)
-				err(TEE_ERROR_BAD_FORMAT,
-				    "Index out of range");
-			/*
-			 * We're loading values from sym[] which later
-			 * will be used to load something.
-			 * => Spectre V1 pattern, need to cap the index
-			 * against speculation.
-			 */
-			n = confine_array_index(n, elf->num_dynsyms);
-			if (__resolve_sym(elf,
-					  ELF32_ST_BIND(sym[n].st_info),
-					  ELF32_ST_TYPE(sym[n].st_info),
-					  sym[n].st_shndx,
-					  sym[n].st_name,
-					  sym[n].st_value, name, val, weak_ok))
-				return TEE_SUCCESS;
-		}
-	} else {
-		Elf64_Sym *sym = elf->dynsymtab;
+	return TEE_ERROR_ITEM_NOT_FOUND;
+}
 
-		for (n = bucket[hash % nbuckets]; n; n = chain[n]) {
-			if (n >= nchains || n >= elf->num_dynsyms)
-				err(TEE_ERROR_BAD_FORMAT,
-				    "Index out of range");
-			/*
-			 * We're loading values from sym[] which later
-			 * will be used to load something.
-			 * => Spectre V1 pattern, need to cap the index
-			 * against speculation.
-			 */
-			n = confine_array_index(n, elf->num_dynsyms);
-			if (__resolve_sym(elf,
-					  ELF64_ST_BIND(sym[n].st_info),
-					  ELF64_ST_TYPE(sym[n].st_info),
-					  sym[n].st_shndx,
-					  sym[n].st_name,
-					  sym[n].st_value, name, val, weak_ok))
-				return TEE_SUCCESS;
-		}
+static TEE_Result resolve_sym_gnu(uint32_t hash, const char *name,
+				  vaddr_t *val, struct ta_elf *elf,
+				  bool weak_ok)
+{
+	/* The layout is checked by check_gnu_hashtab() in ta_elf.c */
+	uint32_t *hashtab = elf->gnu_hashtab;
+	uint32_t nbuckets = hashtab[0];
+	uint32_t symoffset = hashtab[1];
+	uint32_t bloom_size = hashtab[2];
+	uint32_t bloom_shift = hashtab[3];
+	uint32_t *bucket = NULL;
+	uint32_t *chain = NULL;
+	uint32_t h = 0;
+	size_t n = 0;
+
+	/*
+	 * The bloom filter tells with two bits per symbol that a name
+	 * isn't defined in this module, that's the common case when
+	 * searching all modules for a symbol.
+	 */
+	if (elf->is_32bit) {
+		uint32_t *bloom = hashtab + 4;
+		uint32_t word = bloom[(hash / 32) & (bloom_size - 1)];
+		uint32_t mask = BIT32(hash % 32) |
+				BIT32((hash >> bloom_shift) % 32);
+
+		if ((word & mask) != mask)
+			return TEE_ERROR_ITEM_NOT_FOUND;
+		bucket = bloom + bloom_size;
+	} else {
+		uint64_t *bloom = (uint64_t *)(hashtab + 4);
+		uint64_t word = bloom[(hash / 64) & (bloom_size - 1)];
+		uint64_t mask = BIT64(hash % 64) |
+				BIT64((hash >> bloom_shift) % 64);
+
+		if ((word & mask) != mask)
+			return TEE_ERROR_ITEM_NOT_FOUND;
+		bucket = (uint32_t *)(bloom + bloom_size);
 	}
+	chain = bucket + nbuckets;
+
+	n = bucket[hash % nbuckets];
+	if (!n)
+		return TEE_ERROR_ITEM_NOT_FOUND;
+	if (n < symoffset)
+		err(TEE_ERROR_BAD_FORMAT, "Index out of range");
+
+	/*
+	 * Symbols of a bucket are consecutive, the lowest bit of the
+	 * chain word of the last one is set and the other bits hold the
+	 * hash of the symbol.
+	 */
+	do {
+		if (n >= elf->num_dynsyms)
+			err(TEE_ERROR_BAD_FORMAT, "Index out of range");
+		n = confine_array_index(n, elf->num_dynsyms);
+		h = chain[n - symoffset];
+		if ((h | 1) == (hash | 1) &&
+		    resolve_sym_idx(elf, n, name, val, weak_ok))
+			return TEE_SUCCESS;
+		n++;
+	} while (!(h & 1));
 
 	return TEE_ERROR_ITEM_NOT_FOUND;
 }
 
-/*
- * Look for named symbol in @elf, or all modules if @elf == NULL. Global symbols
- * are searched first, then weak ones. Last option, when at least one weak but
- * undefined symbol exists, resolve to zero. Otherwise return
- * TEE_ERROR_ITEM_NOT_FOUND.
- * @val (if != 0) receives the symbol value
- * @found_elf (if != 0) receives the module where the symbol is found
- */
-TEE_Result ta_elf_resolve_sym(const char *name, vaddr_t *val,
-			      struct ta_elf **found_elf,
-			      struct ta_elf *elf)
+static TEE_Result resolve_sym_helper(const struct sym_hash *sh,
+				     const char *name, vaddr_t *val,
+				     struct ta_elf *elf, bool weak_ok)
 {
-	uint32_t hash = elf_hash(name);
+	if (elf->gnu_hashtab)
+		return resolve_sym_gnu(sh->gnu, name, val, elf, weak_ok);
+	return resolve_sym_sysv(sh->sysv, name, val, elf, weak_ok);
+}
 
+static TEE_Result resolve_sym_hashed(const struct sym_hash *sh,
+				     const char *name, vaddr_t *val,
+				     struct ta_elf **found_elf,
+				     struct ta_elf *elf)
+{
 	if (elf) {
 		/* Search global symbols */
-		if (!resolve_sym_helper(hash, name, val, elf,
+		if (!resolve_sym_helper(sh, name, val, elf,
 					false /* !weak_ok */))
 			goto success;
 		/* Search weak symbols */
-		if (!resolve_sym_helper(hash, name, val, elf,
+		if (!resolve_sym_helper(sh, name, val, elf,
 					true /* weak_ok */))
 			goto success;
 	}
 
 	TAILQ_FOREACH(elf, &main_elf_queue, link) {
-		if (!resolve_sym_helper(hash, name, val, elf,
+		if (!resolve_sym_helper(sh, name, val, elf,
 					false /* !weak_ok */))
 			goto success;
-		if (!resolve_sym_helper(hash, name, val, elf,
+		if (!resolve_sym_helper(sh, name, val, elf,
 					true /* weak_ok */))
 			goto success;
 	}
@@ -184,6 +274,23 @@ success:
 	return TEE_SUCCESS;
 }
 
+/*
+ * Look for named symbol in @elf, or all modules if @elf == NULL. Global symbols
+ * are searched first, then weak ones. Last option, when at least one weak but
+ * undefined symbol exists, resolve to zero. Otherwise return
+ * TEE_ERROR_ITEM_NOT_FOUND.
+ * @val (if != 0) receives the symbol value
+ * @found_elf (if != 0) receives the module where the symbol is found
+ */
+TEE_Result ta_elf_resolve_sym(const char *name, vaddr_t *val,
+			      struct ta_elf **found_elf,
+			      struct ta_elf *elf)
+{
+	struct sym_hash sh = { .sysv = elf_hash(name), .gnu = gnu_hash(name) };
+
+	return resolve_sym_hashed(&sh, name, val, found_elf, elf);
+}
+
 static void e32_get_sym_name(const Elf32_Sym *sym_tab, size_t num_syms,
 			     const char *str_tab, size_t str_tab_size,
 			     Elf32_Rel *rel, const char **name)
@@ -204,10 +311,30 @@ static void e32_get_sym_name(const Elf32_Sym *sym_tab, size_t num_syms,
 
 static void resolve_sym(const char *name, vaddr_t *val, struct ta_elf **mod)
 {
-	TEE_Result res = ta_elf_resolve_sym(name, val, mod, NULL);
+	struct sym_hash sh = { .sysv = elf_hash(name), .gnu = gnu_hash(name) };
+	struct sym_cache_entry *ce = sym_cache + sh.gnu % SYM_CACHE_SIZE;
+	struct ta_elf *found_elf = NULL;
+	TEE_Result res = TEE_SUCCESS;
+	vaddr_t found_val = 0;
+
+	if (ce->name && ce->hash == sh.gnu && !strcmp(ce->name, name)) {
+		found_val = ce->val;
+		found_elf = ce->elf;
+	} else {
+		res = resolve_sym_hashed(&sh, name, &found_val, &found_elf,
+					 NULL);
+		if (res)
+			err(res, "Symbol %s not found", name);
+		ce->name = name;
+		ce->hash = sh.gnu;
+		ce->val = found_val;
+		ce->elf = found_elf;
+	}
 
-	if (res)
-		err(res, "Symbol %s not found", name);
+	if (val)
+		*val = found_val;
+	if (mod)
+		*mod = found_elf;
 }
 
 static void e32_process_dyn_rel(const Elf32_Sym *sym_tab, size_t num_syms,
@@ -101,12 +101,25 @@ static void mbed_aes_cbc_copy_state(struct crypto_cipher_ctx *dst_ctx,
 	mbed_copy_mbedtls_aes_context(&dst->aes_ctx, &src->aes_ctx);
 }
 
+static TEE_Result mbed_aes_cbc_set_iv(struct crypto_cipher_ctx *ctx,
+				      const uint8_t *iv, size_t iv_len)
+{
+	struct mbed_aes_cbc_ctx *c = to_aes_cbc_ctx(ctx);
+
+	if (iv_len != sizeof(c->iv))
+		return TEE_ERROR_BAD_PARAMETERS;
+	memcpy(c->iv, iv, sizeof(c->iv));
+
+	return TEE_SUCCESS;
+}
+
 static const struct crypto_cipher_ops mbed_aes_cbc_ops = {
 	.init = mbed_aes_cbc_init,
 	.update = mbed_aes_cbc_update,
 	.final = mbed_aes_cbc_final,
 	.free_ctx = mbed_aes_cbc_free_ctx,
 	.copy_state = mbed_aes_cbc_copy_state,
+	.set_iv = mbed_aes_cbc_set_iv,
 };
 
 TEE_Result crypto_aes_cbc_alloc_ctx(struct crypto_cipher_ctx **ctx_ret)
@@ -96,12 +96,27 @@ static void mbed_aes_ctr_copy_state(struct crypto_cipher_ctx *dst_ctx,
 	mbed_copy_mbedtls_aes_context(&dst->aes_ctx, &src->aes_ctx);
 }
 
+static TEE_Result mbed_aes_ctr_set_iv(struct crypto_cipher_ctx *ctx,
+				      const uint8_t *iv, size_t iv_len)
+{
+	struct mbed_aes_ctr_ctx *c = to_aes_ctr_ctx(ctx);
+
+	if (iv_len != sizeof(c->counter))
+		return TEE_ERROR_BAD_PARAMETERS;
+	memcpy(c->counter, iv, sizeof(c->counter));
+	memset(c->block, 0, sizeof(c->block));
+	c->nc_off = 0;
+
+	return TEE_SUCCESS;
+}
+
 static const struct crypto_cipher_ops mbed_aes_ctr_ops = {
 	.init = mbed_aes_ctr_init,
 	.update = mbed_aes_ctr_update,
 	.final = mbed_aes_ctr_final,
 	.free_ctx = mbed_aes_ctr_free_ctx,
 	.copy_state = mbed_aes_ctr_copy_state,
+	.set_iv = mbed_aes_ctr_set_iv,
 };
 
 TEE_Result crypto_aes_ctr_alloc_ctx(struct crypto_cipher_ctx **ctx_ret)
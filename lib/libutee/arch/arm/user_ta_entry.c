@@ -155,6 +155,7 @@ static TEE_Result init_instance(void)
 	trace_set_level(tahead_get_trace_level());
 	__utee_gprof_init();
 	malloc_add_pool(ta_heap, ta_heap_size);
+	__utee_rng_reset();
 	_TEE_MathAPI_Init();
 	__utee_tcb_init();
 	__utee_call_elf_init_fn();
@@ -166,6 +167,7 @@ static void uninit_instance(void)
 	__utee_gprof_fini();
 	TA_DestroyEntryPoint();
 	__utee_call_elf_fini_fn();
+	__utee_rng_reset();
 }
 
 static void ta_header_save_params(uint32_t param_types,
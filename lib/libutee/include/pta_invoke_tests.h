@@ -63,9 +63,19 @@
  * [in]  value[0].b	delay number
  * [out] value[1].a	before lock concurency
  * [out] value[1].b	during lock concurency
+ *
+ * PTA_MUTEX_TEST_RWLOCK_* run the same tests on a struct rwlock.
+ *
+ * PTA_MUTEX_TEST_*READER_BENCH take and release the read lock value[0].b
+ * times for the caller to time, value[1].b reports the maximum number of
+ * concurrent readers seen and value[1].a is 0.
  */
 #define PTA_MUTEX_TEST_WRITER			0
 #define PTA_MUTEX_TEST_READER			1
+#define PTA_MUTEX_TEST_RWLOCK_WRITER		2
+#define PTA_MUTEX_TEST_RWLOCK_READER		3
+#define PTA_MUTEX_TEST_READER_BENCH		4
+#define PTA_MUTEX_TEST_RWLOCK_READER_BENCH	5
 #define PTA_INVOKE_TESTS_CMD_MUTEX		7
 
 /*
@@ -93,6 +103,11 @@
  * [in]     value[1].b	unit size
  * [in]     memref[2]	In buffer
  * [in]     memref[3]	Out buffer
+ *
+ * If value[1] is passed as an in/out parameter it's updated with the
+ * result of the run:
+ * [out]    value[1].a	elapsed time in microseconds
+ * [out]    value[1].b	throughput in MB/s
  */
 #define PTA_INVOKE_TEST_CMD_AES_PERF		9
 
@@ -103,5 +118,30 @@
  */
 #define PTA_INVOKE_TESTS_CMD_MEMREF_NULL	10
 
+/*
+ * Hash performance tests, each repetition hashes the whole in buffer
+ * with a fresh hash operation
+ *
+ * [in]     value[0].a	Hash algorithm, TEE_ALG_MD5 or one of TEE_ALG_SHA*
+ * [in/out] value[1].a	in: repetition count, out: elapsed time in
+ *			microseconds
+ * [in/out] value[1].b	in: unit size of each update, out: throughput in
+ *			MB/s
+ * [in]     memref[2]	In buffer
+ */
+#define PTA_INVOKE_TEST_CMD_HASH_PERF		11
+
+/*
+ * RNG performance tests, meant to be run from several threads at the same
+ * time to measure the contention between the readers
+ *
+ * [in/out] value[0].a	in: number of reads, out: elapsed time in
+ *			microseconds
+ * [in/out] value[0].b	in: size of each read, out: throughput in MB/s
+ * [out]    value[1].a	number of reads which had to wait for another
+ *			reader during the test, on any core
+ */
+#define PTA_INVOKE_TEST_CMD_RNG_PERF		12
+
 #endif /*__PTA_INVOKE_TESTS_H*/
 
@@ -78,4 +78,45 @@ TEE_Result tee_invoke_supp_plugin(const TEE_UUID *uuid, uint32_t cmd,
 				  uint32_t sub_cmd, void *buf, size_t len,
 				  size_t *outlen);
 
+/*
+ * struct tee_crypto_update - one update of tee_crypto_update_batch()
+ * @op:		Initialized cipher, AE or MAC operation
+ * @src:	Input data
+ * @src_len:	Length of @src
+ * @dst:	Output buffer, unused for MAC operations
+ * @dst_len:	in: size of @dst, out: number of bytes written to @dst
+ * @res:	out: result of the update
+ */
+struct tee_crypto_update {
+	TEE_OperationHandle op;
+	const void *src;
+	size_t src_len;
+	void *dst;
+	size_t dst_len;
+	TEE_Result res;
+};
+
+/*
+ * tee_crypto_update_batch() - Process several updates with few syscalls
+ * @upd:	Array of updates
+ * @count:	Number of elements in @upd
+ *
+ * Each element is processed in order as with TEE_CipherUpdate(),
+ * TEE_AEUpdate() or TEE_MACUpdate(), for instance one record per element.
+ * Nothing is buffered between elements: for the operations libutee
+ * processes by whole blocks, that is the ECB and CBC modes, AES-CCM and
+ * SM4-CTR, each @src_len must be a multiple of the block size and the
+ * operation must not hold data buffered by a previous update. AES-CTR,
+ * AES-GCM and MAC operations accept any @src_len. AES-CTS and AES-XTS
+ * are not supported.
+ *
+ * Return TEE_SUCCESS on success, TEE_ERROR_SHORT_BUFFER with the required
+ * size in @dst_len of the first element with a too small output buffer
+ * or TEE_ERROR_BAD_PARAMETERS if an element can't be processed this way.
+ * These are checked before any element is processed, other errors panic
+ * the TA as with the single update functions.
+ */
+TEE_Result tee_crypto_update_batch(struct tee_crypto_update *upd,
+				   size_t count);
+
 #endif
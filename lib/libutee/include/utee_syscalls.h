@@ -286,6 +286,13 @@ TEE_Result _utee_se_channel_close(unsigned long c);
 /* op is of type enum _utee_cache_operation */
 TEE_Result _utee_cache_operation(void *va, size_t l, unsigned long op);
 
+/*
+ * Processes @count updates of cipher, AE or MAC states in order, stops at
+ * the first failing one
+ */
+TEE_Result _utee_cryp_update_vec(struct utee_cryp_update *upd,
+				 unsigned long count);
+
 TEE_Result _utee_gprof_send(void *buf, size_t size, uint32_t *id);
 
 #endif /* UTEE_SYSCALLS_H */
@@ -47,4 +47,22 @@ struct utee_attribute {
 	uint32_t attribute_id;
 };
 
+/*
+ * struct utee_cryp_update - one update of _utee_cryp_update_vec()
+ * @state:	Cipher, AE or MAC state
+ * @src:	Input buffer
+ * @src_len:	Length of @src
+ * @dst:	Output buffer, ignored for MAC states
+ * @dst_len:	in: size of @dst, out: number of bytes written to @dst
+ * @res:	out: result of the update
+ */
+struct utee_cryp_update {
+	uint64_t state;
+	uint64_t src;
+	uint64_t src_len;
+	uint64_t dst;
+	uint64_t dst_len;
+	uint32_t res;
+};
+
 #endif /* UTEE_TYPES_H */
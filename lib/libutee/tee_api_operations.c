@@ -1814,12 +1814,112 @@ void TEE_DeriveKey(TEE_OperationHandle operation,
 		TEE_Panic(res);
 }
 
+/* Maximum number of updates passed in a single syscall */
+#define CRYPTO_UPDATE_BATCH	16
+
+static TEE_Result check_batch_update(struct tee_crypto_update *u)
+{
+	TEE_OperationHandle op = u->op;
+
+	if (op == TEE_HANDLE_NULL || (!u->src && u->src_len))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	switch (op->info.operationClass) {
+	case TEE_OPERATION_CIPHER:
+	case TEE_OPERATION_MAC:
+		if (op->operationState != TEE_OPERATION_STATE_ACTIVE)
+			return TEE_ERROR_BAD_PARAMETERS;
+		break;
+	case TEE_OPERATION_AE:
+		break;
+	default:
+		return TEE_ERROR_BAD_PARAMETERS;
+	}
+
+	if (!(op->info.handleState & TEE_HANDLE_FLAG_INITIALIZED))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if (op->info.operationClass == TEE_OPERATION_MAC)
+		return TEE_SUCCESS;
+
+	/* Nothing may be left to buffer in the operation */
+	if (op->block_size > 1 &&
+	    (op->buffer_two_blocks || op->buffer_offs ||
+	     u->src_len % op->block_size))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if (u->dst_len < u->src_len) {
+		u->dst_len = u->src_len;
+		return TEE_ERROR_SHORT_BUFFER;
+	}
+
+	return TEE_SUCCESS;
+}
+
+TEE_Result tee_crypto_update_batch(struct tee_crypto_update *upd,
+				   size_t count)
+{
+	struct utee_cryp_update uu[CRYPTO_UPDATE_BATCH] = { };
+	TEE_Result res = TEE_SUCCESS;
+	size_t l = 0;
+	size_t n = 0;
+	size_t m = 0;
+
+	if (!upd && count)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	for (n = 0; n < count; n++) {
+		res = check_batch_update(upd + n);
+		if (res)
+			return res;
+	}
+
+	for (n = 0; n < count; n += l) {
+		l = MIN(count - n, (size_t)CRYPTO_UPDATE_BATCH);
+
+		for (m = 0; m < l; m++) {
+			struct tee_crypto_update *u = upd + n + m;
+
+			uu[m].state = u->op->state;
+			uu[m].src = (vaddr_t)u->src;
+			uu[m].src_len = u->src_len;
+			uu[m].dst = (vaddr_t)u->dst;
+			uu[m].dst_len = u->dst_len;
+			uu[m].res = TEE_SUCCESS;
+		}
+
+		res = _utee_cryp_update_vec(uu, l);
+		if (res)
+			TEE_Panic(res);
+
+		for (m = 0; m < l; m++) {
+			struct tee_crypto_update *u = upd + n + m;
+
+			u->res = uu[m].res;
+			if (u->op->info.operationClass == TEE_OPERATION_MAC) {
+				u->dst_len = 0;
+			} else {
+				u->dst_len = uu[m].dst_len;
+				u->op->operationState =
+					TEE_OPERATION_STATE_ACTIVE;
+			}
+		}
+	}
+
+	return TEE_SUCCESS;
+}
+
 /* Cryptographic Operations API - Random Number Generation Functions */
 
 void TEE_GenerateRandom(void *randomBuffer, uint32_t randomBufferLen)
 {
 	TEE_Result res;
 
+	if (IS_ENABLED(CFG_TA_BUFFERED_RNG)) {
+		__utee_rng_generate(randomBuffer, randomBufferLen);
+		return;
+	}
+
 	res = _utee_cryp_random_number_generate(randomBuffer, randomBufferLen);
 	if (res != TEE_SUCCESS)
 		TEE_Panic(res);
@@ -24,6 +24,16 @@ static inline void __utee_gprof_init(void) {}
 static inline void __utee_gprof_fini(void) {}
 #endif
 
+/* Fills @buf with @len random bytes, panics on error */
+void __utee_rng_generate(void *buf, size_t len);
+
+#if defined(CFG_TA_BUFFERED_RNG)
+/* Drops the state of the generator, reseeded on next use */
+void __utee_rng_reset(void);
+#else
+static inline void __utee_rng_reset(void) {}
+#endif
+
 /*
  * The functions help checking that the pointers comply with the parameters
  * annotation as described in the spec. Any descrepency results in a panic
@@ -0,0 +1,183 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2022, Microchip
+ */
+
+/*
+ * Buffered random number generator of the TA
+ *
+ * Small random requests are served from a buffer of ChaCha20 keystream
+ * instead of a syscall each. The first 32 bytes of each refill replace
+ * the key (fast key erasure) so that a later compromise of the state
+ * doesn't reveal bytes already returned. The key is mixed with 32 bytes
+ * from the TEE core RNG when the instance is initialized and then after
+ * each RNG_RESEED_INTERVAL bytes of output. The block function is checked
+ * against the RFC 7539 test vectors before the first seed.
+ */
+
+#include <compiler.h>
+#include <string.h>
+#include <string_ext.h>
+#include <tee_api.h>
+#include <types_ext.h>
+#include <util.h>
+#include <utee_syscalls.h>
+#include "tee_api_private.h"
+
+#define CHACHA_BLOCK_SIZE	64
+#define CHACHA_KEY_SIZE		32
+#define RNG_BUF_SIZE		(8 * CHACHA_BLOCK_SIZE)
+#define RNG_RESEED_INTERVAL	(256 * 1024)
+
+struct rng_state {
+	uint32_t key[CHACHA_KEY_SIZE / sizeof(uint32_t)];
+	uint8_t buf[RNG_BUF_SIZE];
+	size_t avail;		/* Unused bytes at the end of @buf */
+	size_t output;		/* Bytes returned since the last reseed */
+	bool seeded;
+};
+
+static struct rng_state rng;
+
+#define QR(a, b, c, d) do { \
+		a += b; d ^= a; d = (d << 16) | (d >> 16); \
+		c += d; b ^= c; b = (b << 12) | (b >> 20); \
+		a += b; d ^= a; d = (d << 8) | (d >> 24); \
+		c += d; b ^= c; b = (b << 7) | (b >> 25); \
+	} while (0)
+
+static void chacha20_block(const uint32_t key[8], uint32_t counter,
+			   uint32_t out[16])
+{
+	static const uint32_t sigma[4] = {
+		0x61707865, 0x3320646e, 0x79622d32, 0x6b206574,
+	};
+	uint32_t x[16] = { };
+	size_t n = 0;
+
+	memcpy(x, sigma, sizeof(sigma));
+	memcpy(x + 4, key, CHACHA_KEY_SIZE);
+	x[12] = counter;
+
+	for (n = 0; n < 10; n++) {
+		QR(x[0], x[4], x[8], x[12]);
+		QR(x[1], x[5], x[9], x[13]);
+		QR(x[2], x[6], x[10], x[14]);
+		QR(x[3], x[7], x[11], x[15]);
+		QR(x[0], x[5], x[10], x[15]);
+		QR(x[1], x[6], x[11], x[12]);
+		QR(x[2], x[7], x[8], x[13]);
+		QR(x[3], x[4], x[9], x[14]);
+	}
+
+	for (n = 0; n < 4; n++)
+		out[n] = x[n] + sigma[n];
+	for (n = 4; n < 12; n++)
+		out[n] = x[n] + key[n - 4];
+	out[12] = x[12] + counter;
+	for (n = 13; n < 16; n++)
+		out[n] = x[n];
+
+	memzero_explicit(x, sizeof(x));
+}
+
+/* RFC 7539 A.1 test vectors #1 and #2: all-zero key and nonce */
+static void chacha20_self_test(void)
+{
+	static const uint32_t expect[2][16] = {
+		{
+			0xade0b876, 0x903df1a0, 0xe56a5d40, 0x28bd8653,
+			0xb819d2bd, 0x1aed8da0, 0xccef36a8, 0xc70d778b,
+			0x7c5941da, 0x8d485751, 0x3fe02477, 0x374ad8b8,
+			0xf4b8436a, 0x1ca11815, 0x69b687c3, 0x8665eeb2,
+		},
+		{
+			0xbee7079f, 0x7a385155, 0x7c97ba98, 0x0d082d73,
+			0xa0290fcb, 0x6965e348, 0x3e53c612, 0xed7aee32,
+			0x7621b729, 0x434ee69c, 0xb03371d5, 0xd539d874,
+			0x281fed31, 0x45fb0a51, 0x1f0ae1ac, 0x6f4d794b,
+		},
+	};
+	const uint32_t key[CHACHA_KEY_SIZE / sizeof(uint32_t)] = { };
+	uint32_t out[16] = { };
+	uint32_t n = 0;
+
+	for (n = 0; n < ARRAY_SIZE(expect); n++) {
+		chacha20_block(key, n, out);
+		if (memcmp(out, expect[n], sizeof(out)))
+			TEE_Panic(TEE_ERROR_GENERIC);
+	}
+}
+
+static void rng_reseed(void)
+{
+	uint32_t seed[CHACHA_KEY_SIZE / sizeof(uint32_t)] = { };
+	TEE_Result res = TEE_SUCCESS;
+	size_t n = 0;
+
+	if (!rng.seeded)
+		chacha20_self_test();
+
+	res = _utee_cryp_random_number_generate(seed, sizeof(seed));
+	if (res)
+		TEE_Panic(res);
+
+	for (n = 0; n < ARRAY_SIZE(rng.key); n++)
+		rng.key[n] ^= seed[n];
+	memzero_explicit(seed, sizeof(seed));
+
+	/* Bytes derived from the previous key must not be returned */
+	memzero_explicit(rng.buf, sizeof(rng.buf));
+	rng.avail = 0;
+	rng.output = 0;
+	rng.seeded = true;
+}
+
+static void rng_refill(void)
+{
+	uint32_t *blk = (void *)rng.buf;
+	size_t n = 0;
+
+	if (!rng.seeded || rng.output >= RNG_RESEED_INTERVAL)
+		rng_reseed();
+
+	for (n = 0; n < RNG_BUF_SIZE / CHACHA_BLOCK_SIZE; n++)
+		chacha20_block(rng.key, n, blk + n * 16);
+
+	memcpy(rng.key, rng.buf, CHACHA_KEY_SIZE);
+	memzero_explicit(rng.buf, CHACHA_KEY_SIZE);
+	rng.avail = RNG_BUF_SIZE - CHACHA_KEY_SIZE;
+}
+
+void __utee_rng_generate(void *buf, size_t len)
+{
+	uint8_t *dst = buf;
+	size_t l = 0;
+
+	/* Large requests amortize the syscall, take them directly */
+	if (len > RNG_BUF_SIZE - CHACHA_KEY_SIZE) {
+		TEE_Result res = _utee_cryp_random_number_generate(buf, len);
+
+		if (res)
+			TEE_Panic(res);
+		return;
+	}
+
+	while (len) {
+		if (!rng.avail)
+			rng_refill();
+
+		l = MIN(len, rng.avail);
+		memcpy(dst, rng.buf + RNG_BUF_SIZE - rng.avail, l);
+		memzero_explicit(rng.buf + RNG_BUF_SIZE - rng.avail, l);
+		rng.avail -= l;
+		rng.output += l;
+		dst += l;
+		len -= l;
+	}
+}
+
+void __utee_rng_reset(void)
+{
+	memzero_explicit(&rng, sizeof(rng));
+}
@@ -290,6 +290,13 @@ CFG_TA_ASLR ?= y
 CFG_TA_ASLR_MIN_OFFSET_PAGES ?= 0
 CFG_TA_ASLR_MAX_OFFSET_PAGES ?= 128
 
+# Number of user TA binaries whose read-only segments are kept in memory
+# once the last instance using them is gone. A new instance of a cached TA
+# maps these pages instead of allocating and copying them again, the
+# binary is still read and checked against its signature. Cached binaries
+# are released first when TA memory runs out. 0 disables the cache.
+CFG_TA_BIN_CACHE_COUNT ?= 2
+
 # Address Space Layout Randomization for TEE Core
 #
 # When this flag is enabled, the early init code will introduce a random
@@ -310,6 +317,17 @@ CFG_REE_FS_TA ?= y
 CFG_REE_FS_TA_BUFFERED ?= n
 $(eval $(call cfg-depends-all,CFG_REE_FS_TA_BUFFERED,CFG_REE_FS_TA))
 
+# Support for compressed user TAs, as produced by the --compress option of
+# scripts/sign_encrypt.py (see CFG_COMPRESS_TA in ta/arch/arm/link.mk).
+# Such TAs are decompressed while they are loaded from the REE FS or from
+# the secure storage TA database, after decryption and hashing. zlib
+# compressed TAs are the smallest, LZ4 compressed TAs are a few times
+# faster to decompress.
+CFG_TA_COMPRESSION ?= n
+ifeq ($(CFG_TA_COMPRESSION),y)
+$(call force,CFG_ZLIB,y)
+endif
+
 # When CFG_REE_FS=y and CFG_RPMB_FS=y:
 # Allow secure storage in the REE FS to be entirely deleted without causing
 # anti-rollback errors. That is, rm /data/tee/dirf.db or rm -rf /data/tee (or
@@ -377,6 +395,15 @@ CFG_PAGED_USER_TA ?= $(CFG_WITH_PAGER)
 # TAG and IV in order to reduce heap usage.
 CFG_CORE_PAGE_TAG_AND_IV ?= $(CFG_PAGED_USER_TA)
 
+# Map the read-only segments of early TAs on demand with the pager instead
+# of decompressing and copying them into TA memory when the TA is loaded.
+# Each page of an early TA is compressed separately with LZ4 and verified
+# against its SHA-256 hash each time it's loaded, CFG_EARLY_TA_COMPRESS is
+# ignored. The compressed early TA is copied to TA RAM the first time it's
+# mapped and remains there. Building requires the lz4 Python module.
+CFG_EARLY_TA_PAGED ?= n
+$(eval $(call cfg-depends-all,CFG_EARLY_TA_PAGED,CFG_EARLY_TA CFG_PAGED_USER_TA))
+
 # Runtime lock dependency checker: ensures that a proper locking hierarchy is
 # used in the TEE core when acquiring and releasing mutexes. Any violation will
 # cause a panic as soon as the invalid locking condition is detected. If
@@ -590,6 +617,12 @@ CFG_CORE_THREAD_SHIFT ?= 0
 # non-secure memory).
 CFG_CORE_DYN_SHM ?= y
 
+# Amount of virtual address space in bytes that registered dynamic shared
+# memory may keep mapped while not in use. Keeping the mappings saves the
+# map, unmap and TLB invalidation when a buffer is passed again, a value of
+# 0 unmaps buffers as soon as they are not used any longer.
+CFG_CORE_DYN_SHM_IDLE_VA_SIZE ?= 0x800000
+
 # Enable support for reserved shared memory (shared memory in a carved out
 # memory area).
 CFG_CORE_RESERVED_SHM ?= y
@@ -616,6 +649,11 @@ CFG_CORE_BIGNUM_MAX_BITS ?= 4096
 $(call force,CFG_TA_MBEDTLS_MPI,y)
 $(call force,CFG_TA_MBEDTLS,y)
 
+# Serve TEE_GenerateRandom() and rand() in TAs from a ChaCha20 generator
+# in libutee, seeded from the TEE core RNG and reseeded after every 256 KiB
+# of output, instead of a syscall per call.
+CFG_TA_BUFFERED_RNG ?= n
+
 # Compile the TA library mbedTLS with self test functions, the functions
 # need to be called to test anything
 CFG_TA_MBEDTLS_SELF_TEST ?= y
@@ -631,6 +669,17 @@ CFG_TA_MBEDTLS_SELF_TEST ?= y
 CFG_CRYPTOLIB_NAME ?= tomcrypt
 CFG_CRYPTOLIB_DIR ?= core/lib/libtomcrypt
 
+# Keep with each symmetric key object a copy of the last MAC or cipher
+# context initialized with the key. A new operation initialized with the
+# same algorithm and mode copies it, and sets its own IV, instead of
+# computing the key schedule again. The copy is released when the object
+# is closed or its attributes change.
+CFG_CRYPTO_KEY_CACHE ?= y
+
+# Number of freed digest contexts kept by each TA for reuse by its next
+# digest operations. 0 disables the pool.
+CFG_CRYPTO_CTX_POOL_SIZE ?= 4
+
 # Not used since libmpa was removed. Force the value to catch build scripts
 # that would set = n.
 $(call force,CFG_CORE_MBEDTLS_MPI,y)
@@ -802,3 +851,16 @@ CFG_RTC_PTA ?= n
 # When enabled, CFG_DRIVERS_RSTCTRL embeds a reset controller framework in
 # OP-TEE core to provide reset controls on subsystems of the devices.
 CFG_DRIVERS_PINCTRL ?= n
+
+# Enables latency statistics of the fast SMC functions registered with
+# fast_smc_register() and sip_smc_register(), reported by the stats pseudo TA.
+# The latencies are measured in CPU cycles with the cycle counter of the
+# Performance Monitors, on ARM32 this requires CFG_SM_NO_CYCLE_COUNTING=n.
+CFG_FAST_SMC_STATS ?= n
+$(eval $(call cfg-depends-all,CFG_FAST_SMC_STATS,CFG_WITH_STATS))
+
+# Enables the time spent in each phase of loading TAs from REE FS and the
+# time spent inflating compressed early TAs and secure partitions, reported
+# by the stats pseudo TA. The system time is used as time source.
+CFG_TA_LOAD_STATS ?= n
+$(eval $(call cfg-depends-all,CFG_TA_LOAD_STATS,CFG_WITH_STATS))
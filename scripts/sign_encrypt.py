@@ -16,15 +16,49 @@ enc_key_type = {'SHDR_ENC_KEY_DEV_SPECIFIC': 0x0,
 
 SHDR_BOOTSTRAP_TA = 1
 SHDR_ENCRYPTED_TA = 2
+SHDR_COMPRESSED_TA = 3
+SHDR_ENCRYPTED_COMPRESSED_TA = 4
 SHDR_MAGIC = 0x4f545348
 SHDR_SIZE = 20
 
+comp_algo = {'zlib': 0x0,     # SHDR_COMP_ZLIB
+             'lz4': 0x1}      # SHDR_COMP_LZ4
+
+SHDR_LZ4_BLOCK_SIZE = 16 * 1024
+SHDR_LZ4_BLOCK_STORED = 1 << 31
+
 
 def uuid_parse(s):
     from uuid import UUID
     return UUID(s)
 
 
+def compress_lz4(img):
+    import lz4.block
+    import struct
+
+    # Independent blocks, each preceded by its 32-bit size. Blocks which
+    # don't shrink are stored as is.
+    out = bytearray()
+    for offs in range(0, len(img), SHDR_LZ4_BLOCK_SIZE):
+        blk = img[offs:offs + SHDR_LZ4_BLOCK_SIZE]
+        comp = lz4.block.compress(blk, mode='high_compression',
+                                  store_size=False)
+        if len(comp) < len(blk):
+            out += struct.pack('<I', len(comp)) + comp
+        else:
+            out += struct.pack('<I', len(blk) | SHDR_LZ4_BLOCK_STORED) + blk
+    return bytes(out)
+
+
+def compress_img(img, algo_name):
+    import zlib
+
+    if algo_name == 'lz4':
+        return compress_lz4(img)
+    return zlib.compress(img, 9)
+
+
 def int_parse(str):
     return int(str, 0)
 
@@ -51,20 +85,22 @@ def get_args(logger):
         ' TA image file.\n' +
         '                 Takes arguments --uuid, --ta-version, --in, --out,' +
         ' --key,\n' +
-        '                 --enc-key (optional) and' +
-        ' --enc-key-type (optional).\n' +
+        '                 --enc-key (optional), --enc-key-type (optional)' +
+        ' and --compress (optional).\n' +
         '     digest      Generate loadable TA binary image digest' +
         ' for offline\n' +
         '                 signing. Takes arguments --uuid, --ta-version,' +
         ' --in, --key,\n'
         '                 --enc-key (optional), --enc-key-type (optional),' +
-        ' --algo (optional) and --dig.\n' +
+        ' --compress (optional),\n' +
+        '                 --algo (optional) and --dig.\n' +
         '     stitch      Generate loadable signed and encrypted TA binary' +
         ' image file from\n' +
         '                 TA raw image and its signature. Takes' +
         ' arguments --uuid, --in, --key, --out,\n' +
         '                 --enc-key (optional), --enc-key-type (optional),\n' +
-        '                 --algo (optional) and --sig.\n' +
+        '                 --compress (optional), --algo (optional) and' +
+        ' --sig.\n' +
         '     verify      Verify signed TA binary\n' +
         '                 Takes arguments --uuid, --in, --key\n\n' +
         '   %(prog)s --help  show available commands and arguments\n\n',
@@ -109,6 +145,10 @@ def get_args(logger):
         help='Encryption key type.\n' +
         '(SHDR_ENC_KEY_DEV_SPECIFIC or SHDR_ENC_KEY_CLASS_WIDE).\n' +
         'Defaults to SHDR_ENC_KEY_DEV_SPECIFIC.')
+    parser.add_argument(
+        '--compress', required=False, choices=list(comp_algo.keys()),
+        help='Compress the TA before it is encrypted, zlib or lz4.\n' +
+        'The TEE core must be built with CFG_TA_COMPRESSION=y.')
     parser.add_argument(
         '--ta-version', required=False, type=int_parse, default=0,
         help='TA version stored as a 32-bit unsigned integer and used for\n' +
@@ -210,13 +250,22 @@ def main():
     digest_len = chosen_hash.digest_size
     sig_len = math.ceil(key.key_size / 8)
 
+    if args.compress and args.command != 'verify':
+        # struct shdr_compressed_ta
+        chdr = struct.pack('<II', comp_algo[args.compress], len(img))
+        img = compress_img(img, args.compress)
+
     img_size = len(img)
 
     hdr_version = args.ta_version  # struct shdr_bootstrap_ta::ta_version
 
     magic = SHDR_MAGIC
-    if args.enc_key:
+    if args.enc_key and args.compress:
+        img_type = SHDR_ENCRYPTED_COMPRESSED_TA
+    elif args.enc_key:
         img_type = SHDR_ENCRYPTED_TA
+    elif args.compress:
+        img_type = SHDR_COMPRESSED_TA
     else:
         img_type = SHDR_BOOTSTRAP_TA
 
@@ -248,6 +297,8 @@ def main():
         h.update(ehdr)
         h.update(nonce)
         h.update(tag)
+    if args.compress:
+        h.update(chdr)
     h.update(img)
     img_digest = h.finalize()
 
@@ -262,6 +313,9 @@ def main():
                 f.write(ehdr)
                 f.write(nonce)
                 f.write(tag)
+            if args.compress:
+                f.write(chdr)
+            if args.enc_key:
                 f.write(ciphertext)
             else:
                 f.write(img)
@@ -361,7 +415,7 @@ def main():
         if magic != SHDR_MAGIC:
             raise Exception("Unexpected magic: 0x{:08x}".format(magic))
 
-        if img_type != SHDR_BOOTSTRAP_TA:
+        if img_type not in (SHDR_BOOTSTRAP_TA, SHDR_COMPRESSED_TA):
             raise Exception("Unsupported image type: {}".format(img_type))
 
         if algo_value not in algo.values():
@@ -395,6 +449,11 @@ def main():
         # sizeof(struct shdr_bootstrap_ta)
         h.update(img[start:end])
 
+        # sizeof(struct shdr_compressed_ta)
+        if img_type == SHDR_COMPRESSED_TA:
+            start, end = end, end + 8
+            h.update(img[start:end])
+
         # raw image
         start = end
         end += img_size
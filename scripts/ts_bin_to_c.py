@@ -8,6 +8,7 @@
 import argparse
 import array
 from elftools.elf.elffile import ELFFile
+import hashlib
 import os
 import re
 import struct
@@ -43,6 +44,14 @@ def get_args():
         help='Compress the image using the DEFLATE '
         'algorithm')
 
+    parser.add_argument(
+        '--paged',
+        dest="paged",
+        action="store_true",
+        help='Compress the image one page at a time using the LZ4 '
+        'algorithm and add the hash of each page, allowing the TEE core '
+        'to load the pages on demand')
+
     return parser.parse_args()
 
 
@@ -77,6 +86,45 @@ def sp_get_flags(sp_f):
         raise Exception('.sp_head section not found')
 
 
+PAGE_SIZE = 4096
+
+
+def compress_pages(img):
+    import lz4.block
+
+    # Each page is an independent LZ4 block, pages which don't shrink are
+    # stored as is. The last page is padded with zeroes.
+    data = bytearray()
+    offs = [0]
+    hashes = bytearray()
+    for i in range(0, len(img), PAGE_SIZE):
+        page = img[i:i + PAGE_SIZE].ljust(PAGE_SIZE, b'\0')
+        hashes += hashlib.sha256(page).digest()
+        comp = lz4.block.compress(page, mode='high_compression',
+                                  store_size=False)
+        if len(comp) < PAGE_SIZE:
+            data += comp
+        else:
+            data += page
+        offs.append(len(data))
+    return bytes(data), offs, bytes(hashes)
+
+
+def write_array(f, ctype, name, values, per_line):
+    f.write('const ' + ctype + ' ' + name + '[] = {\n')
+    i = 0
+    while i < len(values):
+        if i % per_line == 0:
+            f.write('\t\t')
+        f.write(hex(values[i]) + ',')
+        i = i + 1
+        if i % per_line == 0 or i == len(values):
+            f.write('\n')
+        else:
+            f.write(' ')
+    f.write('};\n')
+
+
 def main():
     args = get_args()
     is_sp = False
@@ -87,6 +135,9 @@ def main():
     if args.ta is not None and args.sp is not None:
         raise Exception('The --ta and the --sp can\'t be combined')
 
+    if args.compress and args.paged:
+        raise Exception('The --compress and the --paged can\'t be combined')
+
     if args.ta is not None:
         ts = args.ta
         is_sp = False
@@ -102,6 +153,8 @@ def main():
         uncompressed_size = len(bytes)
         if args.compress:
             bytes = zlib.compress(bytes)
+        if args.paged:
+            bytes, page_offs, page_hashes = compress_pages(bytes)
         size = len(bytes)
 
     f = open(args.out, 'w')
@@ -109,18 +162,12 @@ def main():
             os.path.basename(__file__) + ' */\n\n')
     f.write('#include <kernel/embedded_ts.h>\n\n')
     f.write('#include <scattered_array.h>\n\n')
-    f.write('const uint8_t ts_bin_' + ts_uuid.hex + '[] = {\n')
-    i = 0
-    while i < size:
-        if i % 8 == 0:
-            f.write('\t\t')
-        f.write(hex(bytes[i]) + ',')
-        i = i + 1
-        if i % 8 == 0 or i == size:
-            f.write('\n')
-        else:
-            f.write(' ')
-    f.write('};\n')
+    write_array(f, 'uint8_t', 'ts_bin_' + ts_uuid.hex, bytes, 8)
+    if args.paged:
+        write_array(f, 'uint32_t', 'ts_page_offs_' + ts_uuid.hex,
+                    page_offs, 4)
+        write_array(f, 'uint8_t', 'ts_page_hashes_' + ts_uuid.hex,
+                    page_hashes, 8)
 
     if is_sp:
         f.write('SCATTERED_ARRAY_DEFINE_PG_ITEM(sp_images, struct \
@@ -144,9 +191,12 @@ def main():
     f.write('\t.size = sizeof(ts_bin_' + ts_uuid.hex +
             '), /* {:d} */\n'.format(size))
     f.write('\t.ts = ts_bin_' + ts_uuid.hex + ',\n')
-    if args.compress:
+    if args.compress or args.paged:
         f.write('\t.uncompressed_size = '
                 '{:d},\n'.format(uncompressed_size))
+    if args.paged:
+        f.write('\t.page_offs = ts_page_offs_' + ts_uuid.hex + ',\n')
+        f.write('\t.page_hashes = ts_page_hashes_' + ts_uuid.hex + ',\n')
     f.write('};\n')
     f.close()
 
@@ -35,6 +35,7 @@ ifeq ($(sm)-$(CFG_TA_BTI),ta_arm64-y)
 link-ldflags += $(call ld-option,-z force-bti) --fatal-warnings
 endif
 link-ldflags += --as-needed # Do not add dependency on unused shlib
+link-ldflags += --hash-style=both # DT_HASH for older loaders
 link-ldflags += $(link-ldflags$(sm))
 
 $(link-out-dir$(sm))/dyn_list:
@@ -106,6 +107,11 @@ ifeq ($(CFG_ENCRYPT_TA),y)
 crypt-args$(user-ta-uuid) := --enc-key $(TA_ENC_KEY)
 cmd-echo$(user-ta-uuid) := SIGNENC
 endif
+# CFG_COMPRESS_TA=zlib or lz4 compresses the TA, the TEE core must be
+# built with CFG_TA_COMPRESSION=y to load it
+ifneq ($(filter zlib lz4,$(CFG_COMPRESS_TA)),)
+crypt-args$(user-ta-uuid) += --compress $(CFG_COMPRESS_TA)
+endif
 $(link-out-dir$(sm))/$(user-ta-uuid).ta: \
 			$(link-out-dir$(sm))/$(user-ta-uuid).stripped.elf \
 			$(TA_SIGN_KEY) \